@@ -0,0 +1,627 @@
+#include "assets/asset_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include "rlgl.h"
+#include "assets/gltf_materials.h"
+#include "assets/texture_cache.h"
+#include "core/alloc_tracker.h"
+#include "core/mapped_file.h"
+#include "core/profiler.h"
+
+// raylib 5.0's MAX_MATERIAL_MAPS
+static const int kMaterialMaps = 12;
+
+// CPU-side result of a background load, waiting for GPU upload on the main thread.
+struct AssetManager::Pending {
+    AssetKind kind = AssetKind::Model;
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+    std::string path;
+    TextureQuality quality = TextureQuality::High;
+    // Model
+    MappedFile cacheFile;       // kept mapped until the streams are uploaded
+    BakedModel baked;
+    bool cacheValid = false;
+    std::vector<GltfMaterial> materials;
+    // Texture
+    MappedFile textureFile;     // backs image.data when the texture came from .ebtex
+    Image image{};
+    bool missing = false;
+    double cpuSeconds = 0.0;
+};
+
+static int toPixelFormat(TextureCacheFormat format) {
+    return format == TextureCacheFormat::BC3 ? PIXELFORMAT_COMPRESSED_DXT5_RGBA : PIXELFORMAT_COMPRESSED_DXT1_RGB;
+}
+
+static void releaseImage(MappedFile &file, Image &image) {
+    if (file.isOpen()) file.close();
+    else if (image.data) UnloadImage(image);
+    image = Image{};
+}
+
+// raylib's 1x1 white; owned by rlgl, never unloaded here
+static Texture2D defaultTexture() {
+    return {rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+}
+
+static Color colorFromFactor(const float factor[4]) {
+    unsigned char c[4];
+    for (int k = 0; k < 4; ++k) c[k] = (unsigned char)(std::min(std::max(factor[k], 0.0f), 1.0f) * 255.0f + 0.5f);
+    return {c[0], c[1], c[2], c[3]};
+}
+
+static size_t textureBytes(const Texture2D &texture) {
+    if (texture.id == rlGetTextureIdDefault()) return 0;
+    size_t bytes = 0;
+    for (int m = 0, w = texture.width, h = texture.height; m < texture.mipmaps; ++m, w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+        bytes += (size_t)GetPixelDataSize(w, h, texture.format);
+    }
+    return bytes;
+}
+
+static size_t indexBytes(const Mesh &mesh) {
+    return mesh.indices ? sizeof(unsigned short) * 3 * (size_t)mesh.triangleCount : 0;
+}
+
+// Arrays raylib keeps in RAM after upload; for baked models only the index copies
+static size_t meshCpuBytes(const Mesh &mesh) {
+    const size_t n = (size_t)mesh.vertexCount;
+    size_t bytes = indexBytes(mesh);
+    if (mesh.vertices) bytes += n * 12;
+    if (mesh.texcoords) bytes += n * 8;
+    if (mesh.texcoords2) bytes += n * 8;
+    if (mesh.normals) bytes += n * 12;
+    if (mesh.tangents) bytes += n * 16;
+    if (mesh.colors) bytes += n * 4;
+    if (mesh.animVertices) bytes += n * 12;
+    if (mesh.animNormals) bytes += n * 12;
+    if (mesh.boneIds) bytes += n * 4;
+    if (mesh.boneWeights) bytes += n * 16;
+    return bytes;
+}
+
+// What UploadMesh put on the GPU for a glTF-loaded mesh
+static size_t meshGpuBytes(const Mesh &mesh) {
+    const size_t n = (size_t)mesh.vertexCount;
+    size_t bytes = indexBytes(mesh);
+    if (mesh.vertices) bytes += n * 12;
+    if (mesh.texcoords) bytes += n * 8;
+    if (mesh.texcoords2) bytes += n * 8;
+    if (mesh.normals) bytes += n * 12;
+    if (mesh.tangents) bytes += n * 16;
+    if (mesh.colors) bytes += n * 4;
+    return bytes;
+}
+
+// Vertex streams modelFromBaked uploaded, in the layout it chose
+static size_t bakedVertexBytes(const BakedMesh &mesh, bool quantized) {
+    size_t perVertex = quantized ? 8 : 12;
+    if (mesh.texcoords) perVertex += quantized ? 4 : 8;
+    if (mesh.normals) perVertex += quantized ? 4 : 12;
+    if (mesh.colors) perVertex += 4;
+    return perVertex * (size_t)mesh.vertexCount;
+}
+
+AssetManager::AssetManager(JobSystem &jobs, bool quantizedVertices, const AssetBudget &budget)
+    : quantizedVertices_(quantizedVertices), budget_(budget), jobSystem_(jobs) {}
+
+AssetManager::~AssetManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        jobs_.clear();
+    }
+    // Loads already running finish; the rest find the queue empty and return
+    jobSystem_.wait(loads_);
+    for (auto &p : ready_) releaseImage(p->textureFile, p->image);
+}
+
+void AssetManager::queueJob(const Job &job, bool urgent) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = jobs_.begin(); it != jobs_.end(); ++it) {
+            if (it->kind != job.kind || it->slot != job.slot) continue;
+            // Already queued: bump it to the front if it has not started yet
+            if (urgent) {
+                Job queued = *it;
+                jobs_.erase(it);
+                jobs_.push_front(queued);
+            }
+            return;
+        }
+        if (urgent) jobs_.push_front(job); else jobs_.push_back(job);
+    }
+    jobSystem_.runBackground(&AssetManager::loadNext, this, &loads_);
+}
+
+ModelHandle AssetManager::acquireModel(const std::string &gltfPath, bool urgent) {
+    auto found = modelSlots_.find(gltfPath);
+    uint32_t slot;
+    if (found == modelSlots_.end()) {
+        slot = (uint32_t)models_.size();
+        models_.emplace_back();
+        models_.back().path = gltfPath;
+        modelSlots_.emplace(gltfPath, slot);
+    } else {
+        slot = found->second;
+    }
+    ModelEntry &entry = models_[slot];
+    entry.refs++;
+    entry.urgent = entry.urgent || urgent;
+    if (entry.state == State::Unloaded) {
+        entry.state = State::Loading;
+        queueJob({AssetKind::Model, slot, entry.generation, gltfPath}, urgent);
+    } else if (entry.state == State::Loading && urgent) {
+        queueJob({AssetKind::Model, slot, entry.generation, gltfPath}, true);
+    }
+    return {slot, entry.generation};
+}
+
+void AssetManager::prefetchModel(const std::string &gltfPath) {
+    ModelHandle handle = acquireModel(gltfPath);
+    ModelEntry &entry = models_[handle.slot];
+    entry.refs--;
+    entry.lastUsed = frame_;
+}
+
+TextureHandle AssetManager::acquireTexture(const std::string &path, bool urgent) {
+    auto found = textureSlots_.find(path);
+    uint32_t slot;
+    if (found == textureSlots_.end()) {
+        slot = (uint32_t)textures_.size();
+        textures_.emplace_back();
+        textures_.back().path = path;
+        textureSlots_.emplace(path, slot);
+    } else {
+        slot = found->second;
+    }
+    TextureEntry &entry = textures_[slot];
+    entry.refs++;
+    if (entry.state == State::Unloaded) {
+        entry.state = State::Loading;
+        queueJob({AssetKind::Texture, slot, entry.generation, path}, urgent);
+    } else if (entry.state == State::Loading && urgent) {
+        queueJob({AssetKind::Texture, slot, entry.generation, path}, true);
+    }
+    return {slot, entry.generation};
+}
+
+MaterialHandle AssetManager::acquireMaterial(const std::string &key, const GltfMaterial &source, bool urgent) {
+    auto found = materialSlots_.find(key);
+    uint32_t slot;
+    if (found == materialSlots_.end()) {
+        slot = (uint32_t)materials_.size();
+        materials_.emplace_back();
+        materials_.back().key = key;
+        materialSlots_.emplace(key, slot);
+    } else {
+        slot = found->second;
+    }
+    MaterialEntry &entry = materials_[slot];
+    if (entry.refs++ == 0) {
+        entry.asset.baseColor = colorFromFactor(source.baseColorFactor);
+        if (!source.baseColorPath.empty()) entry.asset.baseColorTexture = acquireTexture(source.baseColorPath, urgent);
+        entry.resident = true;
+    }
+    return {slot, entry.generation};
+}
+
+void AssetManager::release(ModelHandle handle) {
+    if (handle.slot >= models_.size()) return;
+    ModelEntry &entry = models_[handle.slot];
+    if (entry.generation != handle.generation || entry.refs <= 0) return;
+    entry.refs--;
+    entry.lastUsed = frame_;
+    if (entry.refs == 0) entry.urgent = false;
+}
+
+// Materials are a few bytes each, so they go as soon as nothing uses them
+void AssetManager::release(MaterialHandle handle) {
+    if (handle.slot >= materials_.size()) return;
+    MaterialEntry &entry = materials_[handle.slot];
+    if (entry.generation != handle.generation || entry.refs <= 0) return;
+    if (--entry.refs > 0) return;
+    release(entry.asset.baseColorTexture);
+    entry.asset = MaterialAsset{};
+    entry.resident = false;
+    entry.generation++;
+}
+
+void AssetManager::release(TextureHandle handle) {
+    if (handle.slot >= textures_.size()) return;
+    TextureEntry &entry = textures_[handle.slot];
+    if (entry.generation != handle.generation || entry.refs <= 0) return;
+    entry.refs--;
+    entry.lastUsed = std::max(entry.lastUsed, frame_);
+}
+
+const ModelAsset *AssetManager::model(ModelHandle handle) {
+    if (handle.slot >= models_.size()) return nullptr;
+    ModelEntry &entry = models_[handle.slot];
+    if (entry.generation != handle.generation || entry.state != State::Resident || !entry.ready) return nullptr;
+    entry.lastUsed = frame_;
+    return &entry.asset;
+}
+
+const MaterialAsset *AssetManager::material(MaterialHandle handle) const {
+    if (handle.slot >= materials_.size()) return nullptr;
+    const MaterialEntry &entry = materials_[handle.slot];
+    return entry.generation == handle.generation && entry.resident ? &entry.asset : nullptr;
+}
+
+const TextureAsset *AssetManager::texture(TextureHandle handle) const {
+    if (handle.slot >= textures_.size()) return nullptr;
+    const TextureEntry &entry = textures_[handle.slot];
+    return entry.generation == handle.generation && entry.state == State::Resident ? &entry.asset : nullptr;
+}
+
+void AssetManager::setTextureQuality(TextureQuality quality) {
+    if (quality == quality_) return;
+    quality_ = quality;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workerQuality_ = quality;
+    }
+    // Textures still queued pick up the new tier when they load; resident ones reload
+    for (uint32_t slot = 0; slot < textures_.size(); ++slot) {
+        TextureEntry &entry = textures_[slot];
+        if (entry.state != State::Resident || entry.asset.missing) continue;
+        entry.reloading = true;
+        queueJob({AssetKind::Texture, slot, entry.generation, entry.path}, false);
+    }
+}
+
+size_t AssetManager::residentCpuBytes() const {
+    size_t bytes = 0;
+    for (const auto &m : models_) {
+        if (m.state == State::Resident) bytes += m.cpuBytes;
+    }
+    return bytes;
+}
+
+size_t AssetManager::residentGpuBytes() const {
+    size_t bytes = residentTextureBytes();
+    for (const auto &m : models_) {
+        if (m.state == State::Resident) bytes += m.gpuBytes;
+    }
+    return bytes;
+}
+
+size_t AssetManager::residentTextureBytes() const {
+    size_t bytes = 0;
+    for (const auto &t : textures_) {
+        if (t.state == State::Resident) bytes += t.gpuBytes;
+    }
+    return bytes;
+}
+
+void AssetManager::loadModel(Pending &pending) const {
+    if (pending.cacheFile.open(bakedModelPath(pending.path).c_str())) {
+        pending.cacheValid = parseBakedModel(pending.cacheFile.data(), pending.cacheFile.size(), pending.baked) &&
+                             pending.baked.sourceStamp == modelSourceStamp(pending.path);
+        if (!pending.cacheValid) pending.cacheFile.close();
+    }
+    if (!readGltfMaterials(pending.path, pending.materials)) {
+        TraceLog(LOG_WARNING, "MODEL: Could not read materials of %s, drawing untextured", pending.path.c_str());
+    }
+}
+
+// Prefers the baked .ebtex, handing the GPU the mip chain from the requested tier down
+// straight out of the mapping. Without a valid cache the PNG is decoded and downscaled.
+void AssetManager::loadTexture(Pending &pending) const {
+    const std::string &pngPath = pending.path;
+    const int tier = (int)pending.quality;
+    BakedTexture baked;
+    if (pending.textureFile.open(bakedTexturePath(pngPath).c_str())) {
+        if (parseBakedTexture(pending.textureFile.data(), pending.textureFile.size(), baked) &&
+            baked.sourceStamp == textureSourceStamp(pngPath)) {
+            int first = std::min(tier, (int)baked.mips.size() - 1);
+            const BakedMip &mip = baked.mips[first];
+            pending.image.data = (void *)mip.data;
+            pending.image.width = mip.width;
+            pending.image.height = mip.height;
+            pending.image.mipmaps = (int)baked.mips.size() - first;
+            pending.image.format = toPixelFormat(baked.format);
+            return;
+        }
+        pending.textureFile.close();
+    }
+    if (!FileExists(pngPath.c_str())) {
+        pending.missing = true;
+        return;
+    }
+    pending.image = LoadImage(pngPath.c_str());
+    if (pending.image.data && tier > 0) {
+        ImageResize(&pending.image, std::max(1, pending.image.width >> tier), std::max(1, pending.image.height >> tier));
+    }
+}
+
+void AssetManager::loadNext(void *context, int, int) {
+    AssetManager &self = *static_cast<AssetManager *>(context);
+    Job job;
+    TextureQuality quality;
+    {
+        std::lock_guard<std::mutex> lock(self.mutex_);
+        // Cancelled by unloadAll or shutdown, or taken by an earlier job
+        if (self.stopping_ || self.jobs_.empty()) return;
+        job = self.jobs_.front();
+        self.jobs_.pop_front();
+        quality = self.workerQuality_;
+        self.inFlight_++;
+    }
+
+    PROFILE_ZONE("asset load");
+    AllocScope scope(AllocTag::Assets);
+    auto pending = std::make_unique<Pending>();
+    pending->kind = job.kind;
+    pending->slot = job.slot;
+    pending->generation = job.generation;
+    pending->path = job.path;
+    pending->quality = quality;
+    auto start = std::chrono::steady_clock::now();
+    if (job.kind == AssetKind::Model) self.loadModel(*pending);
+    else self.loadTexture(*pending);
+    pending->cpuSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(self.mutex_);
+    self.inFlight_--;
+    self.ready_.push_back(std::move(pending));
+}
+
+void AssetManager::uploadTexture(Pending &pending) {
+    TextureEntry &entry = textures_[pending.slot];
+    // Evicted, or dropped by unloadAll, since the job was queued
+    if (entry.generation != pending.generation || entry.state == State::Unloaded) {
+        releaseImage(pending.textureFile, pending.image);
+        return;
+    }
+
+    Texture2D texture{};
+    if (pending.image.data) {
+        texture = LoadTextureFromImage(pending.image);
+        if (texture.id == 0 && pending.textureFile.isOpen()) {
+            // Driver without S3TC support: fall back to the source PNG
+            TraceLog(LOG_WARNING, "TEXTURE: Compressed texture rejected for %s, loading PNG", pending.path.c_str());
+            pending.textureFile.close();
+            pending.image = LoadImage(pending.path.c_str());
+            if (pending.image.data) texture = LoadTextureFromImage(pending.image);
+        }
+        if (texture.mipmaps > 1) SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR);
+    }
+    releaseImage(pending.textureFile, pending.image);
+    if (texture.id == 0) {
+        TraceLog(LOG_WARNING, "TEXTURE: %s %s, using white", pending.path.c_str(), pending.missing ? "not found" : "failed to load");
+        texture = defaultTexture();
+    }
+
+    if (entry.state == State::Resident) unloadTexture(entry);     // the previous tier
+    entry.asset.texture = texture;
+    entry.asset.missing = texture.id == rlGetTextureIdDefault();
+    entry.gpuBytes = textureBytes(texture);
+    entry.state = State::Resident;
+    entry.reloading = false;
+    entry.lastUsed = std::max(entry.lastUsed, frame_);
+    materialsDirty_ = true;
+    TraceLog(LOG_INFO, "TEXTURE: %s %dx%d, %d mips, %.1f KB resident", pending.path.c_str(), texture.width, texture.height,
+             texture.mipmaps, entry.gpuBytes / 1024.0);
+}
+
+void AssetManager::uploadModel(Pending &pending) {
+    ModelEntry &entry = models_[pending.slot];
+    if (entry.generation != pending.generation || entry.state != State::Loading) return;
+
+    double uploadStart = GetTime();
+    ModelAsset &asset = entry.asset;
+    asset = ModelAsset{};
+    entry.cpuBytes = 0;
+    entry.gpuBytes = 0;
+    if (pending.cacheValid) {
+        const BakedModel &baked = pending.baked;
+        asset.model = modelFromBaked(baked, quantizedVertices_, asset.dequantization);
+        asset.lodCount = 1 + lodModelsFromBaked(baked, asset.model, quantizedVertices_, asset.lods);
+        asset.bounds = {{baked.boundsMin[0], baked.boundsMin[1], baked.boundsMin[2]},
+                        {baked.boundsMax[0], baked.boundsMax[1], baked.boundsMax[2]}};
+        for (int i = 0; i < asset.model.meshCount; ++i) {
+            entry.cpuBytes += meshCpuBytes(asset.model.meshes[i]);
+            entry.gpuBytes += bakedVertexBytes(baked.meshes[i], quantizedVertices_) + indexBytes(asset.model.meshes[i]);
+        }
+        pending.cacheFile.close();
+    } else {
+        if (FileExists(bakedModelPath(pending.path).c_str())) {
+            TraceLog(LOG_WARNING, "MODEL: Cache for %s is stale or invalid, loading glTF", pending.path.c_str());
+        }
+        asset.model = LoadModel(pending.path.c_str());
+        asset.bounds = GetModelBoundingBox(asset.model);
+        for (int i = 0; i < asset.model.meshCount; ++i) {
+            entry.cpuBytes += meshCpuBytes(asset.model.meshes[i]);
+            entry.gpuBytes += meshGpuBytes(asset.model.meshes[i]);
+        }
+        // raylib's glTF loader uploads the images it finds and UnloadModel never frees them;
+        // textures come from the manager instead
+        for (int m = 0; m < asset.model.materialCount; ++m) {
+            MaterialMap *maps = asset.model.materials[m].maps;
+            for (int k = 0; maps && k < kMaterialMaps; ++k) {
+                if (maps[k].texture.id != 0 && maps[k].texture.id != rlGetTextureIdDefault()) UnloadTexture(maps[k].texture);
+                maps[k].texture = defaultTexture();
+            }
+        }
+    }
+    for (int l = 0; l < asset.lodCount - 1; ++l) {
+        for (int i = 0; i < asset.lods[l].meshCount; ++i) {
+            entry.cpuBytes += indexBytes(asset.lods[l].meshes[i]);
+            entry.gpuBytes += indexBytes(asset.lods[l].meshes[i]);
+        }
+    }
+
+    for (size_t i = 0; i < pending.materials.size(); ++i) {
+        asset.materials.push_back(acquireMaterial(pending.path + "#" + std::to_string(i), pending.materials[i], entry.urgent));
+    }
+    entry.state = State::Resident;
+    entry.ready = false;
+    entry.lastUsed = std::max(entry.lastUsed, frame_);
+    materialsDirty_ = true;
+    TraceLog(LOG_INFO, "MODEL: %s loaded from %s, %d LODs, %zu materials, %.1f KB CPU / %.1f KB GPU (worker %.1f ms, main-thread upload %.1f ms)",
+             pending.path.c_str(), pending.cacheValid ? "cache" : "glTF", asset.lodCount, asset.materials.size(), entry.cpuBytes / 1024.0,
+             entry.gpuBytes / 1024.0, pending.cpuSeconds * 1000.0, (GetTime() - uploadStart) * 1000.0);
+}
+
+// Points each glTF material's raylib material at its current texture and color. LODs share
+// the materials array, so they follow. False while a texture is still loading.
+bool AssetManager::bindMaterials(ModelEntry &entry) {
+    Model &model = entry.asset.model;
+    bool settled = true;
+    for (size_t i = 0; i < entry.asset.materials.size(); ++i) {
+        const MaterialAsset *mat = material(entry.asset.materials[i]);
+        if (!mat || (int)i + 1 >= model.materialCount) continue;
+        const TextureAsset *tex = texture(mat->baseColorTexture);
+        if (mat->baseColorTexture.valid() && !tex) settled = false;
+        MaterialMap &albedo = model.materials[i + 1].maps[MATERIAL_MAP_ALBEDO];
+        albedo.texture = tex ? tex->texture : defaultTexture();
+        albedo.color = mat->baseColor;
+    }
+    return settled;
+}
+
+void AssetManager::pumpUploads(double budgetSeconds) {
+    AllocScope scope(AllocTag::Assets);
+    frame_++;
+    double start = GetTime();
+    for (;;) {
+        std::unique_ptr<Pending> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ready_.empty()) break;
+            pending = std::move(ready_.front());
+            ready_.pop_front();
+        }
+
+        PROFILE_ZONE("asset upload");
+        if (pending->kind == AssetKind::Model) uploadModel(*pending);
+        else uploadTexture(*pending);
+        if (GetTime() - start >= budgetSeconds) break;
+    }
+
+    if (materialsDirty_) {
+        materialsDirty_ = false;
+        for (auto &entry : models_) {
+            if (entry.state == State::Resident) entry.ready = bindMaterials(entry);
+        }
+    }
+    evictToBudget();
+}
+
+void AssetManager::unloadModel(ModelEntry &entry) {
+    ModelAsset &asset = entry.asset;
+    for (int l = 0; l < asset.lodCount - 1; ++l) unloadLodModel(asset.lods[l]);
+    UnloadModel(asset.model);
+    for (MaterialHandle handle : asset.materials) {
+        // Textures it let go of rank as recently used as the model itself
+        const MaterialAsset *mat = material(handle);
+        if (mat && mat->baseColorTexture.valid()) {
+            TextureEntry &tex = textures_[mat->baseColorTexture.slot];
+            tex.lastUsed = std::max(tex.lastUsed, entry.lastUsed);
+        }
+        release(handle);
+    }
+    asset = ModelAsset{};
+    entry.state = State::Unloaded;
+    entry.ready = false;
+    entry.cpuBytes = 0;
+    entry.gpuBytes = 0;
+    entry.generation++;
+}
+
+void AssetManager::unloadTexture(TextureEntry &entry) {
+    if (entry.asset.texture.id != 0 && entry.asset.texture.id != rlGetTextureIdDefault()) UnloadTexture(entry.asset.texture);
+    entry.asset = TextureAsset{};
+    entry.gpuBytes = 0;
+    entry.state = State::Unloaded;
+}
+
+// Least recently used unreferenced asset first, among those that free what is over budget
+void AssetManager::evictToBudget() {
+    for (;;) {
+        const bool cpuOver = residentCpuBytes() > budget_.cpuBytes;
+        const bool gpuOver = residentGpuBytes() > budget_.gpuBytes;
+        if (!cpuOver && !gpuOver) {
+            overBudgetWarned_ = false;
+            return;
+        }
+        ModelEntry *model = nullptr;
+        TextureEntry *texture = nullptr;
+        uint64_t oldest = UINT64_MAX;
+        for (auto &m : models_) {
+            if (m.state != State::Resident || m.refs > 0 || m.lastUsed >= oldest) continue;
+            // Under GPU pressure any model helps: evicting it lets go of its textures
+            if ((cpuOver && m.cpuBytes > 0) || gpuOver) {
+                model = &m;
+                oldest = m.lastUsed;
+            }
+        }
+        for (auto &t : textures_) {
+            if (t.state != State::Resident || t.refs > 0 || t.lastUsed >= oldest || !gpuOver) continue;
+            model = nullptr;
+            texture = &t;
+            oldest = t.lastUsed;
+        }
+        if (model) {
+            TraceLog(LOG_INFO, "ASSET: Evicting model %s (%.1f KB CPU / %.1f KB GPU)", model->path.c_str(), model->cpuBytes / 1024.0,
+                     model->gpuBytes / 1024.0);
+            unloadModel(*model);
+        } else if (texture) {
+            TraceLog(LOG_INFO, "ASSET: Evicting texture %s (%.1f KB)", texture->path.c_str(), texture->gpuBytes / 1024.0);
+            unloadTexture(*texture);
+            texture->generation++;
+        } else {
+            if (!overBudgetWarned_) {
+                TraceLog(LOG_WARNING, "ASSET: Over budget (%.1f/%.1f MB CPU, %.1f/%.1f MB GPU) with everything in use",
+                         residentCpuBytes() / (1024.0 * 1024.0), budget_.cpuBytes / (1024.0 * 1024.0),
+                         residentGpuBytes() / (1024.0 * 1024.0), budget_.gpuBytes / (1024.0 * 1024.0));
+                overBudgetWarned_ = true;
+            }
+            return;
+        }
+    }
+}
+
+bool AssetManager::busy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !jobs_.empty() || !ready_.empty() || inFlight_ > 0;
+}
+
+std::vector<AssetInfo> AssetManager::assets() const {
+    std::vector<AssetInfo> rows;
+    for (const auto &m : models_) {
+        rows.push_back({AssetKind::Model, m.path, m.refs, m.state == State::Resident, m.state == State::Loading, m.cpuBytes,
+                        m.gpuBytes, m.lastUsed});
+    }
+    for (const auto &m : materials_) {
+        if (m.resident) rows.push_back({AssetKind::Material, m.key, m.refs, true, false, 0, 0, 0});
+    }
+    for (const auto &t : textures_) {
+        rows.push_back({AssetKind::Texture, t.path, t.refs, t.state == State::Resident, t.state == State::Loading || t.reloading, 0,
+                        t.gpuBytes, t.lastUsed});
+    }
+    return rows;
+}
+
+void AssetManager::unloadAll() {
+    for (auto &m : models_) {
+        if (m.state == State::Resident) unloadModel(m);
+        else if (m.state == State::Loading) m.generation++;
+        m.state = State::Unloaded;
+        m.refs = 0;
+        m.urgent = false;
+    }
+    for (auto &t : textures_) {
+        if (t.state == State::Resident) unloadTexture(t);
+        t.state = State::Unloaded;
+        t.reloading = false;
+        t.refs = 0;
+        t.generation++;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.clear();
+}
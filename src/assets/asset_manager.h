@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "raylib.h"
+#include "assets/model_cache.h"
+#include "assets/model_loader.h"
+#include "core/job_system.h"
+#include "core/types.h"
+
+struct GltfMaterial;
+
+// Slot plus generation; a handle whose asset has since been evicted reads as null.
+template <typename Tag>
+struct AssetHandle {
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    uint32_t slot = kNone;
+    uint32_t generation = 0;
+
+    bool valid() const { return slot != kNone; }
+};
+
+struct ModelTag;
+struct MaterialTag;
+struct TextureTag;
+using ModelHandle = AssetHandle<ModelTag>;
+using MaterialHandle = AssetHandle<MaterialTag>;
+using TextureHandle = AssetHandle<TextureTag>;
+
+struct ModelAsset {
+    Model model{};
+    Model lods[kMaxModelLods - 1] = {};     // simplified levels sharing model's buffers (baked cache only)
+    int lodCount = 1;                       // levels including model itself
+    BoundingBox bounds{};                   // model space, model.transform applied
+    std::vector<MeshDequantization> dequantization;     // per mesh when uploaded quantized, else empty
+    // model.materials[i + 1] follows materials[i]; raylib's default material 0 has none
+    std::vector<MaterialHandle> materials;
+
+    // LOD 0 is the full-detail model; levels past the last one clamp to it
+    const Model &lod(int level) const {
+        level = level < lodCount ? level : lodCount - 1;
+        return level <= 0 ? model : lods[level - 1];
+    }
+    // For drawModelInstanced: null for float models
+    const MeshDequantization *dequantizationData() const { return dequantization.empty() ? nullptr : dequantization.data(); }
+};
+
+// A glTF material: its base color and the texture it samples
+struct MaterialAsset {
+    Color baseColor = WHITE;
+    TextureHandle baseColorTexture;     // none when the glTF names no image
+};
+
+struct TextureAsset {
+    Texture2D texture{};    // raylib's 1x1 white when the image is missing or failed to load
+    bool missing = false;
+};
+
+// Resident bytes the manager tries to stay under by evicting unreferenced assets. CPU counts
+// mesh data raylib keeps in RAM (glTF fallback models keep every stream), GPU counts vertex,
+// index and texture memory including mips.
+struct AssetBudget {
+    size_t cpuBytes = (size_t)256 << 20;
+    size_t gpuBytes = (size_t)512 << 20;
+};
+
+enum class AssetKind { Model, Material, Texture };
+
+// One row of the debug view
+struct AssetInfo {
+    AssetKind kind;
+    std::string name;
+    int refs;
+    bool resident;
+    bool loading;
+    size_t cpuBytes;
+    size_t gpuBytes;
+    uint64_t lastUsedFrame;
+};
+
+// Reference-counted models, materials and textures, keyed by path. acquire*() takes a
+// reference and starts loading if needed; release() drops it. Unreferenced assets stay
+// resident as a cache and are evicted least recently used first once a budget is exceeded.
+// A model references its materials and a material its texture, so those stay as long as
+// something uses them, and textures shared between materials load once.
+//
+// Background jobs on the JobSystem map and validate the baked model cache, read the glTF's
+// material list and load textures (.ebtex, or the PNG when there is no cache). The main
+// thread uploads finished work within a per-frame time budget (pumpUploads). A stale or
+// missing model cache falls back to raylib's glTF loader, which has to run on the main thread
+// because it uploads as it parses. Everything except the load jobs' private state is
+// main-thread only.
+class AssetManager {
+public:
+    // quantizedVertices uploads baked models in their compact cache formats, which only the
+    // instancing shader can draw (see modelFromBaked). jobs must outlive the manager.
+    AssetManager(JobSystem &jobs, bool quantizedVertices, const AssetBudget &budget);
+    ~AssetManager();
+    AssetManager(const AssetManager &) = delete;
+    AssetManager &operator=(const AssetManager &) = delete;
+
+    // Urgent loads jump the load queue (e.g. the model shown in a preview).
+    ModelHandle acquireModel(const std::string &gltfPath, bool urgent = false);
+    TextureHandle acquireTexture(const std::string &path, bool urgent = false);
+    void release(ModelHandle handle);
+    void release(MaterialHandle handle);
+    void release(TextureHandle handle);
+
+    // Loads without taking a reference: resident until the budget needs the room.
+    void prefetchModel(const std::string &gltfPath);
+
+    // Null until resident with every texture it uses settled; marks the model used this frame.
+    const ModelAsset *model(ModelHandle handle);
+    const MaterialAsset *material(MaterialHandle handle) const;
+    const TextureAsset *texture(TextureHandle handle) const;
+
+    // Reloads every resident texture at the new resolution tier; the old one stays bound
+    // until its replacement is uploaded.
+    void setTextureQuality(TextureQuality quality);
+    TextureQuality textureQuality() const { return quality_; }
+    void setBudget(const AssetBudget &budget) { budget_ = budget; }
+    const AssetBudget &budget() const { return budget_; }
+    size_t residentCpuBytes() const;
+    size_t residentGpuBytes() const;
+    size_t residentTextureBytes() const;
+
+    // Main thread, once per frame: uploads finished loads until budgetSeconds is used (at
+    // least one per call), then evicts unreferenced assets while over budget.
+    void pumpUploads(double budgetSeconds);
+    bool busy() const;
+
+    // Every known asset, for the debug view
+    std::vector<AssetInfo> assets() const;
+
+    // Unloads everything, referenced or not; handles are dead afterwards.
+    void unloadAll();
+
+private:
+    enum class State { Unloaded, Loading, Resident };
+
+    struct ModelEntry {
+        std::string path;
+        uint32_t generation = 0;
+        int refs = 0;
+        State state = State::Unloaded;
+        bool urgent = false;
+        bool ready = false;         // resident and every material's texture has settled
+        ModelAsset asset;
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+        uint64_t lastUsed = 0;
+    };
+    struct MaterialEntry {
+        std::string key;            // gltfPath#index
+        uint32_t generation = 0;
+        int refs = 0;
+        bool resident = false;
+        MaterialAsset asset;
+    };
+    struct TextureEntry {
+        std::string path;
+        uint32_t generation = 0;
+        int refs = 0;
+        State state = State::Unloaded;
+        bool reloading = false;     // resident, a new tier is on its way
+        TextureAsset asset;
+        size_t gpuBytes = 0;
+        uint64_t lastUsed = 0;
+    };
+
+    struct Pending;
+    struct Job {
+        AssetKind kind;     // Model or Texture
+        uint32_t slot;
+        uint32_t generation;
+        std::string path;
+    };
+
+    // Materials come from a model's glTF and are only acquired through it
+    MaterialHandle acquireMaterial(const std::string &key, const GltfMaterial &source, bool urgent);
+    void queueJob(const Job &job, bool urgent);
+    // One background job per queued Job; each runs whichever is at the front by then
+    static void loadNext(void *context, int begin, int end);
+    void loadModel(Pending &pending) const;
+    void loadTexture(Pending &pending) const;
+    void uploadModel(Pending &pending);
+    void uploadTexture(Pending &pending);
+    bool bindMaterials(ModelEntry &entry);
+    void unloadModel(ModelEntry &entry);
+    void unloadTexture(TextureEntry &entry);
+    void evictToBudget();
+
+    const bool quantizedVertices_;
+    AssetBudget budget_;
+    TextureQuality quality_ = TextureQuality::High;
+    uint64_t frame_ = 0;
+    bool materialsDirty_ = false;       // a texture or model arrived; models re-bind and re-check readiness
+    bool overBudgetWarned_ = false;
+
+    std::vector<ModelEntry> models_;
+    std::vector<MaterialEntry> materials_;
+    std::vector<TextureEntry> textures_;
+    std::unordered_map<std::string, uint32_t> modelSlots_;
+    std::unordered_map<std::string, uint32_t> materialSlots_;
+    std::unordered_map<std::string, uint32_t> textureSlots_;
+
+    JobSystem &jobSystem_;
+    JobCounter loads_;
+    mutable std::mutex mutex_;
+    std::deque<Job> jobs_;
+    std::deque<std::unique_ptr<Pending>> ready_;
+    int inFlight_ = 0;
+    bool stopping_ = false;
+    TextureQuality workerQuality_ = TextureQuality::High;      // quality_ as the load jobs see it, under mutex_
+};
@@ -0,0 +1,42 @@
+#include "assets/cache_io.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+uint64_t stampFileSize(uint64_t hash, const std::string &path) {
+    std::error_code ec;
+    uint64_t size = (uint64_t)fs::file_size(path, ec);
+    if (ec) return hash;
+    return fnv1a(hash, &size, sizeof(size));
+}
+
+uint64_t stampFileContents(uint64_t hash, const std::string &path, size_t maxBytes) {
+    FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f) return hash;
+    unsigned char buffer[16384];
+    size_t n;
+    while (maxBytes > 0 && (n = std::fread(buffer, 1, std::min(sizeof(buffer), maxBytes), f)) > 0) {
+        hash = fnv1a(hash, buffer, n);
+        maxBytes -= n;
+    }
+    std::fclose(f);
+    return hash;
+}
+
+bool writeFileAtomic(const std::string &path, const void *data, size_t size) {
+    std::string tmp = path + ".tmp";
+    FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(data, 1, size, f) == size;
+    ok = (std::fclose(f) == 0) && ok;
+    std::error_code ec;
+    if (ok) fs::rename(tmp, path, ec);
+    if (!ok || ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
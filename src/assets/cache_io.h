@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "core/hash.h"
+
+// Shared plumbing for the baked asset caches (.ebmdl, .ebtex).
+
+// Folds in the file's size; missing files leave the hash unchanged.
+uint64_t stampFileSize(uint64_t hash, const std::string &path);
+
+// Folds in up to maxBytes of the file's contents (all of it by default).
+uint64_t stampFileContents(uint64_t hash, const std::string &path, size_t maxBytes = SIZE_MAX);
+
+// Writes to a temp file and renames so a crashed bake never leaves a half-written cache.
+bool writeFileAtomic(const std::string &path, const void *data, size_t size);
@@ -0,0 +1,69 @@
+#include "assets/gltf_materials.h"
+
+#include <filesystem>
+#include "core/json.h"
+#include "core/mapped_file.h"
+
+namespace fs = std::filesystem;
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// glTF URIs are RFC 3986 relative references, so spaces and the like arrive percent-encoded
+static std::string decodeUri(const std::string &uri) {
+    std::string out;
+    for (size_t i = 0; i < uri.size(); ++i) {
+        int hi = i + 2 < uri.size() ? hexDigit(uri[i + 1]) : -1;
+        int lo = i + 2 < uri.size() ? hexDigit(uri[i + 2]) : -1;
+        if (uri[i] == '%' && hi >= 0 && lo >= 0) {
+            out += (char)(hi * 16 + lo);
+            i += 2;
+        } else {
+            out += uri[i];
+        }
+    }
+    return out;
+}
+
+// materials[].pbrMetallicRoughness.baseColorTexture.index -> textures[].source -> images[].uri
+static std::string baseColorImage(const JsonValue &root, const JsonValue &pbr, const fs::path &dir) {
+    const JsonValue *texture = pbr.find("baseColorTexture");
+    const JsonValue *index = texture ? texture->find("index") : nullptr;
+    const JsonValue *textures = root.find("textures");
+    const JsonValue *entry = index && textures ? textures->at((size_t)index->asInt(-1)) : nullptr;
+    const JsonValue *source = entry ? entry->find("source") : nullptr;
+    const JsonValue *images = root.find("images");
+    const JsonValue *image = source && images ? images->at((size_t)source->asInt(-1)) : nullptr;
+    const JsonValue *uri = image ? image->find("uri") : nullptr;
+    if (!uri || !uri->isString() || uri->string.compare(0, 5, "data:") == 0) return std::string();
+    return (dir / fs::u8path(decodeUri(uri->string))).lexically_normal().generic_string();
+}
+
+bool readGltfMaterials(const std::string &gltfPath, std::vector<GltfMaterial> &materials) {
+    materials.clear();
+    MappedFile file;
+    if (!file.open(gltfPath.c_str())) return false;
+    JsonValue root;
+    if (!parseJson((const char *)file.data(), file.size(), root) || !root.isObject()) return false;
+
+    const fs::path dir = fs::path(gltfPath).parent_path();
+    const JsonValue *list = root.find("materials");
+    if (!list || !list->isArray()) return true;
+    for (const JsonValue &m : list->items) {
+        GltfMaterial material;
+        if (const JsonValue *name = m.find("name")) material.name = name->string;
+        if (const JsonValue *pbr = m.find("pbrMetallicRoughness")) {
+            material.baseColorPath = baseColorImage(root, *pbr, dir);
+            const JsonValue *factor = pbr->find("baseColorFactor");
+            for (size_t k = 0; factor && k < 4; ++k) {
+                if (const JsonValue *v = factor->at(k)) material.baseColorFactor[k] = (float)v->number;
+            }
+        }
+        materials.push_back(material);
+    }
+    return true;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// What a glTF says about its materials, read from the .gltf JSON without loading any
+// geometry. Material i here is raylib's model.materials[i + 1] (raylib puts a default
+// material at index 0), which is also what the baked cache stores per mesh.
+struct GltfMaterial {
+    std::string name;
+    std::string baseColorPath;      // image file for baseColorTexture, resolved against the .gltf; empty if none
+    float baseColorFactor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+};
+
+// False when the file cannot be read or is not valid JSON. Embedded (data:) images are
+// reported without a path.
+bool readGltfMaterials(const std::string &gltfPath, std::vector<GltfMaterial> &materials);
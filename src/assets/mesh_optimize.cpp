@@ -0,0 +1,211 @@
+#include "assets/mesh_optimize.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Forsyth's scoring: an LRU cache somewhat larger than any real post-transform cache, a fixed
+// score for the last triangle's vertices so the next pick is not forced to share all three,
+// and a bonus for vertices with few triangles left so none end up stranded
+static const int kCacheSize = 32;
+static const float kLastTriangleScore = 0.75f;
+static const float kCacheDecayPower = 1.5f;
+static const float kValenceBoostScale = 2.0f;
+static const float kValenceBoostPower = 0.5f;
+
+static float vertexScore(int cachePosition, int liveTriangles) {
+    if (liveTriangles == 0) return -1.0f;
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) score = kLastTriangleScore;
+        else score = std::pow(1.0f - (float)(cachePosition - 3) / (kCacheSize - 3), kCacheDecayPower);
+    }
+    return score + kValenceBoostScale * std::pow((float)liveTriangles, -kValenceBoostPower);
+}
+
+void optimizeVertexCache(unsigned short *indices, int indexCount, int vertexCount) {
+    const int triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount <= 0) return;
+
+    // Triangles per vertex; the first live[v] entries of each list are the ones not yet emitted
+    std::vector<int> live(vertexCount, 0), start(vertexCount + 1, 0), triangles((size_t)triangleCount * 3);
+    for (int i = 0; i < triangleCount * 3; ++i) live[indices[i]]++;
+    for (int v = 0; v < vertexCount; ++v) start[v + 1] = start[v] + live[v];
+    {
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int i = 0; i < triangleCount * 3; ++i) triangles[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (int v = 0; v < vertexCount; ++v) score[v] = vertexScore(-1, live[v]);
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<unsigned char> emitted(triangleCount, 0);
+    int best = 0;
+    for (int t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[best]) best = t;
+    }
+
+    std::vector<unsigned short> out;
+    out.reserve((size_t)triangleCount * 3);
+    int cache[kCacheSize + 3];
+    int cacheCount = 0;
+    int scan = 0;
+    while ((int)out.size() < triangleCount * 3) {
+        if (best < 0) {
+            // Nothing in the cache has triangles left: continue with the next unused one
+            while (emitted[scan]) scan++;
+            best = scan;
+        }
+        const int tri[3] = {indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2]};
+        emitted[best] = 1;
+        for (int v : tri) {
+            out.push_back((unsigned short)v);
+            int *list = &triangles[start[v]];
+            for (int k = 0; k < live[v]; ++k) {
+                if (list[k] == best) {
+                    std::swap(list[k], list[live[v] - 1]);
+                    live[v]--;
+                    break;
+                }
+            }
+        }
+
+        // Move the triangle's vertices to the front; whatever falls off the end leaves the cache
+        int next[kCacheSize + 3];
+        int nextCount = 0;
+        for (int v : tri) next[nextCount++] = v;
+        for (int k = 0; k < cacheCount; ++k) {
+            int v = cache[k];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) next[nextCount++] = v;
+        }
+        for (int k = 0; k < nextCount; ++k) {
+            int v = next[k];
+            cachePosition[v] = k < kCacheSize ? k : -1;
+            score[v] = vertexScore(cachePosition[v], live[v]);
+        }
+        cacheCount = std::min(nextCount, kCacheSize);
+        std::memcpy(cache, next, sizeof(int) * cacheCount);
+
+        // Only triangles touching changed vertices change score, and the best next pick is one of them
+        best = -1;
+        float bestScore = -1.0f;
+        for (int k = 0; k < nextCount; ++k) {
+            int v = next[k];
+            for (int j = 0; j < live[v]; ++j) {
+                int t = triangles[start[v] + j];
+                float s = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                triangleScore[t] = s;
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = t;
+                }
+            }
+        }
+    }
+    std::memcpy(indices, out.data(), sizeof(unsigned short) * out.size());
+}
+
+float vertexCacheMissRatio(const unsigned short *indices, int indexCount, int vertexCount, int cacheSize) {
+    const int triangleCount = indexCount / 3;
+    if (triangleCount == 0) return 0.0f;
+    // FIFO: a vertex is a hit while fewer than cacheSize misses happened since it was loaded
+    std::vector<unsigned int> loadedAt(vertexCount, 0);
+    unsigned int clock = (unsigned int)cacheSize + 1;
+    int misses = 0;
+    for (int i = 0; i < triangleCount * 3; ++i) {
+        unsigned short v = indices[i];
+        if (clock - loadedAt[v] > (unsigned int)cacheSize) {
+            loadedAt[v] = clock++;
+            misses++;
+        }
+    }
+    return (float)misses / triangleCount;
+}
+
+std::vector<unsigned short> vertexFetchRemap(const unsigned short *indices, int indexCount, int vertexCount) {
+    std::vector<int> order(vertexCount, -1);
+    int next = 0;
+    for (int i = 0; i < indexCount; ++i) {
+        if (order[indices[i]] < 0) order[indices[i]] = next++;
+    }
+    std::vector<unsigned short> remap(vertexCount);
+    for (int v = 0; v < vertexCount; ++v) remap[v] = (unsigned short)(order[v] < 0 ? next++ : order[v]);
+    return remap;
+}
+
+void remapIndices(unsigned short *indices, int indexCount, const std::vector<unsigned short> &remap) {
+    for (int i = 0; i < indexCount; ++i) indices[i] = remap[indices[i]];
+}
+
+void remapVertices(void *vertices, int vertexCount, size_t stride, const std::vector<unsigned short> &remap) {
+    unsigned char *bytes = (unsigned char *)vertices;
+    std::vector<unsigned char> source(bytes, bytes + stride * vertexCount);
+    for (int v = 0; v < vertexCount; ++v) std::memcpy(bytes + stride * remap[v], &source[stride * v], stride);
+}
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, 4);
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const uint32_t magnitude = bits & 0x7fffffff;
+    if (magnitude >= 0x7f800000) return (uint16_t)(sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0));
+    if (magnitude >= 0x477ff000) return (uint16_t)(sign | 0x7c00);     // rounds past 65504
+    if (magnitude < 0x38800000) {
+        // Below the smallest normal half: subnormal steps of 2^-24
+        float f;
+        std::memcpy(&f, &magnitude, 4);
+        return (uint16_t)(sign | (uint32_t)std::lrint(f * 16777216.0f));
+    }
+    uint32_t h = magnitude - 0x38000000;    // rebias exponent 127 -> 15
+    h += 0xfff + ((h >> 13) & 1);
+    return (uint16_t)(sign | (h >> 13));
+}
+
+float halfToFloat(uint16_t value) {
+    const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1f;
+    const uint32_t mantissa = value & 0x3ff;
+    if (exponent == 0) {
+        float f = mantissa / 16777216.0f;
+        return sign ? -f : f;
+    }
+    uint32_t bits = exponent == 31 ? sign | 0x7f800000 | (mantissa << 13) : sign | ((exponent + 112) << 23) | (mantissa << 13);
+    float f;
+    std::memcpy(&f, &bits, 4);
+    return f;
+}
+
+static float signNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+void encodeOctahedral(const float normal[3], int16_t out[2]) {
+    float l1 = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    float x = l1 > 0.0f ? normal[0] / l1 : 0.0f;
+    float y = l1 > 0.0f ? normal[1] / l1 : 0.0f;
+    if (normal[2] < 0.0f) {
+        // Lower hemisphere folds over the diagonals
+        float fx = (1.0f - std::fabs(y)) * signNotZero(x);
+        float fy = (1.0f - std::fabs(x)) * signNotZero(y);
+        x = fx;
+        y = fy;
+    }
+    out[0] = (int16_t)std::lrint(std::clamp(x, -1.0f, 1.0f) * 32767.0f);
+    out[1] = (int16_t)std::lrint(std::clamp(y, -1.0f, 1.0f) * 32767.0f);
+}
+
+void decodeOctahedral(const int16_t in[2], float normal[3]) {
+    float x = std::max(in[0] / 32767.0f, -1.0f);
+    float y = std::max(in[1] / 32767.0f, -1.0f);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f) {
+        float fx = (1.0f - std::fabs(y)) * signNotZero(x);
+        float fy = (1.0f - std::fabs(x)) * signNotZero(y);
+        x = fx;
+        y = fy;
+    }
+    float len = std::sqrt(x * x + y * y + z * z);
+    normal[0] = x / len;
+    normal[1] = y / len;
+    normal[2] = z / len;
+}
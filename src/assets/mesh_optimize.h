@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Offline mesh optimizations run by epiCBattle_bake before writing the model cache:
+// triangle order for the post-transform vertex cache, vertex order for fetch locality, and
+// the compact vertex formats the cache stores (see assets/model_cache.h).
+
+// Reorders triangles in place so vertices are reused while still in the post-transform cache
+// (Forsyth's linear-speed greedy algorithm). Triangle winding is kept.
+void optimizeVertexCache(unsigned short *indices, int indexCount, int vertexCount);
+
+// Average cache misses per triangle (ACMR) for a FIFO cache of cacheSize vertices: 3 means no
+// reuse at all, around 0.6-0.7 is good for character meshes.
+float vertexCacheMissRatio(const unsigned short *indices, int indexCount, int vertexCount, int cacheSize = 16);
+
+// New vertex order by first use in indices, as remap[old] = new; unreferenced vertices go last.
+std::vector<unsigned short> vertexFetchRemap(const unsigned short *indices, int indexCount, int vertexCount);
+
+// Applies a remap from vertexFetchRemap to an index buffer or a vertex stream of `stride` bytes.
+void remapIndices(unsigned short *indices, int indexCount, const std::vector<unsigned short> &remap);
+void remapVertices(void *vertices, int vertexCount, size_t stride, const std::vector<unsigned short> &remap);
+
+// IEEE half precision, round to nearest even (texcoords)
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t value);
+
+// Unit normal folded onto an octahedron and stored as two snorm16 values (4 bytes instead of 12)
+void encodeOctahedral(const float normal[3], int16_t out[2]);
+void decodeOctahedral(const int16_t in[2], float normal[3]);
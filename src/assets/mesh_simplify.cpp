@@ -0,0 +1,336 @@
+#include "assets/mesh_simplify.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+enum class VertexKind : uint8_t { Manifold, Border, Seam, Locked };
+
+// Open edges get a plane perpendicular to the surface, weighted like this many faces, so
+// silhouettes and seams keep their shape
+static const float kBorderWeight = 10.0f;
+
+struct Quadric {
+    // Symmetric 4x4: A (3x3), b, c, plus the accumulated area so errors are per unit area
+    double a00 = 0, a11 = 0, a22 = 0, a10 = 0, a20 = 0, a21 = 0;
+    double b0 = 0, b1 = 0, b2 = 0, c = 0;
+    double weight = 0;
+
+    void addPlane(double nx, double ny, double nz, double d, double w) {
+        a00 += w * nx * nx; a11 += w * ny * ny; a22 += w * nz * nz;
+        a10 += w * ny * nx; a20 += w * nz * nx; a21 += w * nz * ny;
+        b0 += w * nx * d; b1 += w * ny * d; b2 += w * nz * d;
+        c += w * d * d;
+        weight += w;
+    }
+    void add(const Quadric &q) {
+        a00 += q.a00; a11 += q.a11; a22 += q.a22; a10 += q.a10; a20 += q.a20; a21 += q.a21;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c;
+        weight += q.weight;
+    }
+    // Squared distance (area weighted mean) from p to the planes
+    double error(const float *p) const {
+        double x = p[0], y = p[1], z = p[2];
+        double e = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a10 * x * y + a20 * x * z + a21 * y * z) +
+                   2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return weight > 0.0 ? std::fabs(e) / weight : 0.0;
+    }
+};
+
+struct Collapse {
+    int from;       // canonical vertex that moves
+    int to;         // canonical vertex it lands on
+    float error;
+};
+
+// Outgoing half-edges per vertex (CSR), rebuilt from the current index buffer each pass.
+struct EdgeAdjacency {
+    std::vector<int> start;
+    std::vector<int> target;
+
+    void build(const std::vector<unsigned short> &indices, int vertexCount) {
+        start.assign(vertexCount + 1, 0);
+        for (unsigned short v : indices) start[v + 1]++;
+        for (int v = 0; v < vertexCount; ++v) start[v + 1] += start[v];
+        target.resize(indices.size());
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            for (int e = 0; e < 3; ++e) target[fill[indices[t + e]]++] = indices[t + (e + 1) % 3];
+        }
+    }
+    bool has(int from, int to) const {
+        for (int k = start[from]; k < start[from + 1]; ++k) {
+            if (target[k] == to) return true;
+        }
+        return false;
+    }
+    bool connected(int a, int b) const { return has(a, b) || has(b, a); }
+};
+
+static void cross(const float *a, const float *b, const float *c, double n[3]) {
+    double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    double e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+std::vector<unsigned short> simplifyMesh(const unsigned short *indices, int indexCount, const float *positions, int vertexCount,
+                                         int targetIndexCount, float maxError, float *resultError) {
+    std::vector<unsigned short> out(indices, indices + indexCount);
+    if (resultError) *resultError = 0.0f;
+    if (indexCount < 3 || vertexCount <= 0 || targetIndexCount >= indexCount) return out;
+
+    // Work in a unit box so errors are relative to the model size
+    float lo[3] = {positions[0], positions[1], positions[2]};
+    float hi[3] = {positions[0], positions[1], positions[2]};
+    for (int v = 0; v < vertexCount; ++v) {
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::min(lo[k], positions[v * 3 + k]);
+            hi[k] = std::max(hi[k], positions[v * 3 + k]);
+        }
+    }
+    float extent = std::max(hi[0] - lo[0], std::max(hi[1] - lo[1], hi[2] - lo[2]));
+    float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+    std::vector<float> pos((size_t)vertexCount * 3);
+    for (int v = 0; v < vertexCount; ++v) {
+        for (int k = 0; k < 3; ++k) pos[v * 3 + k] = (positions[v * 3 + k] - lo[k]) * scale;
+    }
+
+    // Wedges: vertices sharing a position. remap[v] is the first of them, wedge[v] the next in a ring
+    std::vector<int> remap(vertexCount), wedge(vertexCount);
+    {
+        struct Key {
+            uint32_t x, y, z;
+            bool operator==(const Key &o) const { return x == o.x && y == o.y && z == o.z; }
+        };
+        struct KeyHash {
+            size_t operator()(const Key &k) const { return (size_t)(k.x * 73856093u ^ k.y * 19349663u ^ k.z * 83492791u); }
+        };
+        std::unordered_map<Key, int, KeyHash> first;
+        first.reserve((size_t)vertexCount);
+        for (int v = 0; v < vertexCount; ++v) {
+            Key key;
+            std::memcpy(&key.x, &positions[v * 3 + 0], 4);
+            std::memcpy(&key.y, &positions[v * 3 + 1], 4);
+            std::memcpy(&key.z, &positions[v * 3 + 2], 4);
+            auto it = first.emplace(key, v).first;
+            remap[v] = it->second;
+            wedge[v] = v;
+            if (it->second != v) {
+                // Insert v into the ring after the canonical vertex
+                wedge[v] = wedge[it->second];
+                wedge[it->second] = v;
+            }
+        }
+    }
+
+    // Classify each position by its open (unpaired) half-edges
+    EdgeAdjacency adjacency;
+    adjacency.build(out, vertexCount);
+    std::vector<VertexKind> kind(vertexCount, VertexKind::Manifold);
+    {
+        std::vector<int> openOut(vertexCount, 0), openIn(vertexCount, 0), seamOut(vertexCount, 0);
+        for (int a = 0; a < vertexCount; ++a) {
+            for (int k = adjacency.start[a]; k < adjacency.start[a + 1]; ++k) {
+                int b = adjacency.target[k];
+                if (adjacency.has(b, a)) continue;
+                openOut[a]++;
+                openIn[b]++;
+                // Paired through other wedges at the same positions: a UV/normal seam, not a hole
+                for (int wb = wedge[b]; wb != b; wb = wedge[wb]) {
+                    bool paired = false;
+                    for (int wa = wedge[a]; wa != a && !paired; wa = wedge[wa]) paired = adjacency.has(wb, wa);
+                    if (paired) { seamOut[a]++; break; }
+                }
+            }
+        }
+        for (int v = 0; v < vertexCount; ++v) {
+            if (remap[v] != v) continue;
+            int wedges = 0, open = 0, seams = 0;
+            bool simple = true;
+            int w = v;
+            do {
+                wedges++;
+                open += openOut[w];
+                seams += seamOut[w];
+                if (openOut[w] > 1 || openIn[w] > 1 || openOut[w] != openIn[w]) simple = false;
+                w = wedge[w];
+            } while (w != v);
+            VertexKind k = VertexKind::Locked;
+            if (wedges == 1 && open == 0) k = VertexKind::Manifold;
+            else if (wedges == 1 && open == 1 && simple && seams == 0) k = VertexKind::Border;
+            else if (wedges == 2 && open == 2 && simple && seams == 2) k = VertexKind::Seam;
+            w = v;
+            do {
+                kind[w] = k;
+                w = wedge[w];
+            } while (w != v);
+        }
+    }
+
+    // Quadrics per position: face planes weighted by area, plus edge planes along open edges
+    std::vector<Quadric> quadric(vertexCount);
+    for (size_t t = 0; t + 2 < out.size(); t += 3) {
+        const int tri[3] = {out[t], out[t + 1], out[t + 2]};
+        double n[3];
+        cross(&pos[tri[0] * 3], &pos[tri[1] * 3], &pos[tri[2] * 3], n);
+        double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len <= 0.0) continue;
+        double area = len * 0.5;
+        n[0] /= len; n[1] /= len; n[2] /= len;
+        const float *p0 = &pos[tri[0] * 3];
+        double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+        for (int e = 0; e < 3; ++e) quadric[remap[tri[e]]].addPlane(n[0], n[1], n[2], d, area);
+        for (int e = 0; e < 3; ++e) {
+            int a = tri[e], b = tri[(e + 1) % 3];
+            if (adjacency.has(b, a)) continue;
+            const float *pa = &pos[a * 3];
+            const float *pb = &pos[b * 3];
+            double ed[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+            double elen2 = ed[0] * ed[0] + ed[1] * ed[1] + ed[2] * ed[2];
+            if (elen2 <= 0.0) continue;
+            // Plane containing the edge, perpendicular to the face
+            double m[3] = {ed[1] * n[2] - ed[2] * n[1], ed[2] * n[0] - ed[0] * n[2], ed[0] * n[1] - ed[1] * n[0]};
+            double mlen = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+            m[0] /= mlen; m[1] /= mlen; m[2] /= mlen;
+            double md = -(m[0] * pa[0] + m[1] * pa[1] + m[2] * pa[2]);
+            quadric[remap[a]].addPlane(m[0], m[1], m[2], md, elen2 * kBorderWeight);
+            quadric[remap[b]].addPlane(m[0], m[1], m[2], md, elen2 * kBorderWeight);
+        }
+    }
+
+    const double maxError2 = (double)maxError * maxError;
+    double worstError2 = 0.0;
+    std::vector<int> collapseRemap(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<Collapse> collapses;
+    std::vector<int> triStart, triList;
+
+    // Maps every wedge of `from` onto the wedge of `to` it shares an edge with; false if one has none.
+    auto mapWedges = [&](int from, int to, bool apply) {
+        int a = from;
+        do {
+            int match = -1;
+            int b = to;
+            do {
+                if (adjacency.connected(a, b)) { match = b; break; }
+                b = wedge[b];
+            } while (b != to);
+            if (match < 0) return false;
+            if (apply) collapseRemap[a] = match;
+            a = wedge[a];
+        } while (a != from);
+        return true;
+    };
+
+    // Rejects collapses that would turn a surviving triangle around `from` by more than ~75 degrees.
+    auto flips = [&](int from, int to) {
+        int a = from;
+        do {
+            for (int k = triStart[a]; k < triStart[a + 1]; ++k) {
+                size_t t = (size_t)triList[k];
+                int c[3];
+                bool collapses = false;
+                for (int e = 0; e < 3; ++e) {
+                    c[e] = collapseRemap[out[t + e]];
+                    if (remap[c[e]] == to) collapses = true;
+                }
+                if (collapses) continue;
+                double before[3], after[3];
+                cross(&pos[c[0] * 3], &pos[c[1] * 3], &pos[c[2] * 3], before);
+                int moved[3];
+                for (int e = 0; e < 3; ++e) moved[e] = remap[c[e]] == from ? to : c[e];
+                cross(&pos[moved[0] * 3], &pos[moved[1] * 3], &pos[moved[2] * 3], after);
+                double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+                double lens = std::sqrt((before[0] * before[0] + before[1] * before[1] + before[2] * before[2]) *
+                                        (after[0] * after[0] + after[1] * after[1] + after[2] * after[2]));
+                if (dot <= 0.25 * lens) return true;
+            }
+            a = wedge[a];
+        } while (a != from);
+        return false;
+    };
+
+    auto allowed = [&](int from, int to, bool open) {
+        switch (kind[from]) {
+            case VertexKind::Manifold: return true;
+            case VertexKind::Border: return open && (kind[to] == VertexKind::Border || kind[to] == VertexKind::Locked);
+            case VertexKind::Seam: return open && (kind[to] == VertexKind::Seam || kind[to] == VertexKind::Locked);
+            default: return false;
+        }
+    };
+
+    while ((int)out.size() > targetIndexCount) {
+        if (adjacency.target.size() != out.size()) adjacency.build(out, vertexCount);
+
+        // Triangles touching each vertex, for the flip test
+        triStart.assign(vertexCount + 1, 0);
+        for (unsigned short v : out) triStart[v + 1]++;
+        for (int v = 0; v < vertexCount; ++v) triStart[v + 1] += triStart[v];
+        triList.resize(out.size());
+        {
+            std::vector<int> fill(triStart.begin(), triStart.end() - 1);
+            for (size_t i = 0; i < out.size(); ++i) triList[fill[out[i]]++] = (int)(i - i % 3);
+        }
+
+        // Cheapest legal direction for every edge
+        collapses.clear();
+        for (size_t t = 0; t + 2 < out.size(); t += 3) {
+            for (int e = 0; e < 3; ++e) {
+                int a = out[t + e], b = out[t + (e + 1) % 3];
+                int ra = remap[a], rb = remap[b];
+                if (ra == rb) continue;
+                bool open = !adjacency.has(b, a);
+                // Each interior edge shows up twice; keep the copy from the lower vertex
+                if (!open && a > b) continue;
+                Quadric q = quadric[ra];
+                q.add(quadric[rb]);
+                double ab = allowed(ra, rb, open) ? q.error(&pos[rb * 3]) : -1.0;
+                double ba = allowed(rb, ra, open) ? q.error(&pos[ra * 3]) : -1.0;
+                if (ab < 0.0 && ba < 0.0) continue;
+                if (ba >= 0.0 && (ab < 0.0 || ba < ab)) collapses.push_back({rb, ra, (float)ba});
+                else collapses.push_back({ra, rb, (float)ab});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y) { return x.error < y.error; });
+
+        for (int v = 0; v < vertexCount; ++v) collapseRemap[v] = v;
+        std::fill(touched.begin(), touched.end(), 0);
+        const int triangleGoal = ((int)out.size() - targetIndexCount) / 3;
+        int removed = 0;
+        int applied = 0;
+        for (const Collapse &c : collapses) {
+            if (removed >= triangleGoal) break;
+            if (c.error > maxError2) break;
+            if (touched[c.from] || touched[c.to]) continue;
+            if (!mapWedges(c.from, c.to, false) || flips(c.from, c.to)) continue;
+            mapWedges(c.from, c.to, true);
+            quadric[c.to].add(quadric[c.from]);
+            worstError2 = std::max(worstError2, (double)c.error);
+            // Neighbours keep their triangles valid for this pass by not moving again
+            touched[c.from] = 1;
+            touched[c.to] = 1;
+            removed += kind[c.from] == VertexKind::Manifold ? 2 : 1;
+            applied++;
+        }
+        if (applied == 0) break;
+
+        // Rewrite the index buffer and drop triangles that lost an edge
+        size_t kept = 0;
+        for (size_t t = 0; t + 2 < out.size(); t += 3) {
+            int a = collapseRemap[out[t]], b = collapseRemap[out[t + 1]], c = collapseRemap[out[t + 2]];
+            if (remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c]) continue;
+            out[kept++] = (unsigned short)a;
+            out[kept++] = (unsigned short)b;
+            out[kept++] = (unsigned short)c;
+        }
+        out.resize(kept);
+        adjacency.target.clear();
+    }
+
+    if (resultError) *resultError = (float)std::sqrt(worstError2);
+    return out;
+}
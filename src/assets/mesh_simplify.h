@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+// Quadric error metric simplification (Garland-Heckbert) for the baked character LODs.
+// Works on an indexed triangle list and only collapses vertices onto existing ones, so a
+// LOD is just another index buffer over the full-detail vertex streams: no new vertices,
+// attributes stay exact, and every LOD shares one set of VBOs on the GPU.
+//
+// Vertices at the same position (UV or normal seams) are treated as one; seam and open
+// border vertices only slide along their seam/border so texture charts do not tear, and
+// collapses that would flip a triangle are rejected.
+
+// Returns at most targetIndexCount indices when that is reachable without exceeding maxError,
+// fewer collapses otherwise. maxError and *resultError are distances relative to the mesh's
+// largest bounding-box extent (0.01 = 1% of the model's size).
+std::vector<unsigned short> simplifyMesh(const unsigned short *indices, int indexCount, const float *positions, int vertexCount,
+                                         int targetIndexCount, float maxError, float *resultError = nullptr);
@@ -0,0 +1,144 @@
+#include "assets/model_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include "assets/cache_io.h"
+
+namespace fs = std::filesystem;
+
+std::string bakedModelPath(const std::string &gltfPath) {
+    return fs::path(gltfPath).replace_extension(".ebmdl").string();
+}
+
+uint64_t modelSourceStamp(const std::string &gltfPath) {
+    uint64_t hash = kFnvOffsetBasis;
+    fs::path gltf(gltfPath);
+    // The .gltf JSON and every .bin buffer next to it, in name order. Sizes alone miss an
+    // edit that keeps the buffer length (moved vertices). File times are not used: copying
+    // models/ next to the executable rewrites them.
+    hash = stampFileContents(hash, gltfPath);
+    std::vector<std::string> buffers;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(gltf.parent_path(), ec)) {
+        if (entry.path().extension() == ".bin") buffers.push_back(entry.path().string());
+    }
+    std::sort(buffers.begin(), buffers.end());
+    for (const std::string &path : buffers) hash = stampFileContents(stampFileSize(hash, path), path);
+    return hash;
+}
+
+static uint64_t alignUp(uint64_t v) { return (v + 15) & ~(uint64_t)15; }
+
+bool writeBakedModel(const std::string &path, const BakedModel &model) {
+    ModelCacheHeader header{};
+    header.magic = kModelCacheMagic;
+    header.version = kModelCacheVersion;
+    header.sourceStamp = model.sourceStamp;
+    header.meshCount = (uint32_t)model.meshes.size();
+    header.materialCount = (uint32_t)model.materialCount;
+    std::memcpy(header.boundsMin, model.boundsMin, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, model.boundsMax, sizeof(header.boundsMax));
+
+    // Lay out the streams after the mesh table
+    std::vector<ModelCacheMesh> table(model.meshes.size());
+    uint64_t offset = alignUp(sizeof(ModelCacheHeader) + sizeof(ModelCacheMesh) * table.size());
+    auto place = [&](const void *stream, uint64_t bytes) -> uint64_t {
+        if (!stream) return 0;
+        uint64_t at = offset;
+        offset = alignUp(offset + bytes);
+        return at;
+    };
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        const BakedMesh &m = model.meshes[i];
+        ModelCacheMesh &e = table[i];
+        e.vertexCount = (uint32_t)m.vertexCount;
+        e.triangleCount = (uint32_t)m.triangleCount;
+        e.materialIndex = (uint32_t)m.materialIndex;
+        std::memcpy(e.positionOffset, m.positionOffset, sizeof(e.positionOffset));
+        std::memcpy(e.positionScale, m.positionScale, sizeof(e.positionScale));
+        e.positions = place(m.positions, 8ull * m.vertexCount);
+        e.normals = place(m.normals, 4ull * m.vertexCount);
+        e.texcoords = place(m.texcoords, 4ull * m.vertexCount);
+        e.colors = place(m.colors, 4ull * m.vertexCount);
+        e.indices = place(m.indices, sizeof(unsigned short) * 3 * m.triangleCount);
+        e.lodCount = (uint32_t)m.lodCount;
+        for (int l = 0; l < m.lodCount; ++l) {
+            e.lodTriangleCount[l] = (uint32_t)m.lodTriangleCount[l];
+            e.lodIndices[l] = place(m.lodIndices[l], sizeof(unsigned short) * 3 * m.lodTriangleCount[l]);
+        }
+    }
+
+    std::vector<unsigned char> blob(offset, 0);
+    std::memcpy(blob.data(), &header, sizeof(header));
+    std::memcpy(blob.data() + sizeof(header), table.data(), sizeof(ModelCacheMesh) * table.size());
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        const BakedMesh &m = model.meshes[i];
+        const ModelCacheMesh &e = table[i];
+        if (e.positions) std::memcpy(&blob[e.positions], m.positions, 8ull * m.vertexCount);
+        if (e.normals) std::memcpy(&blob[e.normals], m.normals, 4ull * m.vertexCount);
+        if (e.texcoords) std::memcpy(&blob[e.texcoords], m.texcoords, 4ull * m.vertexCount);
+        if (e.colors) std::memcpy(&blob[e.colors], m.colors, 4ull * m.vertexCount);
+        if (e.indices) std::memcpy(&blob[e.indices], m.indices, sizeof(unsigned short) * 3 * m.triangleCount);
+        for (int l = 0; l < m.lodCount; ++l) {
+            if (e.lodIndices[l]) std::memcpy(&blob[e.lodIndices[l]], m.lodIndices[l], sizeof(unsigned short) * 3 * m.lodTriangleCount[l]);
+        }
+    }
+
+    return writeFileAtomic(path, blob.data(), blob.size());
+}
+
+bool parseBakedModel(const unsigned char *data, size_t size, BakedModel &out) {
+    if (!data || size < sizeof(ModelCacheHeader)) return false;
+    ModelCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kModelCacheMagic || header.version != kModelCacheVersion) return false;
+    if (sizeof(ModelCacheHeader) + (uint64_t)header.meshCount * sizeof(ModelCacheMesh) > size) return false;
+
+    out = BakedModel{};
+    out.sourceStamp = header.sourceStamp;
+    out.materialCount = (int)header.materialCount;
+    std::memcpy(out.boundsMin, header.boundsMin, sizeof(out.boundsMin));
+    std::memcpy(out.boundsMax, header.boundsMax, sizeof(out.boundsMax));
+    out.meshes.resize(header.meshCount);
+
+    const ModelCacheMesh *table = (const ModelCacheMesh *)(data + sizeof(ModelCacheHeader));
+    auto stream = [&](uint64_t offset, uint64_t bytes, const void *&ptr) {
+        if (offset == 0) { ptr = nullptr; return true; }
+        if (offset % 16 != 0 || offset + bytes > size) return false;
+        ptr = data + offset;
+        return true;
+    };
+    for (uint32_t i = 0; i < header.meshCount; ++i) {
+        const ModelCacheMesh &e = table[i];
+        BakedMesh &m = out.meshes[i];
+        m.vertexCount = (int)e.vertexCount;
+        m.triangleCount = (int)e.triangleCount;
+        m.materialIndex = (int)e.materialIndex;
+        const void *p = nullptr, *n = nullptr, *t = nullptr, *c = nullptr, *idx = nullptr;
+        if (!stream(e.positions, 8ull * e.vertexCount, p) || !p) return false;
+        if (!stream(e.normals, 4ull * e.vertexCount, n)) return false;
+        if (!stream(e.texcoords, 4ull * e.vertexCount, t)) return false;
+        if (!stream(e.colors, 4ull * e.vertexCount, c)) return false;
+        if (!stream(e.indices, 6ull * e.triangleCount, idx)) return false;
+        if (e.materialIndex >= header.materialCount && header.materialCount > 0) return false;
+        std::memcpy(m.positionOffset, e.positionOffset, sizeof(m.positionOffset));
+        std::memcpy(m.positionScale, e.positionScale, sizeof(m.positionScale));
+        m.positions = (const uint16_t *)p;
+        m.normals = (const int16_t *)n;
+        m.texcoords = (const uint16_t *)t;
+        m.colors = (const unsigned char *)c;
+        m.indices = (const unsigned short *)idx;
+        // LODs are extra index streams over the same vertices, so only indexed meshes have them
+        if (e.lodCount > (uint32_t)kMaxModelLods - 1 || (e.lodCount > 0 && !idx)) return false;
+        m.lodCount = (int)e.lodCount;
+        for (uint32_t l = 0; l < e.lodCount; ++l) {
+            const void *lod = nullptr;
+            if (!stream(e.lodIndices[l], 6ull * e.lodTriangleCount[l], lod) || !lod) return false;
+            m.lodTriangleCount[l] = (int)e.lodTriangleCount[l];
+            m.lodIndices[l] = (const unsigned short *)lod;
+        }
+    }
+    return true;
+}
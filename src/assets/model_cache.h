@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Baked model cache (.ebmdl): the mesh arrays raylib's glTF loader produces, optimized and
+// quantized once by epiCBattle_bake so the game can map the file and upload the streams
+// directly instead of re-parsing glTF JSON and buffers.
+//
+// Layout: ModelCacheHeader, meshCount ModelCacheMesh entries, then the vertex/index
+// streams, each 16-byte aligned. All offsets are from the start of the file.
+//
+// Version 2 adds simplified index streams per mesh (see assets/mesh_simplify.h). They index
+// the same vertices as the full-detail one, so a LOD costs only its indices on disk and GPU.
+// Version 3 stores triangles in vertex-cache order, vertices in first-use order and the
+// vertex streams in compact formats (assets/mesh_optimize.h): 16 bytes per vertex plus
+// colors, against 32 for raylib's float layout.
+
+constexpr uint32_t kModelCacheMagic = 0x444D4245;   // "EBMD"
+constexpr uint32_t kModelCacheVersion = 3;
+
+// Detail levels per model including the full-detail one (LOD 0)
+constexpr int kMaxModelLods = 4;
+
+struct ModelCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceStamp;       // modelSourceStamp() of the glTF at bake time
+    uint32_t meshCount;
+    uint32_t materialCount;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+struct ModelCacheMesh {
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+    uint32_t materialIndex;
+    uint32_t lodCount;          // simplified levels after LOD 0, at most kMaxModelLods - 1
+    float positionOffset[3];    // position = positionOffset + stored * positionScale
+    float positionScale[3];
+    uint64_t positions;         // ushort4 per vertex (w unused), see positionOffset
+    uint64_t normals;           // short2 per vertex, octahedral snorm, 0 if absent
+    uint64_t texcoords;         // half2 per vertex, 0 if absent
+    uint64_t colors;            // ubyte4 per vertex, 0 if absent
+    uint64_t indices;           // ushort3 per triangle, 0 if unindexed
+    uint32_t lodTriangleCount[kMaxModelLods - 1];
+    uint32_t reserved;
+    uint64_t lodIndices[kMaxModelLods - 1];     // ushort3 per triangle, coarser with each level
+};
+
+// One mesh's streams in the cache formats above; pointers are either caller-owned (writing)
+// or into the mapped file (reading).
+struct BakedMesh {
+    int vertexCount = 0;
+    int triangleCount = 0;
+    int materialIndex = 0;
+    float positionOffset[3] = {0.0f, 0.0f, 0.0f};
+    float positionScale[3] = {1.0f, 1.0f, 1.0f};
+    const uint16_t *positions = nullptr;
+    const int16_t *normals = nullptr;
+    const uint16_t *texcoords = nullptr;
+    const unsigned char *colors = nullptr;
+    const unsigned short *indices = nullptr;
+    int lodCount = 0;
+    int lodTriangleCount[kMaxModelLods - 1] = {};
+    const unsigned short *lodIndices[kMaxModelLods - 1] = {};
+};
+
+struct BakedModel {
+    uint64_t sourceStamp = 0;
+    int materialCount = 0;
+    float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+    float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+    std::vector<BakedMesh> meshes;
+};
+
+// "models/x/scene.gltf" -> "models/x/scene.ebmdl"
+std::string bakedModelPath(const std::string &gltfPath);
+
+// Identifies the source revision: contents of the .gltf plus sizes of the .bin files next to it.
+uint64_t modelSourceStamp(const std::string &gltfPath);
+
+bool writeBakedModel(const std::string &path, const BakedModel &model);
+
+// Validates the blob and points out.meshes at the streams inside it (no copies).
+bool parseBakedModel(const unsigned char *data, size_t size, BakedModel &out);
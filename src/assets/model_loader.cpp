@@ -0,0 +1,224 @@
+#include "assets/model_loader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "raymath.h"
+#include "rlgl.h"
+#include "assets/gltf_materials.h"
+#include "assets/mesh_optimize.h"
+#include "core/mapped_file.h"
+
+// raylib 5.0's MAX_MESH_VERTEX_BUFFERS; slot 6 holds the index buffer
+static const int kMeshVertexBuffers = 7;
+static const int kIndexBufferSlot = 6;
+
+// GL vertex attribute types rlgl has no names for
+static const int kGlShort = 0x1402;             // GL_SHORT
+static const int kGlUnsignedShort = 0x1403;     // GL_UNSIGNED_SHORT
+static const int kGlHalfFloat = 0x140B;         // GL_HALF_FLOAT
+
+static unsigned short *copyIndices(const unsigned short *indices, int triangleCount) {
+    size_t bytes = sizeof(unsigned short) * 3 * (size_t)triangleCount;
+    unsigned short *copy = (unsigned short *)RL_MALLOC(bytes);
+    std::memcpy(copy, indices, bytes);
+    return copy;
+}
+
+// Points the bound VAO's attributes at the vertex buffers in vboId, in either raylib's float
+// layout or the cache's quantized one. Streams a mesh lacks get the same constant defaults
+// UploadMesh sets.
+static void bindVertexStreams(const unsigned int *vboId, bool quantized) {
+    struct Attribute {
+        int location;
+        int components;
+        int type;
+        bool normalized;
+        int stride;
+    };
+    static const Attribute kFloat[] = {
+        {RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_FLOAT, false, 0},
+        {RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false, 0},
+        {RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 3, RL_FLOAT, false, 0},
+        {RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, 0},
+    };
+    // Positions stay integers (the shader applies offset and scale), normals are octahedral snorm
+    static const Attribute kQuantized[] = {
+        {RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, kGlUnsignedShort, false, 8},
+        {RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, kGlHalfFloat, false, 0},
+        {RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 2, kGlShort, true, 0},
+        {RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, 0},
+    };
+    for (const Attribute &a : quantized ? kQuantized : kFloat) {
+        if (vboId[a.location] == 0) {
+            const float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+            if (a.location == RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL) rlSetVertexAttributeDefault(a.location, white, SHADER_ATTRIB_VEC3, 3);
+            if (a.location == RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR) rlSetVertexAttributeDefault(a.location, white, SHADER_ATTRIB_VEC4, 4);
+            rlDisableVertexAttribute(a.location);
+            continue;
+        }
+        rlEnableVertexBuffer(vboId[a.location]);
+        rlSetVertexAttribute(a.location, a.components, a.type, a.normalized, a.stride, 0);
+        rlEnableVertexAttribute(a.location);
+    }
+}
+
+// The cache's streams uploaded as stored, 16 bytes per vertex plus colors
+static void uploadQuantized(Mesh &mesh, const BakedMesh &src) {
+    const int n = src.vertexCount;
+    mesh.vboId = (unsigned int *)RL_CALLOC(kMeshVertexBuffers, sizeof(unsigned int));
+    mesh.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(mesh.vaoId);
+    unsigned int *vbo = mesh.vboId;
+    vbo[RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION] = rlLoadVertexBuffer(src.positions, 8 * n, false);
+    if (src.texcoords) vbo[RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD] = rlLoadVertexBuffer(src.texcoords, 4 * n, false);
+    if (src.normals) vbo[RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL] = rlLoadVertexBuffer(src.normals, 4 * n, false);
+    if (src.colors) vbo[RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR] = rlLoadVertexBuffer(src.colors, 4 * n, false);
+    bindVertexStreams(mesh.vboId, true);
+    if (mesh.indices) {
+        vbo[kIndexBufferSlot] = rlLoadVertexBufferElement(mesh.indices, mesh.triangleCount * 3 * sizeof(unsigned short), false);
+    }
+    rlDisableVertexArray();
+}
+
+// Decodes the cache's streams back to floats for raylib's default shader
+static void uploadExpanded(Mesh &mesh, const BakedMesh &src) {
+    const int n = src.vertexCount;
+    std::vector<float> positions((size_t)n * 3), normals, texcoords;
+    for (int v = 0; v < n; ++v) {
+        for (int k = 0; k < 3; ++k) positions[v * 3 + k] = src.positionOffset[k] + src.positions[v * 4 + k] * src.positionScale[k];
+    }
+    if (src.normals) {
+        normals.resize((size_t)n * 3);
+        for (int v = 0; v < n; ++v) decodeOctahedral(&src.normals[v * 2], &normals[v * 3]);
+    }
+    if (src.texcoords) {
+        texcoords.resize((size_t)n * 2);
+        for (int v = 0; v < n * 2; ++v) texcoords[v] = halfToFloat(src.texcoords[v]);
+    }
+    // UploadMesh only reads these; they are cleared again below so UnloadModel never frees them
+    mesh.vertices = positions.data();
+    mesh.normals = normals.empty() ? nullptr : normals.data();
+    mesh.texcoords = texcoords.empty() ? nullptr : texcoords.data();
+    mesh.colors = (unsigned char *)src.colors;
+    UploadMesh(&mesh, false);
+    mesh.vertices = nullptr;
+    mesh.normals = nullptr;
+    mesh.texcoords = nullptr;
+    mesh.colors = nullptr;
+}
+
+Model modelFromBaked(const BakedModel &baked, bool quantized, std::vector<MeshDequantization> &dequantization) {
+    Model model{};
+    model.transform = MatrixIdentity();
+    model.meshCount = (int)baked.meshes.size();
+    model.meshes = (Mesh *)RL_CALLOC(model.meshCount, sizeof(Mesh));
+    model.materialCount = baked.materialCount > 0 ? baked.materialCount : 1;
+    model.materials = (Material *)RL_CALLOC(model.materialCount, sizeof(Material));
+    for (int m = 0; m < model.materialCount; ++m) model.materials[m] = LoadMaterialDefault();
+    model.meshMaterial = (int *)RL_CALLOC(model.meshCount, sizeof(int));
+
+    dequantization.clear();
+    for (int i = 0; i < model.meshCount; ++i) {
+        const BakedMesh &src = baked.meshes[i];
+        Mesh &mesh = model.meshes[i];
+        mesh.vertexCount = src.vertexCount;
+        mesh.triangleCount = src.triangleCount;
+        mesh.indices = src.indices ? copyIndices(src.indices, src.triangleCount) : nullptr;
+        if (quantized) {
+            uploadQuantized(mesh, src);
+            dequantization.push_back({{src.positionOffset[0], src.positionOffset[1], src.positionOffset[2]},
+                                      {src.positionScale[0], src.positionScale[1], src.positionScale[2]}});
+        } else {
+            uploadExpanded(mesh, src);
+        }
+        model.meshMaterial[i] = baked.materialCount > 0 ? src.materialIndex : 0;
+    }
+    return model;
+}
+
+// A VAO over base's vertex buffers plus a new index buffer (none for unindexed meshes). The
+// other vboId slots are copied so raylib's non-VAO fallback path can still bind them, but
+// only slot 6 is ours.
+static Mesh lodMesh(const Mesh &base, const unsigned short *indices, int triangleCount, bool quantized) {
+    Mesh mesh{};
+    mesh.vertexCount = base.vertexCount;
+    mesh.triangleCount = triangleCount;
+    mesh.indices = indices ? copyIndices(indices, triangleCount) : nullptr;
+    mesh.vboId = (unsigned int *)RL_CALLOC(kMeshVertexBuffers, sizeof(unsigned int));
+    for (int b = 0; b < kIndexBufferSlot; ++b) mesh.vboId[b] = base.vboId[b];
+    mesh.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(mesh.vaoId);
+    bindVertexStreams(mesh.vboId, quantized);
+    if (mesh.indices) {
+        mesh.vboId[kIndexBufferSlot] = rlLoadVertexBufferElement(mesh.indices, triangleCount * 3 * sizeof(unsigned short), false);
+    }
+    rlDisableVertexArray();
+    return mesh;
+}
+
+int lodModelsFromBaked(const BakedModel &baked, const Model &base, bool quantized, Model *lods) {
+    int levels = 0;
+    for (const BakedMesh &m : baked.meshes) levels = std::max(levels, m.lodCount);
+    levels = std::min(levels, kMaxModelLods - 1);
+    for (int l = 0; l < levels; ++l) {
+        Model &lod = lods[l];
+        lod = base;
+        lod.meshes = (Mesh *)RL_CALLOC(base.meshCount, sizeof(Mesh));
+        for (int i = 0; i < base.meshCount; ++i) {
+            const BakedMesh &src = baked.meshes[i];
+            const int level = std::min(l, src.lodCount - 1);
+            if (level < 0) lod.meshes[i] = lodMesh(base.meshes[i], src.indices, src.triangleCount, quantized);
+            else lod.meshes[i] = lodMesh(base.meshes[i], src.lodIndices[level], src.lodTriangleCount[level], quantized);
+        }
+    }
+    return levels;
+}
+
+void unloadLodModel(Model &lod) {
+    for (int i = 0; i < lod.meshCount; ++i) {
+        Mesh &mesh = lod.meshes[i];
+        rlUnloadVertexArray(mesh.vaoId);
+        if (mesh.vboId[kIndexBufferSlot]) rlUnloadVertexBuffer(mesh.vboId[kIndexBufferSlot]);
+        RL_FREE(mesh.vboId);
+        RL_FREE(mesh.indices);
+    }
+    RL_FREE(lod.meshes);
+    lod = Model{};
+}
+
+// The cache stores geometry only: give the baked model the glTF's base colors and textures,
+// loaded here and owned by the model the way LoadModel's are
+static void loadGltfMaterials(Model &model, const std::string &gltfPath) {
+    std::vector<GltfMaterial> materials;
+    if (!readGltfMaterials(gltfPath, materials)) return;
+    for (size_t i = 0; i < materials.size() && (int)i + 1 < model.materialCount; ++i) {
+        const GltfMaterial &src = materials[i];
+        MaterialMap &albedo = model.materials[i + 1].maps[MATERIAL_MAP_ALBEDO];
+        unsigned char c[4];
+        for (int k = 0; k < 4; ++k) c[k] = (unsigned char)(std::min(std::max(src.baseColorFactor[k], 0.0f), 1.0f) * 255.0f + 0.5f);
+        albedo.color = {c[0], c[1], c[2], c[3]};
+        if (!src.baseColorPath.empty()) {
+            Texture2D texture = LoadTexture(src.baseColorPath.c_str());
+            if (texture.id != 0) albedo.texture = texture;
+        }
+    }
+}
+
+Model loadCharacterModel(const std::string &gltfPath, bool *fromCache) {
+    if (fromCache) *fromCache = false;
+    std::string cachePath = bakedModelPath(gltfPath);
+    MappedFile file;
+    if (file.open(cachePath.c_str())) {
+        BakedModel baked;
+        if (parseBakedModel(file.data(), file.size(), baked) && baked.sourceStamp == modelSourceStamp(gltfPath)) {
+            if (fromCache) *fromCache = true;
+            std::vector<MeshDequantization> dequantization;
+            Model model = modelFromBaked(baked, false, dequantization);
+            loadGltfMaterials(model, gltfPath);
+            return model;
+        }
+        TraceLog(LOG_WARNING, "MODEL: Cache %s is stale or invalid, loading glTF", cachePath.c_str());
+    }
+    return LoadModel(gltfPath.c_str());
+}
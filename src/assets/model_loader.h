@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "raylib.h"
+#include "assets/model_cache.h"
+
+// Where a quantized mesh's stored positions land in model space: offset + stored * scale.
+// The instancing shader applies it per mesh (render/instanced_models.h).
+struct MeshDequantization {
+    Vector3 positionOffset;
+    Vector3 positionScale;
+};
+
+// Builds a raylib Model from baked streams and uploads them to the GPU; nothing on the CPU
+// side points into `baked` afterwards, so it may be a mapping that is closed right after
+// this returns. Indices are copied: raylib only draws indexed when mesh.indices is set.
+// With `quantized` the compact streams go to the GPU as stored and only the instancing
+// shader can draw the model; `dequantization` receives each mesh's position mapping.
+// Otherwise they are decoded to floats for raylib's default shader. Materials are raylib
+// defaults in the glTF's slots; the caller binds colors and textures.
+Model modelFromBaked(const BakedModel &baked, bool quantized, std::vector<MeshDequantization> &dequantization);
+
+// Simplified levels of a model built by modelFromBaked (same `quantized`): lods[l - 1] is
+// LOD l, drawing the base model's vertex buffers with its own index buffers and sharing its
+// materials. Meshes with fewer levels repeat their coarsest one. Returns how many levels
+// were written.
+int lodModelsFromBaked(const BakedModel &baked, const Model &base, bool quantized, Model *lods);
+
+// Frees what lodModelsFromBaked created; the vertex buffers and materials stay with the base.
+void unloadLodModel(Model &lod);
+
+// Loads a character model, preferring the baked cache next to the glTF and falling back
+// to raylib's glTF loader when the cache is missing, corrupt or stale. Either way the glTF's
+// materials are bound.
+Model loadCharacterModel(const std::string &gltfPath, bool *fromCache);
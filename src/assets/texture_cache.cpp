@@ -0,0 +1,70 @@
+#include "assets/texture_cache.h"
+
+#include <cstring>
+#include <filesystem>
+#include "assets/cache_io.h"
+
+namespace fs = std::filesystem;
+
+std::string bakedTexturePath(const std::string &pngPath) {
+    return fs::path(pngPath).replace_extension(".ebtex").string();
+}
+
+uint64_t textureSourceStamp(const std::string &pngPath) {
+    uint64_t hash = stampFileSize(kFnvOffsetBasis, pngPath);
+    return stampFileContents(hash, pngPath);
+}
+
+bool writeBakedTexture(const std::string &path, const BakedTexture &texture) {
+    TextureCacheHeader header{};
+    header.magic = kTextureCacheMagic;
+    header.version = kTextureCacheVersion;
+    header.sourceStamp = texture.sourceStamp;
+    header.format = (uint32_t)texture.format;
+    header.mipCount = (uint32_t)texture.mips.size();
+
+    std::vector<TextureCacheMip> table(texture.mips.size());
+    uint64_t offset = sizeof(TextureCacheHeader) + sizeof(TextureCacheMip) * table.size();
+    offset = (offset + 15) & ~(uint64_t)15;
+    for (size_t i = 0; i < table.size(); ++i) {
+        table[i].width = (uint32_t)texture.mips[i].width;
+        table[i].height = (uint32_t)texture.mips[i].height;
+        table[i].offset = offset;
+        table[i].size = texture.mips[i].size;
+        offset += texture.mips[i].size;     // no padding: the chain must stay contiguous
+    }
+
+    std::vector<unsigned char> blob(offset, 0);
+    std::memcpy(blob.data(), &header, sizeof(header));
+    std::memcpy(blob.data() + sizeof(header), table.data(), sizeof(TextureCacheMip) * table.size());
+    for (size_t i = 0; i < table.size(); ++i) {
+        std::memcpy(&blob[table[i].offset], texture.mips[i].data, texture.mips[i].size);
+    }
+    return writeFileAtomic(path, blob.data(), blob.size());
+}
+
+bool parseBakedTexture(const unsigned char *data, size_t size, BakedTexture &out) {
+    if (!data || size < sizeof(TextureCacheHeader)) return false;
+    TextureCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kTextureCacheMagic || header.version != kTextureCacheVersion) return false;
+    if (header.format != (uint32_t)TextureCacheFormat::BC1 && header.format != (uint32_t)TextureCacheFormat::BC3) return false;
+    if (header.mipCount == 0 || sizeof(TextureCacheHeader) + (uint64_t)header.mipCount * sizeof(TextureCacheMip) > size) return false;
+
+    out = BakedTexture{};
+    out.sourceStamp = header.sourceStamp;
+    out.format = (TextureCacheFormat)header.format;
+    out.mips.resize(header.mipCount);
+    const uint64_t blockBytes = (out.format == TextureCacheFormat::BC1) ? 8 : 16;
+    const TextureCacheMip *table = (const TextureCacheMip *)(data + sizeof(TextureCacheHeader));
+    for (uint32_t i = 0; i < header.mipCount; ++i) {
+        const TextureCacheMip &e = table[i];
+        if (e.width < 4 || e.height < 4 || e.width % 4 != 0 || e.height % 4 != 0) return false;
+        if (e.size != (uint64_t)(e.width / 4) * (e.height / 4) * blockBytes) return false;
+        if (e.offset + e.size > size) return false;
+        // Levels must follow each other so a tier can be handed to the GPU as one block
+        if (i > 0 && e.offset != table[i - 1].offset + table[i - 1].size) return false;
+        out.mips[i] = {(int)e.width, (int)e.height, data + e.offset, (size_t)e.size};
+    }
+    return true;
+}
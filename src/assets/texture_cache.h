@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Baked texture cache (.ebtex): a full mip chain of BC1/BC3 (DXT1/DXT5) blocks written by
+// epiCBattle_texbake, stored largest level first and contiguous so it matches raylib's
+// Image layout for compressed mipmapped data. Resolution tiers are suffixes of the chain:
+// tier N starts at mip N, so dropping quality never needs a second copy of the texture.
+//
+// Layout: TextureCacheHeader, mipCount TextureCacheMip entries, then the block data.
+
+constexpr uint32_t kTextureCacheMagic = 0x58544245;     // "EBTX"
+constexpr uint32_t kTextureCacheVersion = 1;
+
+enum class TextureCacheFormat : uint32_t { BC1 = 1, BC3 = 3 };
+
+struct TextureCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceStamp;       // textureSourceStamp() of the PNG at bake time
+    uint32_t format;            // TextureCacheFormat
+    uint32_t mipCount;
+};
+
+struct TextureCacheMip {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct BakedMip {
+    int width = 0;
+    int height = 0;
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+};
+
+struct BakedTexture {
+    uint64_t sourceStamp = 0;
+    TextureCacheFormat format = TextureCacheFormat::BC1;
+    std::vector<BakedMip> mips;
+};
+
+// "models/x/textures/a.png" -> "models/x/textures/a.ebtex"
+std::string bakedTexturePath(const std::string &pngPath);
+
+// File size plus every byte of the PNG, so an edit anywhere in the image invalidates the cache.
+uint64_t textureSourceStamp(const std::string &pngPath);
+
+bool writeBakedTexture(const std::string &path, const BakedTexture &texture);
+
+// Validates the blob and points out.mips into it (no copies).
+bool parseBakedTexture(const unsigned char *data, size_t size, BakedTexture &out);
@@ -0,0 +1,159 @@
+#include "assets/texture_compress.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::vector<MipLevel> buildMipChain(const uint8_t *rgba, int width, int height) {
+    std::vector<MipLevel> levels;
+    levels.push_back({width, height, std::vector<uint8_t>(rgba, rgba + (size_t)width * height * 4)});
+    for (;;) {
+        const MipLevel &src = levels.back();
+        int w = src.width / 2;
+        int h = src.height / 2;
+        if (w < 4 || h < 4 || (w % 4) != 0 || (h % 4) != 0) break;
+        MipLevel dst{w, h, std::vector<uint8_t>((size_t)w * h * 4)};
+        for (int y = 0; y < h; ++y) {
+            const uint8_t *row0 = &src.pixels[(size_t)(y * 2) * src.width * 4];
+            const uint8_t *row1 = row0 + (size_t)src.width * 4;
+            uint8_t *out = &dst.pixels[(size_t)y * w * 4];
+            for (int x = 0; x < w; ++x) {
+                for (int c = 0; c < 4; ++c) {
+                    int sum = row0[x * 8 + c] + row0[x * 8 + 4 + c] + row1[x * 8 + c] + row1[x * 8 + 4 + c];
+                    out[x * 4 + c] = (uint8_t)((sum + 2) / 4);
+                }
+            }
+        }
+        levels.push_back(std::move(dst));
+    }
+    return levels;
+}
+
+bool imageHasAlpha(const uint8_t *rgba, int width, int height) {
+    const size_t count = (size_t)width * height;
+    for (size_t i = 0; i < count; ++i) {
+        if (rgba[i * 4 + 3] != 255) return true;
+    }
+    return false;
+}
+
+static uint16_t to565(int r, int g, int b) {
+    return (uint16_t)(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+}
+
+static void from565(uint16_t c, int out[3]) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+static void fetchBlock(const uint8_t *rgba, int width, int bx, int by, uint8_t block[16][4]) {
+    for (int y = 0; y < 4; ++y) {
+        std::memcpy(block[y * 4], &rgba[((size_t)(by * 4 + y) * width + bx * 4) * 4], 16);
+    }
+}
+
+static void put16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+
+// Bounding-box endpoints inset by 1/16 of the range, then nearest-palette indices.
+static void encodeColorBlock(const uint8_t block[16][4], uint8_t *out) {
+    int mn[3] = {255, 255, 255}, mx[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            mn[c] = std::min(mn[c], (int)block[i][c]);
+            mx[c] = std::max(mx[c], (int)block[i][c]);
+        }
+    }
+    for (int c = 0; c < 3; ++c) {
+        int inset = (mx[c] - mn[c]) / 16;
+        mn[c] = std::min(255, mn[c] + inset);
+        mx[c] = std::max(0, mx[c] - inset);
+    }
+    uint16_t c0 = to565(mx[0], mx[1], mx[2]);
+    uint16_t c1 = to565(mn[0], mn[1], mn[2]);
+    if (c0 < c1) std::swap(c0, c1);
+    put16(out, c0);
+    put16(out + 2, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        int palette[4][3];
+        from565(c0, palette[0]);
+        from565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = 1 << 30;
+            for (int p = 0; p < 4; ++p) {
+                int dr = block[i][0] - palette[p][0], dg = block[i][1] - palette[p][1], db = block[i][2] - palette[p][2];
+                int dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist) { bestDist = dist; best = p; }
+            }
+            indices |= (uint32_t)best << (i * 2);
+        }
+    }
+    out[4] = (uint8_t)indices;
+    out[5] = (uint8_t)(indices >> 8);
+    out[6] = (uint8_t)(indices >> 16);
+    out[7] = (uint8_t)(indices >> 24);
+}
+
+// BC3 alpha: 8-level interpolation between the block's max and min alpha.
+static void encodeAlphaBlock(const uint8_t block[16][4], uint8_t *out) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = std::max(a0, (int)block[i][3]);
+        a1 = std::min(a1, (int)block[i][3]);
+    }
+    out[0] = (uint8_t)a0;
+    out[1] = (uint8_t)a1;
+    uint64_t bits = 0;
+    if (a0 != a1) {
+        int palette[8] = {a0, a1};
+        for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = 1 << 30;
+            for (int p = 0; p < 8; ++p) {
+                int d = std::abs((int)block[i][3] - palette[p]);
+                if (d < bestDist) { bestDist = d; best = p; }
+            }
+            bits |= (uint64_t)best << (i * 3);
+        }
+    }
+    for (int b = 0; b < 6; ++b) out[2 + b] = (uint8_t)(bits >> (b * 8));
+}
+
+void compressBC1(const uint8_t *rgba, int width, int height, uint8_t *out) {
+    uint8_t block[16][4];
+    for (int by = 0; by < height / 4; ++by) {
+        for (int bx = 0; bx < width / 4; ++bx) {
+            fetchBlock(rgba, width, bx, by, block);
+            encodeColorBlock(block, out);
+            out += 8;
+        }
+    }
+}
+
+void compressBC3(const uint8_t *rgba, int width, int height, uint8_t *out) {
+    uint8_t block[16][4];
+    for (int by = 0; by < height / 4; ++by) {
+        for (int bx = 0; bx < width / 4; ++bx) {
+            fetchBlock(rgba, width, bx, by, block);
+            encodeAlphaBlock(block, out);
+            encodeColorBlock(block, out + 8);
+            out += 16;
+        }
+    }
+}
+
+void compressMipChain(std::vector<MipLevel> &levels, bool useAlpha) {
+    for (auto &level : levels) {
+        size_t blocks = (size_t)(level.width / 4) * (level.height / 4);
+        std::vector<uint8_t> packed(blocks * (useAlpha ? 16 : 8));
+        if (useAlpha) compressBC3(level.pixels.data(), level.width, level.height, packed.data());
+        else compressBC1(level.pixels.data(), level.width, level.height, packed.data());
+        level.pixels = std::move(packed);
+    }
+}
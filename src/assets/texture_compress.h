@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// CPU texture processing for the offline texture bake: box-filtered mip chains and
+// BC1/BC3 (DXT1/DXT5) block compression of RGBA8 images.
+
+struct MipLevel {
+    int width;
+    int height;
+    std::vector<uint8_t> pixels;    // RGBA8, or compressed blocks after compressMipChain
+};
+
+// Builds level 0 from rgba and halves down while both dimensions stay multiples of 4,
+// so every level is a whole number of 4x4 blocks.
+std::vector<MipLevel> buildMipChain(const uint8_t *rgba, int width, int height);
+
+bool imageHasAlpha(const uint8_t *rgba, int width, int height);
+
+// width and height must be multiples of 4. Output is 8 (BC1) or 16 (BC3) bytes per block.
+void compressBC1(const uint8_t *rgba, int width, int height, uint8_t *out);
+void compressBC3(const uint8_t *rgba, int width, int height, uint8_t *out);
+
+// Replaces each level's RGBA pixels with BC1 (useAlpha false) or BC3 blocks.
+void compressMipChain(std::vector<MipLevel> &levels, bool useAlpha);
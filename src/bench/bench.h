@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Tiny benchmark harness for epiCBattle_bench. Each suite is a plain function that
+// times its cases with benchMeasure and prints one line per case. Inputs come from fixed
+// seeds, so runs are comparable across machines and releases.
+
+// Keeps the optimizer from discarding a computed value.
+template <typename T>
+static inline void benchKeep(const T &value) {
+    static volatile T sink;
+    sink = value;
+    (void)sink;
+}
+
+// Runs fn(i) for i in [0, iterations) after a short warm-up and returns ns per call. The
+// iterations run in kBenchBatches batches and the median batch is reported, so one
+// preemption or frequency dip does not move the number.
+constexpr int kBenchBatches = 5;
+
+template <typename Fn>
+static inline double benchMeasure(long iterations, Fn &&fn) {
+    long warmup = iterations / 10 > 0 ? iterations / 10 : 1;
+    for (long i = 0; i < warmup; ++i) fn(i);
+    long perBatch = iterations / kBenchBatches > 0 ? iterations / kBenchBatches : 1;
+    double batchNs[kBenchBatches];
+    long i = 0;
+    for (int b = 0; b < kBenchBatches; ++b) {
+        auto start = std::chrono::steady_clock::now();
+        for (long end = i + perBatch; i < end; ++i) fn(i);
+        batchNs[b] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (double)perBatch;
+    }
+    std::sort(batchNs, batchNs + kBenchBatches);
+    return batchNs[kBenchBatches / 2];
+}
+
+// Every reported case, for the --json summary
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    double nsPerOp;
+};
+
+std::vector<BenchResult> &benchResults();
+
+static inline void benchReport(const char *suite, const char *name, double nsPerOp) {
+    std::printf("%-12s %-40s %12.1f ns/op\n", suite, name, nsPerOp);
+    benchResults().push_back({suite, name, nsPerOp});
+}
+
+void benchCollision();
+void benchTick();
+void benchHits();
+void benchRollback();
+void benchReplay();
+void benchAssets();
+void benchBots();
+void benchJobs();
+void benchParticles();
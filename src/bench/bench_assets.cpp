@@ -0,0 +1,222 @@
+// CPU side of loading each character, as the client's asset workers do it, without a window:
+// reading the glTF's material list, stamping the source, mapping and validating the baked
+// .ebmdl/.ebtex, and reading the raw glTF buffers and PNGs for the uncached path. Then the
+// bakes' own work: simplifying and reordering each baked mesh as epiCBattle_bake does and,
+// when the client build provides raylib, decoding the PNGs and running them through
+// epiCBattle_texbake's mip and block compression steps. Parsing the glTF into meshes needs a
+// window (raylib uploads as it loads), so it is not here; it shows up in the client's MODEL:
+// log lines. Files are read warm from the page cache, so the cases measure parsing and
+// processing, not the disk.
+
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+#ifdef EPICBATTLE_BENCH_RAYLIB
+#include "raylib.h"
+#endif
+#include "assets/gltf_materials.h"
+#include "assets/mesh_optimize.h"
+#include "assets/mesh_simplify.h"
+#include "assets/model_cache.h"
+#include "assets/texture_cache.h"
+#include "assets/texture_compress.h"
+#include "bench/bench.h"
+#include "core/mapped_file.h"
+#include "game/characters.h"
+
+namespace fs = std::filesystem;
+
+// models/ next to the executable (client builds copy it there), else the source tree's
+static std::string assetPath(const std::string &relative) {
+    std::error_code ec;
+    if (fs::exists(relative, ec)) return relative;
+    return (fs::path(EPICBATTLE_SOURCE_DIR) / relative).generic_string();
+}
+
+// Maps the file and touches every page, which is what reading it costs once cached
+static size_t readMapped(const std::string &path) {
+    MappedFile file;
+    if (!file.open(path.c_str())) return 0;
+    unsigned sum = 0;
+    for (size_t i = 0; i < file.size(); i += 4096) sum += file.data()[i];
+    benchKeep(sum);
+    return file.size();
+}
+
+// epiCBattle_bake's LOD targets: fractions of LOD 0's indices and the error budget
+static const float kLodIndexRatio[kMaxModelLods - 1] = {0.5f, 0.2f, 0.06f};
+static const float kLodMaxError = 0.05f;
+
+// A baked mesh back in the bake's working form: float positions and LOD 0 indices
+struct BakeInput {
+    std::vector<float> positions;
+    std::vector<unsigned short> indices;
+};
+
+static BakeInput unpackBakedMesh(const BakedMesh &m) {
+    BakeInput in;
+    in.positions.resize((size_t)m.vertexCount * 3);
+    for (int v = 0; v < m.vertexCount; ++v) {
+        for (int k = 0; k < 3; ++k) in.positions[v * 3 + k] = m.positionOffset[k] + m.positions[v * 4 + k] * m.positionScale[k];
+    }
+    if (m.indices) in.indices.assign(m.indices, m.indices + (size_t)m.triangleCount * 3);
+    return in;
+}
+
+// The bake's per-mesh index work: simplified LODs, then vertex-cache and fetch order
+static size_t bakeMeshIndices(const BakeInput &in) {
+    const int vertexCount = (int)in.positions.size() / 3;
+    const int indexCount = (int)in.indices.size();
+    std::vector<unsigned short> indices = in.indices;
+    size_t total = indices.size();
+    for (int l = 0; l < kMaxModelLods - 1; ++l) {
+        int target = (int)(indexCount * kLodIndexRatio[l]) / 3 * 3;
+        std::vector<unsigned short> lod = simplifyMesh(indices.data(), indexCount, in.positions.data(), vertexCount, target, kLodMaxError);
+        optimizeVertexCache(lod.data(), (int)lod.size(), vertexCount);
+        total += lod.size();
+    }
+    optimizeVertexCache(indices.data(), indexCount, vertexCount);
+    std::vector<unsigned short> remap = vertexFetchRemap(indices.data(), indexCount, vertexCount);
+    remapIndices(indices.data(), indexCount, remap);
+    return total;
+}
+
+#ifdef EPICBATTLE_BENCH_RAYLIB
+// Same rounding as epiCBattle_texbake
+static int nearestPowerOfTwo(int v) {
+    int p = 4;
+    while (p * 2 <= v) p *= 2;
+    if (v - p > p * 2 - v) p *= 2;
+    return p;
+}
+
+// epiCBattle_texbake up to the file write: RGBA8 at power-of-two size, mips, BC1/BC3
+static size_t bakeTexture(const std::string &png) {
+    Image image = LoadImage(png.c_str());
+    if (!image.data) return 0;
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    int w = nearestPowerOfTwo(image.width);
+    int h = nearestPowerOfTwo(image.height);
+    if (w != image.width || h != image.height) ImageResize(&image, w, h);
+    const unsigned char *rgba = (const unsigned char *)image.data;
+    bool alpha = imageHasAlpha(rgba, w, h);
+    std::vector<MipLevel> levels = buildMipChain(rgba, w, h);
+    UnloadImage(image);
+    compressMipChain(levels, alpha);
+    size_t bytes = 0;
+    for (const MipLevel &level : levels) bytes += level.pixels.size();
+    return bytes;
+}
+#endif
+
+void benchAssets() {
+#ifdef EPICBATTLE_BENCH_RAYLIB
+    SetTraceLogLevel(LOG_WARNING);
+#endif
+    for (const CharacterDef &def : kCharacters) {
+        const std::string gltf = assetPath(def.gltfPath);
+        std::vector<GltfMaterial> materials;
+        if (!readGltfMaterials(gltf, materials)) {
+            std::printf("assets       %s not found\n", gltf.c_str());
+            continue;
+        }
+        std::vector<std::string> buffers;
+        std::error_code ec;
+        for (const auto &entry : fs::directory_iterator(fs::path(gltf).parent_path(), ec)) {
+            if (entry.path().extension() == ".bin") buffers.push_back(entry.path().generic_string());
+        }
+        std::vector<std::string> pngs;
+        for (const GltfMaterial &m : materials) {
+            if (!m.baseColorPath.empty() && fs::exists(m.baseColorPath, ec)) pngs.push_back(m.baseColorPath);
+        }
+
+        char name[96];
+        std::snprintf(name, sizeof(name), "gltf/materials/%s", def.name.c_str());
+        benchReport("assets", name, benchMeasure(500, [&](long) {
+            std::vector<GltfMaterial> parsed;
+            benchKeep(readGltfMaterials(gltf, parsed));
+        }));
+        std::snprintf(name, sizeof(name), "gltf/stamp/%s", def.name.c_str());
+        benchReport("assets", name, benchMeasure(500, [&](long) {
+            benchKeep(modelSourceStamp(gltf));
+        }));
+        std::snprintf(name, sizeof(name), "gltf/buffers/%s", def.name.c_str());
+        benchReport("assets", name, benchMeasure(200, [&](long) {
+            size_t bytes = 0;
+            for (const std::string &bin : buffers) bytes += readMapped(bin);
+            benchKeep(bytes);
+        }));
+        std::snprintf(name, sizeof(name), "png/read/%s", def.name.c_str());
+        benchReport("assets", name, benchMeasure(200, [&](long) {
+            size_t bytes = 0;
+            for (const std::string &png : pngs) bytes += readMapped(png) + (size_t)(textureSourceStamp(png) & 1);
+            benchKeep(bytes);
+        }));
+#ifdef EPICBATTLE_BENCH_RAYLIB
+        std::snprintf(name, sizeof(name), "png/decode/%s", def.name.c_str());
+        benchReport("assets", name, benchMeasure(20, [&](long) {
+            size_t pixels = 0;
+            for (const std::string &png : pngs) {
+                Image image = LoadImage(png.c_str());
+                pixels += (size_t)image.width * image.height;
+                UnloadImage(image);
+            }
+            benchKeep(pixels);
+        }));
+        std::snprintf(name, sizeof(name), "bake/texture/%s", def.name.c_str());
+        benchReport("assets", name, benchMeasure(5, [&](long) {
+            size_t bytes = 0;
+            for (const std::string &png : pngs) bytes += bakeTexture(png);
+            benchKeep(bytes);
+        }));
+#endif
+
+        const std::string cachePath = bakedModelPath(gltf);
+        if (fs::exists(cachePath, ec)) {
+            std::snprintf(name, sizeof(name), "cache/model/%s", def.name.c_str());
+            benchReport("assets", name, benchMeasure(500, [&](long) {
+                MappedFile file;
+                BakedModel baked;
+                benchKeep(file.open(cachePath.c_str()) && parseBakedModel(file.data(), file.size(), baked) &&
+                          baked.sourceStamp == modelSourceStamp(gltf));
+            }));
+
+            MappedFile file;
+            BakedModel baked;
+            std::vector<BakeInput> meshes;
+            if (file.open(cachePath.c_str()) && parseBakedModel(file.data(), file.size(), baked)) {
+                for (const BakedMesh &m : baked.meshes) {
+                    if (m.indices) meshes.push_back(unpackBakedMesh(m));
+                }
+            }
+            std::snprintf(name, sizeof(name), "bake/meshes/%s", def.name.c_str());
+            benchReport("assets", name, benchMeasure(5, [&](long) {
+                size_t indices = 0;
+                for (const BakeInput &in : meshes) indices += bakeMeshIndices(in);
+                benchKeep(indices);
+            }));
+        } else {
+            std::printf("assets       %s: no %s (build the bake_models target)\n", def.name.c_str(), cachePath.c_str());
+        }
+
+        std::vector<std::string> baked;
+        for (const std::string &png : pngs) {
+            if (fs::exists(bakedTexturePath(png), ec)) baked.push_back(png);
+        }
+        if (!baked.empty()) {
+            std::snprintf(name, sizeof(name), "cache/texture/%s", def.name.c_str());
+            benchReport("assets", name, benchMeasure(500, [&](long) {
+                bool ok = true;
+                for (const std::string &png : baked) {
+                    MappedFile file;
+                    BakedTexture texture;
+                    ok = file.open(bakedTexturePath(png).c_str()) && parseBakedTexture(file.data(), file.size(), texture) &&
+                         texture.sourceStamp == textureSourceStamp(png) && ok;
+                }
+                benchKeep(ok);
+            }));
+        } else if (!pngs.empty()) {
+            std::printf("assets       %s: no .ebtex (build the bake_textures target)\n", def.name.c_str());
+        }
+    }
+}
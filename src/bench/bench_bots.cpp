@@ -0,0 +1,104 @@
+// Bot navigation: building the nav grid, one complete flow-field rebuild, and BotSystem::think
+// per tick with every player a bot. think() runs over states recorded from a bot match on the
+// same map, so the case times the bots alone and not the sim tick between them. Shipped
+// desert and a generated arena with a couple of hundred obstacles, large enough to hit the
+// coarse grid cap.
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "bench/bench.h"
+#include "game/maps.h"
+#include "sim/bots.h"
+#include "sim/sim.h"
+
+static uint32_t nextRand(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static float randRange(uint32_t &state, float lo, float hi) {
+    return lo + (hi - lo) * (float)(nextRand(state) & 0xFFFFFF) / (float)0xFFFFFF;
+}
+
+// Obstacles of walking height scattered at the collision suite's density
+static MapSource makeObstacleArena(int obstacleCount, uint32_t seed) {
+    MapSource map;
+    float side = std::sqrt((float)obstacleCount) * 6.0f + 10.0f;
+    map.arenaSize = {side, 1.0f, side};
+    uint32_t rng = seed;
+    for (int i = 0; i < obstacleCount; ++i) {
+        float x = randRange(rng, -side * 0.4f, side * 0.4f);
+        float z = randRange(rng, -side * 0.4f, side * 0.4f);
+        float hx = randRange(rng, 0.3f, 1.5f);
+        float hz = randRange(rng, 0.3f, 1.5f);
+        map.obstacles.push_back({{x - hx, 0.0f, z - hz}, {x + hx, 2.0f, z + hz}});
+    }
+    return map;
+}
+
+static void benchMap(const char *label, const MapData &map) {
+    char name[96];
+    NavGrid grid;
+    buildNavGrid(grid, map);
+    std::printf("bots         %s: %dx%d cells of %.2f m\n", label, grid.cellsX, grid.cellsZ, grid.cellSize);
+    std::snprintf(name, sizeof(name), "grid/%s", label);
+    benchReport("bots", name, benchMeasure(200, [&](long) {
+        NavGrid built;
+        buildNavGrid(built, map);
+        benchKeep(built.blocked.size());
+    }));
+
+    // Opposite corners in turn, so every rebuild starts from scratch
+    const int corners[2] = {grid.cellAt(-map.arenaSize.x * 0.4f, -map.arenaSize.z * 0.4f),
+                            grid.cellAt(map.arenaSize.x * 0.4f, map.arenaSize.z * 0.4f)};
+    FlowField field;
+    std::snprintf(name, sizeof(name), "field/%s", label);
+    benchReport("bots", name, benchMeasure(200, [&](long i) {
+        field.setGoal(grid, corners[i & 1]);
+        benchKeep(field.advance(grid, INT_MAX));
+    }));
+
+    const int counts[] = {64, 200, 256};
+    const int recordTicks = 600;
+    for (int count : counts) {
+        // Ten seconds of an all-bot match; think() then replays over those states
+        std::vector<MatchState> states(recordTicks);
+        std::vector<int> characters(count, 0);
+        MatchState match;
+        resetMatch(match, map, count, characters.data());
+        std::unique_ptr<BotSystem> bots(new BotSystem);
+        bots->reset(map, count, 0, 1234u);
+        PlayerInput inputs[kMaxPlayers];
+        int fieldsInUse = 0;
+        for (int t = 0; t < recordTicks; ++t) {
+            states[t] = match;
+            bots->think(match, inputs);
+            stepMatch(match, map, inputs, kFixedDt);
+            fieldsInUse = std::max(fieldsInUse, bots->activeFields());
+        }
+        std::printf("bots         %s/%d: up to %d flow fields shared by %d bots\n", label, count, fieldsInUse, count);
+
+        bots->reset(map, count, 0, 1234u);
+        std::snprintf(name, sizeof(name), "think/%s/%d", label, count);
+        benchReport("bots", name, benchMeasure(recordTicks * 5, [&](long i) {
+            bots->think(states[i % recordTicks], inputs);
+            benchKeep(inputs[0].buttons);
+        }));
+    }
+}
+
+void benchBots() {
+    GameMap desert;
+    if (desert.open(mapFilePath("desert"))) benchMap("desert", desert.data());
+    else std::printf("bots         %s not found; run from the build directory\n", mapFilePath("desert").c_str());
+
+    GameMap generated;
+    generated.build("bench", makeObstacleArena(200, 4242u));
+    benchMap("obstacles200", generated.data());
+}
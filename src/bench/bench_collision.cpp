@@ -0,0 +1,112 @@
+// Broadphase benchmark: linear obstacle scan vs ObstacleGrid at growing obstacle counts.
+// Obstacle density is kept constant (the arena grows with the prop count), which is how
+// large custom arenas are laid out. The load cases compare building a map from its
+// obstacle list (grid construction included) against opening the baked .ebmap in place.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+#include "bench/bench.h"
+#include "game/map_file.h"
+#include "game/maps.h"
+
+static uint32_t nextRand(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static float randRange(uint32_t &state, float lo, float hi) {
+    return lo + (hi - lo) * (float)(nextRand(state) & 0xFFFFFF) / (float)0xFFFFFF;
+}
+
+static MapSource makeArena(int obstacleCount, uint32_t seed) {
+    MapSource map;
+    float side = std::sqrt((float)obstacleCount) * 6.0f + 10.0f;
+    map.arenaSize = {side, 1.0f, side};
+    uint32_t rng = seed;
+    for (int i = 0; i < obstacleCount; ++i) {
+        float x = randRange(rng, -side * 0.5f, side * 0.5f);
+        float z = randRange(rng, -side * 0.5f, side * 0.5f);
+        float hx = randRange(rng, 0.3f, 1.5f);
+        float hz = randRange(rng, 0.3f, 1.5f);
+        float h = randRange(rng, 0.5f, 2.0f);
+        map.obstacles.push_back({{x - hx, 0.0f, z - hz}, {x + hx, h, z + hz}});
+    }
+    return map;
+}
+
+void benchCollision() {
+    const int counts[] = {10, 1000, 100000};
+    for (int count : counts) {
+        const MapSource source = makeArena(count, 12345u);
+        GameMap arena;
+        arena.build("bench", source);
+        const MapData &map = arena.data();
+        const float half = map.arenaSize.x * 0.5f;
+
+        // Pre-generate query points so RNG cost is not measured
+        const int queryCount = 4096;
+        std::vector<Vec3> points(queryCount);
+        std::vector<Vec3> segEnds(queryCount);
+        uint32_t rng = 777u;
+        for (int i = 0; i < queryCount; ++i) {
+            points[i] = {randRange(rng, -half, half), randRange(rng, 0.0f, 2.0f), randRange(rng, -half, half)};
+            // Melee-length segments, like the bots' line-of-sight checks
+            segEnds[i] = {points[i].x + randRange(rng, -3.0f, 3.0f), points[i].y, points[i].z + randRange(rng, -3.0f, 3.0f)};
+        }
+
+        // Sanity: the grid must agree with the linear scan
+        int mismatches = 0;
+        for (int i = 0; i < queryCount; ++i) {
+            if (obstacleContainsPoint(map.obstacleGrid, map.obstacles, points[i]) != obstacleContainsPointLinear(map.obstacles, map.obstacleCount, points[i])) mismatches++;
+            if (obstacleBlocksSegment(map.obstacleGrid, map.obstacles, points[i], segEnds[i]) != obstacleBlocksSegmentLinear(map.obstacles, map.obstacleCount, points[i], segEnds[i])) mismatches++;
+        }
+        if (mismatches) std::printf("collision    WARNING: %d grid/linear mismatches at %d obstacles\n", mismatches, count);
+
+        long iters = count >= 100000 ? 2000 : 200000;
+        char name[64];
+        std::snprintf(name, sizeof(name), "point/linear/%d", count);
+        benchReport("collision", name, benchMeasure(iters, [&](long i) {
+            benchKeep(obstacleContainsPointLinear(map.obstacles, map.obstacleCount, points[i & (queryCount - 1)]));
+        }));
+        std::snprintf(name, sizeof(name), "point/grid/%d", count);
+        benchReport("collision", name, benchMeasure(200000, [&](long i) {
+            benchKeep(obstacleContainsPoint(map.obstacleGrid, map.obstacles, points[i & (queryCount - 1)]));
+        }));
+        std::snprintf(name, sizeof(name), "segment/linear/%d", count);
+        benchReport("collision", name, benchMeasure(iters, [&](long i) {
+            int q = i & (queryCount - 1);
+            benchKeep(obstacleBlocksSegmentLinear(map.obstacles, map.obstacleCount, points[q], segEnds[q]));
+        }));
+        std::snprintf(name, sizeof(name), "segment/grid/%d", count);
+        benchReport("collision", name, benchMeasure(200000, [&](long i) {
+            int q = i & (queryCount - 1);
+            benchKeep(obstacleBlocksSegment(map.obstacleGrid, map.obstacles, points[q], segEnds[q]));
+        }));
+
+        const std::string path = (std::filesystem::temp_directory_path() / "epicbattle_bench.ebmap").string();
+        if (!writeMapFile(path, source)) {
+            std::printf("collision    could not write %s\n", path.c_str());
+            continue;
+        }
+        long loads = count >= 100000 ? 20 : 2000;
+        std::snprintf(name, sizeof(name), "load/build/%d", count);
+        benchReport("collision", name, benchMeasure(loads, [&](long) {
+            GameMap built;
+            built.build("bench", source);
+            benchKeep(built.data().obstacleGrid.cellsX);
+        }));
+        std::snprintf(name, sizeof(name), "load/mapped/%d", count);
+        benchReport("collision", name, benchMeasure(loads, [&](long) {
+            GameMap mapped;
+            mapped.open(path);
+            benchKeep(mapped.data().obstacleGrid.cellsX);
+        }));
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+}
@@ -0,0 +1,74 @@
+// Hit resolution benchmark: every player in a dense crowd attacks on the same tick.
+// Compares the spatial-hash batch against the pairwise reference.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "bench/bench.h"
+#include "sim/hit_query.h"
+
+static void makeCrowd(MatchState &match, const MapData &map, int count, uint32_t seed) {
+    std::vector<int> characters(count, 0);
+    resetMatch(match, map, count, characters.data());
+    ServerState &s = match.server;
+    uint32_t rng = seed;
+    auto next = [&]() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; };
+    // Roughly 4 square units per fighter: a crowded brawl
+    float side = std::sqrt((float)count * 4.0f);
+    for (int i = 0; i < count; ++i) {
+        s.posX[i] = ((float)(next() % 10000) / 10000.0f - 0.5f) * side;
+        s.posZ[i] = ((float)(next() % 10000) / 10000.0f - 0.5f) * side;
+        s.posY[i] = 0.0f;
+        s.yawRadians[i] = (float)(next() % 6283) / 1000.0f;
+    }
+}
+
+static void queueAllAttacks(const ServerState &s, HitBatch &batch) {
+    batch.attackCount = 0;
+    for (int i = 0; i < s.playerCount; ++i) {
+        batch.attacks[batch.attackCount++] = {i, (i % 3 == 0) ? &kHeavyAttack : &kLightAttack};
+    }
+}
+
+void benchHits() {
+    MapSource source;
+    source.arenaSize = {200.0f, 1.0f, 200.0f};
+    GameMap arena;
+    arena.build("open field", source);
+    const MapData &map = arena.data();
+    const int counts[] = {2, 16, 48, 64, 256};   // 48: about where the hash starts to pay
+    static MatchState base;
+    static MatchState work;
+    static HitBatch batch;
+    static HitBatch reference;
+    for (int count : counts) {
+        makeCrowd(base, map, count, 4242u);
+
+        // Sanity: both paths must produce the same hits in the same order
+        work = base;
+        queueAllAttacks(work.server, batch);
+        resolveAttacks(work.server, batch);
+        work = base;
+        queueAllAttacks(work.server, reference);
+        resolveAttacksBruteForce(work.server, reference);
+        if (batch.hitCount != reference.hitCount || std::memcmp(batch.hits, reference.hits, sizeof(HitEvent) * batch.hitCount) != 0) {
+            std::printf("hits         WARNING: hash/pairwise mismatch at %d players\n", count);
+        }
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "batch/hash/%d (%d hits)", count, batch.hitCount);
+        benchReport("hits", name, benchMeasure(5000, [&](long) {
+            work.server = base.server;
+            queueAllAttacks(work.server, batch);
+            resolveAttacks(work.server, batch);
+        }));
+        std::snprintf(name, sizeof(name), "batch/pairwise/%d", count);
+        benchReport("hits", name, benchMeasure(5000, [&](long) {
+            work.server = base.server;
+            queueAllAttacks(work.server, batch);
+            resolveAttacksBruteForce(work.server, batch);
+        }));
+    }
+}
@@ -0,0 +1,132 @@
+// Job system scaling: the 256-player tick, a line-of-sight pass over every pair of players
+// (the shape of per-fighter visibility work), and a small frame graph running both side by
+// side, each at 1, 2, 4, 8 and 16 threads. On a generated arena with a couple of hundred
+// obstacles so collision and segment queries carry real weight. The tick is also checked
+// to come out bit for bit the same at every thread count.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "bench/bench.h"
+#include "core/job_system.h"
+#include "game/maps.h"
+#include "game/obstacle_grid.h"
+#include "sim/sim.h"
+
+static uint32_t nextRand(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static float randRange(uint32_t &state, float lo, float hi) {
+    return lo + (hi - lo) * (float)(nextRand(state) & 0xFFFFFF) / (float)0xFFFFFF;
+}
+
+// Obstacles of walking height scattered at the collision suite's density
+static MapSource makeObstacleArena(int obstacleCount, uint32_t seed) {
+    MapSource map;
+    float side = std::sqrt((float)obstacleCount) * 6.0f + 10.0f;
+    map.arenaSize = {side, 1.0f, side};
+    uint32_t rng = seed;
+    for (int i = 0; i < obstacleCount; ++i) {
+        float x = randRange(rng, -side * 0.4f, side * 0.4f);
+        float z = randRange(rng, -side * 0.4f, side * 0.4f);
+        float hx = randRange(rng, 0.3f, 1.5f);
+        float hz = randRange(rng, 0.3f, 1.5f);
+        map.obstacles.push_back({{x - hx, 0.0f, z - hz}, {x + hx, 2.0f, z + hz}});
+    }
+    return map;
+}
+
+// Visible opponents per player, from eye height, over [begin, end)
+static void lineOfSight(const MapData &map, const ServerState &s, int visible[], int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        const Vec3 eye = {s.posX[i], s.posY[i] + 1.6f, s.posZ[i]};
+        int seen = 0;
+        for (int j = 0; j < s.playerCount; ++j) {
+            if (j == i) continue;
+            const Vec3 other = {s.posX[j], s.posY[j] + 1.6f, s.posZ[j]};
+            seen += obstacleBlocksSegment(map.obstacleGrid, map.obstacles, eye, other) ? 0 : 1;
+        }
+        visible[i] = seen;
+    }
+}
+
+void benchJobs() {
+    GameMap arena;
+    arena.build("bench", makeObstacleArena(200, 4242u));
+    const MapData &map = arena.data();
+    const int players = kMaxPlayers;
+
+    // 64 ticks worth of inputs per player, replayed cyclically
+    const int inputTicks = 64;
+    std::vector<PlayerInput> inputs((size_t)inputTicks * players);
+    uint32_t rng = 99u;
+    for (auto &in : inputs) {
+        nextRand(rng);
+        in.moveX = (int8_t)((int)(rng % 3) - 1);
+        in.moveZ = (int8_t)((int)((rng >> 4) % 3) - 1);
+        in.buttons = (uint8_t)(((rng >> 8) % 32 == 0 ? kButtonJump : 0) | ((rng >> 16) % 4 == 0 ? kButtonSprint : 0));
+    }
+    std::vector<int> characters(players, 0);
+    static MatchState start;
+    resetMatch(start, map, players, characters.data());
+
+    const int threadCounts[] = {1, 2, 4, 8, 16};
+    std::printf("jobs         %u hardware threads\n", std::thread::hardware_concurrency());
+    uint64_t reference = 0;
+    bool identical = true;
+    for (int threads : threadCounts) {
+        JobSystem jobs(threads);
+        char name[64];
+
+        // Same ticks at every thread count must land on the same state
+        static MatchState match;
+        match = start;
+        for (int t = 0; t < 300; ++t) stepMatch(match, map, &inputs[(size_t)(t % inputTicks) * players], kFixedDt, &jobs);
+        const uint64_t checksum = matchChecksum(match);
+        if (threads == threadCounts[0]) reference = checksum;
+        identical = identical && checksum == reference;
+
+        match = start;
+        std::snprintf(name, sizeof(name), "tick/%d/threads/%d", players, threads);
+        benchReport("jobs", name, benchMeasure(2000, [&](long i) {
+            stepMatch(match, map, &inputs[(size_t)(i % inputTicks) * players], kFixedDt, &jobs);
+        }));
+
+        std::vector<int> visible(players, 0);
+        std::snprintf(name, sizeof(name), "sight/%d/threads/%d", players, threads);
+        benchReport("jobs", name, benchMeasure(50, [&](long) {
+            jobs.parallelFor(players, 8, [&](int begin, int end) { lineOfSight(map, match.server, visible.data(), begin, end); });
+            benchKeep(visible[0]);
+        }));
+
+        // A frame: the tick, and the sight pass over the state it started from, run side by
+        // side and feed a reduction
+        static MatchState previous;
+        std::vector<int> lastVisible(players, 0);
+        int total = 0;
+        JobGraph frame;
+        const int tick = frame.add("tick", [&]() {
+            stepMatch(match, map, &inputs[0], kFixedDt, &jobs);
+        });
+        const int sight = frame.add("sight", [&]() {
+            jobs.parallelFor(players, 8, [&](int begin, int end) { lineOfSight(map, previous.server, lastVisible.data(), begin, end); });
+        });
+        frame.add("total", [&]() {
+            total = 0;
+            for (int v : lastVisible) total += v;
+        }, {tick, sight});
+        std::snprintf(name, sizeof(name), "graph/%d/threads/%d", players, threads);
+        benchReport("jobs", name, benchMeasure(50, [&](long) {
+            previous = match;
+            frame.run(jobs);
+            benchKeep(total);
+        }));
+    }
+    std::printf("jobs         tick state %s across thread counts\n", identical ? "identical" : "DIFFERS");
+}
@@ -0,0 +1,115 @@
+// epiCBattle_bench: micro- and macro-benchmarks for the simulation core.
+// Usage: epiCBattle_bench [--json out.json] [suite...]   (no suites runs every suite)
+//
+// --json writes every case as {"suite", "name", "nsPerOp"} plus what the numbers depend on
+// (compiler, optimization, SIMD width, cores), for tracking regressions across releases.
+// "-" writes it to stdout after the table.
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include "bench/bench.h"
+#include "core/simd.h"
+
+struct BenchSuite {
+    const char *name;
+    void (*run)();
+};
+
+static const BenchSuite kSuites[] = {
+    {"collision", benchCollision},
+    {"tick", benchTick},
+    {"hits", benchHits},
+    {"rollback", benchRollback},
+    {"replay", benchReplay},
+    {"assets", benchAssets},
+    {"bots", benchBots},
+    {"jobs", benchJobs},
+    {"particles", benchParticles},
+};
+
+std::vector<BenchResult> &benchResults() {
+    static std::vector<BenchResult> results;
+    return results;
+}
+
+static std::string jsonString(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char)c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+static bool writeJson(const char *path) {
+    FILE *f = std::strcmp(path, "-") == 0 ? stdout : std::fopen(path, "w");
+    if (!f) return false;
+#if defined(NDEBUG)
+    const bool optimized = true;
+#else
+    const bool optimized = false;
+#endif
+#if defined(__clang__)
+    const char *compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    const char *compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    const char *compiler = "MSVC " _CRT_STRINGIZE(_MSC_VER);
+#else
+    const char *compiler = "unknown";
+#endif
+    std::fprintf(f, "{\n  \"schema\": 1,\n  \"timestamp\": %lld,\n  \"compiler\": %s,\n  \"optimized\": %s,\n",
+                 (long long)std::time(nullptr), jsonString(compiler).c_str(), optimized ? "true" : "false");
+    std::fprintf(f, "  \"simdLanes\": %d,\n  \"hardwareThreads\": %u,\n  \"results\": [", kSimdWidth, std::thread::hardware_concurrency());
+    const std::vector<BenchResult> &results = benchResults();
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::fprintf(f, "%s\n    {\"suite\": %s, \"name\": %s, \"nsPerOp\": %.1f}", i ? "," : "", jsonString(results[i].suite).c_str(),
+                     jsonString(results[i].name).c_str(), results[i].nsPerOp);
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    bool ok = !std::ferror(f);
+    if (f != stdout) ok = std::fclose(f) == 0 && ok;
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    const char *jsonPath = nullptr;
+    std::vector<const char *> selected;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else selected.push_back(argv[i]);
+    }
+
+    int ran = 0;
+    for (const auto &suite : kSuites) {
+        bool run = selected.empty();
+        for (const char *name : selected) {
+            if (std::strcmp(name, suite.name) == 0) run = true;
+        }
+        if (!run) continue;
+        suite.run();
+        ++ran;
+    }
+    if (ran == 0) {
+        std::fprintf(stderr, "no matching suite; available:");
+        for (const auto &suite : kSuites) std::fprintf(stderr, " %s", suite.name);
+        std::fprintf(stderr, "\n");
+        return 2;
+    }
+    if (jsonPath && !writeJson(jsonPath)) {
+        std::fprintf(stderr, "could not write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
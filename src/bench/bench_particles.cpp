@@ -0,0 +1,55 @@
+// Particle pools at 1k/10k/100k live particles: the SIMD update alone (dt 0, so nothing
+// expires and the count holds), packing instance matrices for the draw, and a whole 120 Hz
+// frame of both with bursts topping the pools back up. The budget is 100k under 1 ms.
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "bench/bench.h"
+#include "render/particles.h"
+
+static const ParticleEmitter kEmitterOrder[kParticleEmitterCount] = {
+    ParticleEmitter::Spark, ParticleEmitter::Dust, ParticleEmitter::Burst};
+
+// Bursts spread over the arena until live reaches target
+static void topUp(ParticleSystem &particles, int target, long &seed) {
+    while (particles.liveCount() < target) {
+        const ParticleEmitter emitter = kEmitterOrder[seed % kParticleEmitterCount];
+        const Vec3 origin = {(float)(seed % 37) - 18.0f, 1.0f, (float)(seed % 29) - 14.0f};
+        particles.emit(emitter, origin, std::min(400, target - particles.liveCount()));
+        seed++;
+    }
+}
+
+void benchParticles() {
+    const int counts[] = {1000, 10000, 100000};
+    std::vector<float> instances((size_t)kMaxParticlesPerEmitter * kParticleInstanceFloats);
+    for (int count : counts) {
+        std::unique_ptr<ParticleSystem> particles(new ParticleSystem);
+        long seed = 1;
+        topUp(*particles, count, seed);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "update/%d", count);
+        benchReport("particles", name, benchMeasure(500, [&](long) {
+            particles->update(0.0f);
+            benchKeep(particles->liveCount());
+        }));
+
+        std::snprintf(name, sizeof(name), "instances/%d", count);
+        benchReport("particles", name, benchMeasure(500, [&](long) {
+            int written = 0;
+            for (ParticleEmitter emitter : kEmitterOrder) written += particles->writeInstances(emitter, instances.data());
+            benchKeep(written);
+        }));
+
+        std::snprintf(name, sizeof(name), "frame/%d", count);
+        benchReport("particles", name, benchMeasure(500, [&](long) {
+            topUp(*particles, count, seed);
+            particles->update(1.0f / 120.0f);
+            int written = 0;
+            for (ParticleEmitter emitter : kEmitterOrder) written += particles->writeInstances(emitter, instances.data());
+            benchKeep(written);
+        }));
+    }
+}
@@ -0,0 +1,91 @@
+// Recorded-match replay: a one-minute match with a reproducible random input stream is
+// recorded once, then the cases time what a replay costs: writing and reading the .ebrp,
+// and playing it back tick by tick with checksum verification (per tick, so player
+// counts compare directly with the tick suite).
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+#include "bench/bench.h"
+#include "sim/replay.h"
+#include "sim/sim.h"
+
+static void recordMatch(const MapData &map, const std::string &mapName, int count, int ticks, Replay &out) {
+    static MatchState match;
+    std::vector<int> characters(count, 0);
+    resetMatch(match, map, count, characters.data());
+    ReplayRecorder rec;
+    beginReplay(rec, mapName, match);
+    std::vector<PlayerInput> inputs(count);
+    uint32_t rng = 4242u;
+    for (int t = 0; t < ticks && !match.matchOver; ++t) {
+        for (auto &in : inputs) {
+            // Inputs held for a few ticks at a time, the way people play, so the RLE streams are realistic
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            if (rng % 6 != 0) continue;
+            in = PlayerInput{};
+            in.moveX = (int8_t)((int)((rng >> 4) % 3) - 1);
+            in.moveZ = (int8_t)((int)((rng >> 8) % 3) - 1);
+            uint32_t b = (rng >> 12) % 16;
+            in.buttons = (uint8_t)((b == 0 ? kButtonJump : 0) | (b == 1 ? kButtonLight : 0) | (b == 2 ? kButtonHeavy : 0) | ((rng >> 20) % 4 == 0 ? kButtonSprint : 0));
+        }
+        stepMatch(match, map, inputs.data(), kFixedDt);
+        recordReplayTick(rec, inputs.data(), match);
+    }
+    finishReplay(rec, match);
+    out = rec.replay;
+}
+
+// Plays the whole replay; false on a desync
+static bool playBack(const Replay &replay, const MapData &map) {
+    static MatchState match;
+    resetMatch(match, map, replay.playerCount, replay.characterIndex);
+    ReplayCursor cursor;
+    startReplay(cursor, replay);
+    PlayerInput inputs[kMaxPlayers];
+    bool ok = true;
+    while (nextReplayTick(cursor, inputs)) {
+        stepMatch(match, map, inputs, replay.tickDt());
+        ok = checkReplayTick(cursor, match) && ok;
+    }
+    return ok && cursor.tick == replay.tickCount;
+}
+
+void benchReplay() {
+    GameMap arena;
+    if (!arena.open(mapFilePath("desert"))) {
+        std::printf("replay       %s not found; run from the build directory\n", mapFilePath("desert").c_str());
+        return;
+    }
+    const MapData &map = arena.data();
+    const int counts[] = {2, 64, 256};
+    const int kTicks = 60 * 60;
+    const std::string path = (std::filesystem::temp_directory_path() / "epicbattle_bench.ebrp").string();
+    for (int count : counts) {
+        Replay replay;
+        recordMatch(map, "desert", count, kTicks, replay);
+        size_t bytes = 0;
+        for (const auto &stream : replay.streams) bytes += stream.size();
+        std::printf("replay       %d players: %u ticks, %zu input bytes, %zu checksums\n", count, replay.tickCount, bytes, replay.checksums.size());
+        if (!playBack(replay, map)) std::printf("replay       WARNING: playback desynced at %d players\n", count);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "save/players/%d", count);
+        benchReport("replay", name, benchMeasure(200, [&](long) {
+            benchKeep(saveReplay(path, replay));
+        }));
+        std::snprintf(name, sizeof(name), "load/players/%d", count);
+        benchReport("replay", name, benchMeasure(200, [&](long) {
+            Replay loaded;
+            benchKeep(loadReplay(path, loaded));
+        }));
+        std::snprintf(name, sizeof(name), "playback/tick/players/%d", count);
+        const long passes = count >= 256 ? 5 : 10;
+        benchReport("replay", name, benchMeasure(passes, [&](long) {
+            benchKeep(playBack(replay, map));
+        }) / (double)(replay.tickCount > 0 ? replay.tickCount : 1));
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
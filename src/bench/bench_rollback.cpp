@@ -0,0 +1,78 @@
+// Worst-case rollback cost per frame: a misprediction kRollbackMaxTicks back forces a state
+// restore plus kRollbackMaxTicks re-simulated ticks, on top of the frame's own tick.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "bench/bench.h"
+#include "sim/rollback.h"
+#include "sim/sim.h"
+
+void benchRollback() {
+    GameMap arena;
+    if (!arena.open(mapFilePath("desert"))) {
+        std::printf("rollback     %s not found; run from the build directory\n", mapFilePath("desert").c_str());
+        return;
+    }
+    const MapData &map = arena.data();
+    const int counts[] = {2, 64, 256};
+    std::printf("rollback     MatchState: %zu bytes, window %d ticks\n", sizeof(MatchState), kRollbackMaxTicks);
+    for (int count : counts) {
+        static MatchState match;
+        static MatchState saved;
+        std::vector<int> characters(count, 0);
+        resetMatch(match, map, count, characters.data());
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "save+restore/players/%d", count);
+        benchReport("rollback", name, benchMeasure(200000, [&](long) {
+            std::memcpy(&saved, &match, sizeof(MatchState));
+            std::memcpy(&match, &saved, sizeof(MatchState));
+            benchKeep(match.server.posX[0]);
+        }));
+
+        // Every player walks and swings. Player 1 runs kRollbackMaxTicks behind and alternates
+        // direction every tick, so its late input never matches the held-input prediction and
+        // every frame rolls back the full window.
+        std::unique_ptr<RollbackSession> rb(new RollbackSession);
+        resetMatch(match, map, count, characters.data());
+        startRollback(*rb, match);
+        auto inputFor = [](uint32_t tick, int p) {
+            PlayerInput in;
+            uint32_t h = (tick * 2654435761u) ^ ((uint32_t)p * 40503u);
+            in.moveX = (int8_t)((int)(h % 3) - 1);
+            in.moveZ = (int8_t)((int)((h >> 4) % 3) - 1);
+            if ((h >> 8) % 16 == 0) in.buttons |= kButtonLight;
+            if (p == 1) in.moveX = (int8_t)((tick & 1) ? 1 : -1);
+            return in;
+        };
+        auto feed = [&](uint32_t t, bool withLate) {
+            for (int p = 0; p < count; ++p) {
+                if (p != 1) addRollbackInput(*rb, p, t, inputFor(t, p));
+            }
+            if (withLate) addRollbackInput(*rb, 1, t - kRollbackMaxTicks, inputFor(t - kRollbackMaxTicks, 1));
+        };
+        for (uint32_t t = 0; t < (uint32_t)kRollbackRing; ++t) {
+            feed(t, t >= (uint32_t)kRollbackMaxTicks);
+            advanceRollback(*rb, match, map);
+        }
+        std::snprintf(name, sizeof(name), "frame/%d-tick rollback/players/%d", kRollbackMaxTicks, count);
+        uint64_t rollbacksBefore = rb->stats.rollbacks;
+        double ns = benchMeasure(2000, [&](long) {
+            feed(rb->tick, true);
+            advanceRollback(*rb, match, map);
+        });
+        benchReport("rollback", name, ns);
+        if (rb->stats.rollbacks - rollbacksBefore < 2000 || rb->stats.maxDepth != kRollbackMaxTicks) {
+            std::printf("rollback     (warning: expected a full-window rollback every frame)\n");
+        }
+        std::snprintf(name, sizeof(name), "frame/no rollback/players/%d", count);
+        benchReport("rollback", name, benchMeasure(2000, [&](long) {
+            uint32_t t = rb->tick;
+            for (int p = 0; p < count; ++p) addRollbackInput(*rb, p, t, inputFor(t, p));
+            advanceRollback(*rb, match, map);
+        }));
+    }
+}
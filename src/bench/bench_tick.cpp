@@ -0,0 +1,41 @@
+// Fixed-tick cost against player count, with a random but reproducible input stream.
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "bench/bench.h"
+#include "core/simd.h"
+#include "sim/sim.h"
+
+void benchTick() {
+    GameMap arena;
+    if (!arena.open(mapFilePath("desert"))) {
+        std::printf("tick         %s not found; run from the build directory\n", mapFilePath("desert").c_str());
+        return;
+    }
+    const MapData &map = arena.data();
+    const int counts[] = {2, 8, 32, 64, 128, 256};
+    std::printf("tick         simd lanes: %d\n", kSimdWidth);
+    for (int count : counts) {
+        // 64 ticks worth of inputs per player, replayed cyclically
+        const int inputTicks = 64;
+        std::vector<PlayerInput> inputs((size_t)inputTicks * count);
+        uint32_t rng = 99u;
+        for (auto &in : inputs) {
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            in.moveX = (int8_t)((int)(rng % 3) - 1);
+            in.moveZ = (int8_t)((int)((rng >> 4) % 3) - 1);
+            uint32_t b = (rng >> 8) % 32;
+            in.buttons = (uint8_t)((b == 0 ? kButtonJump : 0) | (b == 1 ? kButtonLight : 0) | (b == 2 ? kButtonHeavy : 0) | ((rng >> 16) % 4 == 0 ? kButtonSprint : 0));
+        }
+        static MatchState match;
+        std::vector<int> characters(count, 0);
+        resetMatch(match, map, count, characters.data());
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "step/players/%d", count);
+        benchReport("tick", name, benchMeasure(20000, [&](long i) {
+            stepMatch(match, map, &inputs[(size_t)(i % inputTicks) * count], kFixedDt);
+        }));
+    }
+}
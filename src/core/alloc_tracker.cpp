@@ -0,0 +1,111 @@
+#include "core/alloc_tracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Constant-initialised, so they are usable from the first allocation of static init on
+struct alignas(64) TagCounter {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+};
+static TagCounter gTags[kAllocTagCount];
+static thread_local uint64_t tAllocations = 0;
+static thread_local uint64_t tBytes = 0;
+static thread_local AllocTag tTag = AllocTag::Other;
+
+static const char *const kAllocTagNames[kAllocTagCount] = {
+    "other", "sim", "bots", "render", "particles", "assets", "input", "net",
+};
+
+const char *allocTagName(AllocTag tag) { return kAllocTagNames[(int)tag]; }
+
+AllocCounts allocThreadCounts() { return {tAllocations, tBytes}; }
+
+void allocTagCounts(AllocCounts counts[]) {
+    for (int i = 0; i < kAllocTagCount; ++i) {
+        counts[i].allocations = gTags[i].allocations.load(std::memory_order_relaxed);
+        counts[i].bytes = gTags[i].bytes.load(std::memory_order_relaxed);
+    }
+}
+
+AllocScope::AllocScope(AllocTag tag) : previous_(tTag) { tTag = tag; }
+
+AllocScope::~AllocScope() { tTag = previous_; }
+
+static void count(size_t size) {
+    tAllocations++;
+    tBytes += size;
+    TagCounter &tag = gTags[(int)tTag];
+    tag.allocations.fetch_add(1, std::memory_order_relaxed);
+    tag.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+static void *tryAllocate(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+    if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void *p = nullptr;
+    return posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+#endif
+}
+
+static void release(void *p, size_t alignment) {
+#if defined(_WIN32)
+    if (alignment > alignof(std::max_align_t)) {
+        _aligned_free(p);
+        return;
+    }
+#endif
+    (void)alignment;
+    std::free(p);
+}
+
+// What the standard operator new does: retry through the new-handler, throw without one
+static void *allocate(size_t size, size_t alignment) {
+    count(size);
+    for (;;) {
+        if (void *p = tryAllocate(size, alignment)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+static void *allocateNoThrow(size_t size, size_t alignment) noexcept {
+    try {
+        return allocate(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+static const size_t kDefaultAlignment = alignof(std::max_align_t);
+
+void *operator new(size_t size) { return allocate(size, kDefaultAlignment); }
+void *operator new[](size_t size) { return allocate(size, kDefaultAlignment); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return allocateNoThrow(size, kDefaultAlignment); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return allocateNoThrow(size, kDefaultAlignment); }
+void *operator new(size_t size, std::align_val_t alignment) { return allocate(size, (size_t)alignment); }
+void *operator new[](size_t size, std::align_val_t alignment) { return allocate(size, (size_t)alignment); }
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocateNoThrow(size, (size_t)alignment);
+}
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocateNoThrow(size, (size_t)alignment);
+}
+
+void operator delete(void *p) noexcept { release(p, kDefaultAlignment); }
+void operator delete[](void *p) noexcept { release(p, kDefaultAlignment); }
+void operator delete(void *p, size_t) noexcept { release(p, kDefaultAlignment); }
+void operator delete[](void *p, size_t) noexcept { release(p, kDefaultAlignment); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { release(p, kDefaultAlignment); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { release(p, kDefaultAlignment); }
+void operator delete(void *p, std::align_val_t alignment) noexcept { release(p, (size_t)alignment); }
+void operator delete[](void *p, std::align_val_t alignment) noexcept { release(p, (size_t)alignment); }
+void operator delete(void *p, size_t, std::align_val_t alignment) noexcept { release(p, (size_t)alignment); }
+void operator delete[](void *p, size_t, std::align_val_t alignment) noexcept { release(p, (size_t)alignment); }
+void operator delete(void *p, std::align_val_t alignment, const std::nothrow_t &) noexcept { release(p, (size_t)alignment); }
+void operator delete[](void *p, std::align_val_t alignment, const std::nothrow_t &) noexcept { release(p, (size_t)alignment); }
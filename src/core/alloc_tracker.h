@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Heap accounting. core/alloc_tracker.cpp replaces the global operator new and delete, so
+// every C++ allocation in a program linking epiCBattle_core is counted twice: for the
+// allocating thread, for checks such as "this tick allocated nothing" (epiCBattle_sim
+// --alloc-check), and for the subsystem named by the innermost AllocScope on that thread,
+// for the client's allocations-per-frame overlay. Counting is a thread-local add plus two
+// relaxed atomic adds per allocation. malloc calls from C code (raylib, stb) are not seen.
+
+enum class AllocTag : uint8_t { Other, Sim, Bots, Render, Particles, Assets, Input, Net };
+constexpr int kAllocTagCount = 8;
+
+const char *allocTagName(AllocTag tag);
+
+struct AllocCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+// Allocations made so far by the calling thread.
+AllocCounts allocThreadCounts();
+// Allocations made so far under each tag by any thread; counts has kAllocTagCount entries.
+void allocTagCounts(AllocCounts counts[]);
+
+// Attributes the calling thread's allocations to tag until it goes out of scope.
+class AllocScope {
+public:
+    explicit AllocScope(AllocTag tag);
+    ~AllocScope();
+    AllocScope(const AllocScope &) = delete;
+    AllocScope &operator=(const AllocScope &) = delete;
+
+private:
+    AllocTag previous_;
+};
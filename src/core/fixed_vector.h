@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+// A vector with its capacity fixed at compile time and its storage inline, for lists with a
+// known bound that are refilled every frame or tick: nothing ever goes to the heap. push_back
+// on a full list drops the element and returns false. Elements are assigned into
+// default-constructed storage, so T needs a default constructor and cheap copies.
+template <typename T, int N>
+class FixedVector {
+public:
+    static_assert(std::is_trivially_destructible<T>::value, "clear() only resets the count");
+
+    bool push_back(const T &value) {
+        if (size_ == N) return false;
+        items_[size_++] = value;
+        return true;
+    }
+    void clear() { size_ = 0; }
+
+    int size() const { return size_; }
+    static constexpr int capacity() { return N; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == N; }
+
+    T &operator[](int i) { return items_[i]; }
+    const T &operator[](int i) const { return items_[i]; }
+    T *begin() { return items_; }
+    T *end() { return items_ + size_; }
+    const T *begin() const { return items_; }
+    const T *end() const { return items_ + size_; }
+
+private:
+    T items_[N];
+    int size_ = 0;
+};
@@ -0,0 +1,60 @@
+#include "core/frame_arena.h"
+
+#include <new>
+
+// Room for the header at the start of a spill block, keeping what follows max-aligned
+static const size_t kSpillHeader = (sizeof(void *) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+static size_t alignUp(size_t v, size_t align) { return (v + align - 1) & ~(align - 1); }
+
+FrameArena::FrameArena(size_t capacity) {
+    if (capacity > 0) {
+        block_ = static_cast<uint8_t *>(::operator new(capacity));
+        capacity_ = capacity;
+    }
+}
+
+FrameArena::~FrameArena() {
+    freeSpills();
+    ::operator delete(block_);
+}
+
+void *FrameArena::allocate(size_t bytes, size_t align) {
+    if (bytes == 0) bytes = 1;
+    // Aligned by address, so alignments stricter than operator new's hold as well
+    const uintptr_t base = (uintptr_t)block_;
+    const size_t start = alignUp(base + offset_, align) - base;
+    if (block_ && start + bytes <= capacity_) {
+        used_ += start + bytes - offset_;
+        offset_ = start + bytes;
+        return block_ + start;
+    }
+    const size_t size = kSpillHeader + bytes + align;
+    Spill *spill = static_cast<Spill *>(::operator new(size));
+    spill->next = spills_;
+    spills_ = spill;
+    used_ += bytes + align;
+    const uintptr_t data = (uintptr_t)spill + kSpillHeader;
+    return (void *)alignUp(data, align);
+}
+
+void FrameArena::reset() {
+    if (used_ > highWater_) highWater_ = used_;
+    freeSpills();
+    // This frame spilled: next time the block holds it all
+    if (highWater_ > capacity_) {
+        ::operator delete(block_);
+        block_ = static_cast<uint8_t *>(::operator new(highWater_));
+        capacity_ = highWater_;
+    }
+    offset_ = 0;
+    used_ = 0;
+}
+
+void FrameArena::freeSpills() {
+    while (spills_) {
+        Spill *next = spills_->next;
+        ::operator delete(spills_);
+        spills_ = next;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Bump allocator for data that lives exactly one frame. allocate() hands out the next
+// aligned piece of one block and reset() takes it all back at once; nothing is freed on its
+// own and no destructors run, so only trivially destructible types go in. A frame that needs
+// more than the block still gets its memory, from the heap, and the next reset() grows the
+// block to the most any frame has used, so after a few frames of warm-up the arena stops
+// touching the heap at all.
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = 0);
+    ~FrameArena();
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    // bytes of memory aligned to align (a power of two), valid until reset()
+    void *allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+
+    // count uninitialised Ts
+    template <typename T>
+    T *allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Ends the frame: everything allocated since the last reset() is gone.
+    void reset();
+
+    size_t used() const { return used_; }           // this frame, spills included
+    size_t capacity() const { return capacity_; }   // the block; more than this spills to the heap
+    size_t highWater() const { return highWater_; } // most any frame has used
+
+private:
+    // Heap blocks for what did not fit this frame, chained through a header at their start
+    struct Spill {
+        Spill *next;
+    };
+
+    void freeSpills();
+
+    uint8_t *block_ = nullptr;
+    size_t capacity_ = 0;
+    size_t offset_ = 0;
+    size_t used_ = 0;
+    size_t highWater_ = 0;
+    Spill *spills_ = nullptr;
+};
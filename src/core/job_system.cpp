@@ -0,0 +1,202 @@
+#include "core/job_system.h"
+
+#include "core/profiler.h"
+
+// Yields an idle worker spends looking for work before it sleeps
+static const int kIdleSpins = 64;
+
+// Which system's worker, if any, the calling thread is
+static thread_local const JobSystem *tSystem = nullptr;
+static thread_local int tWorker = -1;
+
+JobSystem::JobSystem(int threadCount) {
+    if (threadCount < 1) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount < 1) threadCount = 1;
+    const int workerCount = threadCount - 1;
+    for (int i = 0; i <= workerCount; ++i) deques_.emplace_back(new Deque);
+    for (int i = 0; i < workerCount; ++i) workers_.emplace_back(&JobSystem::workerMain, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_.store(true);
+    }
+    sleepCv_.notify_all();
+    for (auto &w : workers_) w.join();
+}
+
+void JobSystem::run(JobFunction fn, void *context, JobCounter *counter, int begin, int end, int grain) {
+    Job job;
+    job.fn = fn;
+    job.context = context;
+    job.counter = counter;
+    job.begin = begin;
+    job.end = end;
+    job.grain = grain;
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+    if (workers_.empty()) execute(job);
+    else push(job);
+}
+
+void JobSystem::runBackground(JobFunction fn, void *context, JobCounter *counter) {
+    Job job;
+    job.fn = fn;
+    job.context = context;
+    job.counter = counter;
+    job.end = 1;
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+    if (workers_.empty()) {
+        execute(job);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(backgroundMutex_);
+        background_.push_back(job);
+    }
+    wake();
+}
+
+void JobSystem::push(const Job &job) {
+    // Workers push onto their own deque, everyone else onto the shared one at the end
+    const bool worker = tSystem == this && tWorker >= 0;
+    Deque &deque = *deques_[worker ? tWorker : workers_.size()];
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        if (deque.tail - deque.head < (uint32_t)kDequeCapacity) {
+            deque.jobs[deque.tail % kDequeCapacity] = job;
+            deque.tail++;
+            queued = true;
+        }
+    }
+    if (queued) wake();
+    else execute(job);
+}
+
+void JobSystem::wake() {
+    epoch_.fetch_add(1);
+    if (sleeping_.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        sleepCv_.notify_one();
+    }
+}
+
+bool JobSystem::take(int self, bool background, Job &job) {
+    const int workerCount = (int)workers_.size();
+    // Own deque newest first
+    if (self >= 0) {
+        Deque &own = *deques_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.tail != own.head) {
+            job = own.jobs[--own.tail % kDequeCapacity];
+            return true;
+        }
+    }
+    // Then the shared queue and everyone else's, oldest first
+    for (int k = 0; k <= workerCount; ++k) {
+        const int victim = k == 0 ? workerCount : (self + k) % workerCount;
+        if (victim == self) continue;
+        Deque &deque = *deques_[victim];
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        if (deque.tail != deque.head) {
+            job = deque.jobs[deque.head++ % kDequeCapacity];
+            return true;
+        }
+    }
+    if (!background) return false;
+    std::lock_guard<std::mutex> lock(backgroundMutex_);
+    if (background_.empty()) return false;
+    job = background_.front();
+    background_.pop_front();
+    return true;
+}
+
+void JobSystem::execute(Job job) {
+    // Halve what is left, leave the upper half for thieves and keep going on the lower one
+    while (job.grain > 0 && job.end - job.begin > job.grain) {
+        Job upper = job;
+        upper.begin = job.begin + (job.end - job.begin) / 2;
+        job.end = upper.begin;
+        if (upper.counter) upper.counter->pending.fetch_add(1, std::memory_order_relaxed);
+        push(upper);
+    }
+    job.fn(job.context, job.begin, job.end);
+    if (job.counter) job.counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    const int self = tSystem == this ? tWorker : -1;
+    while (!counter.done()) {
+        Job job;
+        if (take(self, false, job)) execute(job);
+        else std::this_thread::yield();
+    }
+}
+
+void JobSystem::workerMain(int index) {
+    tSystem = this;
+    tWorker = index;
+    profilerSetThreadName("job worker");
+    while (!stop_.load(std::memory_order_relaxed)) {
+        const uint32_t epoch = epoch_.load();
+        Job job;
+        bool found = take(index, true, job);
+        for (int spin = 0; !found && spin < kIdleSpins; ++spin) {
+            std::this_thread::yield();
+            found = take(index, true, job);
+        }
+        if (found) {
+            execute(job);
+            continue;
+        }
+        // Nothing pushed since epoch was read, or the predicate sees the bump
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleeping_.fetch_add(1);
+        sleepCv_.wait(lock, [&] { return stop_.load(std::memory_order_relaxed) || epoch_.load() != epoch; });
+        sleeping_.fetch_sub(1);
+    }
+}
+
+int JobGraph::add(const char *name, std::function<void()> fn, std::initializer_list<int> dependsOn) {
+    const int id = (int)nodes_.size();
+    Node node;
+    node.name = name;
+    node.fn = std::move(fn);
+    for (int dependency : dependsOn) {
+        if (dependency < 0 || dependency >= id) continue;
+        nodes_[dependency].successors.push_back(id);
+        node.dependencies++;
+    }
+    nodes_.push_back(std::move(node));
+    return id;
+}
+
+void JobGraph::run(JobSystem &jobs) {
+    const size_t count = nodes_.size();
+    if (count == 0) return;
+    if (remainingSize_ < count) {
+        remaining_.reset(new std::atomic<int>[count]);
+        remainingSize_ = count;
+    }
+    for (size_t i = 0; i < count; ++i) remaining_[i].store(nodes_[i].dependencies, std::memory_order_relaxed);
+    jobs_ = &jobs;
+    for (size_t i = 0; i < count; ++i) {
+        if (nodes_[i].dependencies == 0) jobs.run(&JobGraph::runNode, this, &counter_, (int)i, (int)i + 1);
+    }
+    jobs.wait(counter_);
+}
+
+void JobGraph::runNode(void *context, int begin, int) {
+    JobGraph &graph = *static_cast<JobGraph *>(context);
+    const Node &node = graph.nodes_[begin];
+    {
+        ProfileZone zone(node.name);
+        node.fn();
+    }
+    for (int next : node.successors) {
+        if (graph.remaining_[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            graph.jobs_->run(&JobGraph::runNode, &graph, &graph.counter_, next, next + 1);
+        }
+    }
+}
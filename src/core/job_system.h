@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing job scheduler. Each worker thread owns a deque: it pushes and pops its own
+// jobs at the back (newest first, still warm in cache) while idle workers steal from the
+// front of someone else's (oldest first, which for parallelFor is the biggest range left).
+// Threads that are not workers (the main thread, the sim thread) submit through a shared
+// queue and run jobs themselves while they wait, so a JobSystem of N threads has N - 1
+// workers plus whoever is waiting. Every deque has its own lock, taken for a push, a pop
+// or a steal; a worker contends only with thieves, and only once its own deque runs dry
+// does it go looking.
+//
+// Background jobs (asset decoding) sit in a separate queue that only workers take, and
+// only when there is nothing else to run: wait() never picks one up, so a frame that waits
+// on its own jobs cannot end up stuck behind a 20 ms texture load.
+//
+// Jobs are plain function pointers with a context and an index range; nothing is allocated
+// per job. parallelFor splits its range in halves as it goes, so thieves take large pieces
+// and the owner keeps the small ones.
+
+// Jobs still to finish in a group. Zero-initialised; reusable once wait() returns.
+struct JobCounter {
+    std::atomic<int> pending{0};
+
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// fn(context, begin, end) handles [begin, end).
+using JobFunction = void (*)(void *context, int begin, int end);
+
+class JobSystem {
+public:
+    // threadCount < 1 means one per hardware thread. With a single thread there are no
+    // workers and every job, background ones included, runs inline as it is queued.
+    explicit JobSystem(int threadCount = 0);
+    ~JobSystem();
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    int threadCount() const { return (int)workers_.size() + 1; }
+
+    // Queues fn over [begin, end), split into pieces of at most grain indices (0: never split).
+    // counter, if any, counts the job until it and every piece split off it have run.
+    void run(JobFunction fn, void *context, JobCounter *counter, int begin = 0, int end = 1, int grain = 0);
+    void runBackground(JobFunction fn, void *context, JobCounter *counter);
+
+    // Runs queued jobs (not background ones) on the calling thread until counter is done.
+    void wait(JobCounter &counter);
+
+    // fn(begin, end) over [0, count) in pieces of about grain, returning when all ran. Small
+    // ranges, and a single thread, run inline without touching the queues.
+    template <typename Fn>
+    void parallelFor(int count, int grain, const Fn &fn) {
+        if (count <= 0) return;
+        if (grain < 1) grain = 1;
+        if (count <= grain || workers_.empty()) {
+            fn(0, count);
+            return;
+        }
+        JobCounter counter;
+        run(&callRange<Fn>, (void *)&fn, &counter, 0, count, grain);
+        wait(counter);
+    }
+
+private:
+    struct Job {
+        JobFunction fn = nullptr;
+        void *context = nullptr;
+        JobCounter *counter = nullptr;
+        int begin = 0;
+        int end = 0;
+        int grain = 0;
+    };
+
+    // Fixed ring; a push that finds it full runs the job inline instead
+    static constexpr int kDequeCapacity = 1024;
+    struct alignas(64) Deque {
+        std::mutex mutex;
+        Job jobs[kDequeCapacity];
+        uint32_t head = 0;      // steal end
+        uint32_t tail = 0;      // owner end
+    };
+
+    template <typename Fn>
+    static void callRange(void *context, int begin, int end) {
+        (*static_cast<const Fn *>(context))(begin, end);
+    }
+
+    void workerMain(int index);
+    void push(const Job &job);
+    bool take(int self, bool background, Job &job);
+    void execute(Job job);
+    void wake();
+
+    std::vector<std::unique_ptr<Deque>> deques_;    // one per worker, then the shared queue
+    std::mutex backgroundMutex_;
+    std::deque<Job> background_;
+    std::vector<std::thread> workers_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<uint32_t> epoch_{0};        // bumped on every push, so a sleeper cannot miss one
+    std::atomic<int> sleeping_{0};
+    std::atomic<bool> stop_{false};
+};
+
+// Jobs with dependencies, rebuilt (or re-run) every frame: a node starts once every node
+// it depends on has finished, and independent nodes run in parallel. Nodes may use
+// parallelFor inside. Names label the nodes in the profiler and must be string literals.
+class JobGraph {
+public:
+    // Adds a node that runs fn after all of dependsOn (ids returned earlier); returns its id.
+    int add(const char *name, std::function<void()> fn, std::initializer_list<int> dependsOn = {});
+    // Runs every node once and returns when the last has finished.
+    void run(JobSystem &jobs);
+    void clear() { nodes_.clear(); }
+    bool empty() const { return nodes_.empty(); }
+
+private:
+    struct Node {
+        const char *name;
+        std::function<void()> fn;
+        std::vector<int> successors;
+        int dependencies = 0;
+    };
+
+    static void runNode(void *context, int begin, int end);
+
+    std::vector<Node> nodes_;
+    std::unique_ptr<std::atomic<int>[]> remaining_;
+    size_t remainingSize_ = 0;
+    JobSystem *jobs_ = nullptr;
+    JobCounter counter_;
+};
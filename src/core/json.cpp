@@ -0,0 +1,203 @@
+#include "core/json.h"
+
+#include <cstdlib>
+#include <cstring>
+
+const JsonValue *JsonValue::find(const char *key) const {
+    if (!isObject()) return nullptr;
+    for (const auto &m : members) {
+        if (m.first == key) return &m.second;
+    }
+    return nullptr;
+}
+
+// Recursive descent over the buffer; depth is capped so hostile input cannot blow the stack
+struct JsonReader {
+    const char *p;
+    const char *end;
+    const char *begin;
+    const char *failure = nullptr;
+    int depth = 0;
+
+    static constexpr int kMaxDepth = 128;
+
+    bool fail(const char *what) {
+        if (!failure) failure = what;
+        return false;
+    }
+
+    void skipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    }
+
+    bool literal(const char *word) {
+        size_t n = std::strlen(word);
+        if ((size_t)(end - p) < n || std::memcmp(p, word, n) != 0) return fail("unknown literal");
+        p += n;
+        return true;
+    }
+
+    static void appendUtf8(std::string &s, unsigned cp) {
+        if (cp < 0x80) {
+            s += (char)cp;
+        } else if (cp < 0x800) {
+            s += (char)(0xC0 | (cp >> 6));
+            s += (char)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            s += (char)(0xE0 | (cp >> 12));
+            s += (char)(0x80 | ((cp >> 6) & 0x3F));
+            s += (char)(0x80 | (cp & 0x3F));
+        } else {
+            s += (char)(0xF0 | (cp >> 18));
+            s += (char)(0x80 | ((cp >> 12) & 0x3F));
+            s += (char)(0x80 | ((cp >> 6) & 0x3F));
+            s += (char)(0x80 | (cp & 0x3F));
+        }
+    }
+
+    bool hex4(unsigned &out) {
+        if (end - p < 4) return fail("truncated \\u escape");
+        out = 0;
+        for (int i = 0; i < 4; ++i, ++p) {
+            char c = *p;
+            out <<= 4;
+            if (c >= '0' && c <= '9') out |= (unsigned)(c - '0');
+            else if (c >= 'a' && c <= 'f') out |= (unsigned)(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') out |= (unsigned)(c - 'A' + 10);
+            else return fail("bad \\u escape");
+        }
+        return true;
+    }
+
+    bool string(std::string &out) {
+        ++p;    // opening quote
+        out.clear();
+        while (p < end && *p != '"') {
+            char c = *p++;
+            if ((unsigned char)c < 0x20) return fail("control character in string");
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (p >= end) break;
+            switch (*p++) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned cp;
+                    if (!hex4(cp)) return false;
+                    // Surrogate pair
+                    if (cp >= 0xD800 && cp < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                        p += 2;
+                        unsigned low;
+                        if (!hex4(low)) return false;
+                        if (low < 0xDC00 || low >= 0xE000) return fail("bad surrogate pair");
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, cp);
+                } break;
+                default: return fail("bad escape");
+            }
+        }
+        if (p >= end) return fail("unterminated string");
+        ++p;    // closing quote
+        return true;
+    }
+
+    bool number(double &out) {
+        // strtod needs a terminated buffer; numbers are short, so copy the candidate span
+        const char *start = p;
+        while (p < end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) ++p;
+        char buffer[64];
+        size_t n = (size_t)(p - start);
+        if (n == 0 || n >= sizeof(buffer)) return fail("bad number");
+        std::memcpy(buffer, start, n);
+        buffer[n] = '\0';
+        char *stop = nullptr;
+        out = std::strtod(buffer, &stop);
+        if (stop != buffer + n) return fail("bad number");
+        return true;
+    }
+
+    bool value(JsonValue &out) {
+        skipSpace();
+        if (p >= end) return fail("unexpected end");
+        switch (*p) {
+            case '{': return object(out);
+            case '[': return array(out);
+            case '"': out.type = JsonValue::Type::String; return string(out.string);
+            case 't': out.type = JsonValue::Type::Bool; out.boolean = true; return literal("true");
+            case 'f': out.type = JsonValue::Type::Bool; out.boolean = false; return literal("false");
+            case 'n': out.type = JsonValue::Type::Null; return literal("null");
+            default: out.type = JsonValue::Type::Number; return number(out.number);
+        }
+    }
+
+    bool object(JsonValue &out) {
+        if (++depth > kMaxDepth) return fail("nested too deeply");
+        out.type = JsonValue::Type::Object;
+        ++p;
+        skipSpace();
+        if (p < end && *p == '}') {
+            ++p;
+            --depth;
+            return true;
+        }
+        for (;;) {
+            skipSpace();
+            if (p >= end || *p != '"') return fail("expected key");
+            out.members.emplace_back();
+            if (!string(out.members.back().first)) return false;
+            skipSpace();
+            if (p >= end || *p != ':') return fail("expected ':'");
+            ++p;
+            if (!value(out.members.back().second)) return false;
+            skipSpace();
+            if (p < end && *p == ',') { ++p; continue; }
+            if (p < end && *p == '}') { ++p; break; }
+            return fail("expected ',' or '}'");
+        }
+        --depth;
+        return true;
+    }
+
+    bool array(JsonValue &out) {
+        if (++depth > kMaxDepth) return fail("nested too deeply");
+        out.type = JsonValue::Type::Array;
+        ++p;
+        skipSpace();
+        if (p < end && *p == ']') {
+            ++p;
+            --depth;
+            return true;
+        }
+        for (;;) {
+            out.items.emplace_back();
+            if (!value(out.items.back())) return false;
+            skipSpace();
+            if (p < end && *p == ',') { ++p; continue; }
+            if (p < end && *p == ']') { ++p; break; }
+            return fail("expected ',' or ']'");
+        }
+        --depth;
+        return true;
+    }
+};
+
+bool parseJson(const char *text, size_t size, JsonValue &out, std::string *error) {
+    JsonReader reader{text, text + size, text};
+    out = JsonValue{};
+    bool ok = reader.value(out);
+    if (ok) {
+        reader.skipSpace();
+        if (reader.p != reader.end) ok = reader.fail("trailing characters");
+    }
+    if (!ok && error) *error = std::string(reader.failure ? reader.failure : "parse error") + " at byte " + std::to_string(reader.p - reader.begin);
+    return ok;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Small DOM JSON reader for tool and asset metadata (glTF headers and the like), not for
+// anything per frame. Numbers are doubles; strings are UTF-8 with escapes decoded.
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;                               // Array
+    std::vector<std::pair<std::string, JsonValue>> members;     // Object, in file order
+
+    bool isObject() const { return type == Type::Object; }
+    bool isArray() const { return type == Type::Array; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isString() const { return type == Type::String; }
+
+    // Member by key, or null when this is not an object or has no such key
+    const JsonValue *find(const char *key) const;
+    // Array element, or null when out of range
+    const JsonValue *at(size_t index) const { return isArray() && index < items.size() ? &items[index] : nullptr; }
+    int asInt(int fallback) const { return isNumber() ? (int)number : fallback; }
+};
+
+// False on malformed input; error (when given) then says what and at which byte.
+bool parseJson(const char *text, size_t size, JsonValue &out, std::string *error = nullptr);
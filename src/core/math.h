@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cmath>
+#include "core/types.h"
+
+// Minimal vector helpers for the simulation (mirrors the subset of raymath it used).
+
+static inline Vec3 vec3Add(Vec3 a, Vec3 b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+static inline Vec3 vec3Sub(Vec3 a, Vec3 b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+static inline Vec3 vec3Scale(Vec3 v, float s) { return {v.x * s, v.y * s, v.z * s}; }
+static inline float vec3Length(Vec3 v) { return sqrtf(v.x * v.x + v.y * v.y + v.z * v.z); }
+static inline float vec3Distance(Vec3 a, Vec3 b) { return vec3Length(vec3Sub(a, b)); }
+
+static inline Vec3 vec3Normalize(Vec3 v) {
+    float len = vec3Length(v);
+    if (len <= 0.0f) return v;
+    return vec3Scale(v, 1.0f / len);
+}
+
+static inline float clampf(float value, float minValue, float maxValue) {
+    if (value < minValue) return minValue;
+    if (value > maxValue) return maxValue;
+    return value;
+}
@@ -0,0 +1,157 @@
+#include "core/profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+std::atomic<bool> gProfilerEnabled{false};
+
+struct RingEvent {
+    std::atomic<const char *> name;
+    std::atomic<uint64_t> startNs;
+    std::atomic<uint64_t> endNs;
+};
+
+struct ThreadRing {
+    std::atomic<uint64_t> head{0};      // total events ever written
+    int threadId = 0;
+    char threadName[32] = {};
+    RingEvent events[kProfileRingCapacity];
+};
+
+struct Snapshot {
+    const char *name;
+    uint64_t startNs;
+    uint64_t endNs;
+    int threadId;
+};
+
+// Rings are never freed so events from finished threads stay exportable.
+static std::mutex gRegistryMutex;
+static std::vector<std::unique_ptr<ThreadRing>> gRings;
+static thread_local ThreadRing *tRing = nullptr;
+
+static const std::chrono::steady_clock::time_point gEpoch = std::chrono::steady_clock::now();
+
+static ThreadRing &threadRing() {
+    if (!tRing) {
+        auto ring = std::make_unique<ThreadRing>();
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        ring->threadId = (int)gRings.size() + 1;
+        std::snprintf(ring->threadName, sizeof(ring->threadName), "thread %d", ring->threadId);
+        tRing = ring.get();
+        gRings.push_back(std::move(ring));
+    }
+    return *tRing;
+}
+
+static void collect(uint64_t sinceNs, std::vector<Snapshot> &out) {
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    for (const auto &ring : gRings) {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = head > kProfileRingCapacity ? head - kProfileRingCapacity : 0;
+        size_t first = out.size();
+        for (uint64_t i = begin; i < head; ++i) {
+            const RingEvent &e = ring->events[i & (kProfileRingCapacity - 1)];
+            out.push_back({e.name.load(std::memory_order_relaxed), e.startNs.load(std::memory_order_relaxed),
+                           e.endNs.load(std::memory_order_relaxed), ring->threadId});
+        }
+        // The writer may have lapped the oldest slots while they were copied
+        uint64_t after = ring->head.load(std::memory_order_acquire);
+        uint64_t overwritten = after > kProfileRingCapacity ? after - kProfileRingCapacity : 0;
+        if (overwritten > begin) {
+            size_t drop = (size_t)std::min<uint64_t>(overwritten - begin, head - begin);
+            out.erase(out.begin() + first, out.begin() + first + drop);
+        }
+    }
+    out.erase(std::remove_if(out.begin(), out.end(), [&](const Snapshot &s) { return !s.name || s.endNs < sinceNs; }), out.end());
+}
+
+void profilerSetEnabled(bool enabled) {
+    gProfilerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void profilerSetThreadName(const char *name) {
+    ThreadRing &ring = threadRing();
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    std::snprintf(ring.threadName, sizeof(ring.threadName), "%s", name);
+}
+
+uint64_t profilerNowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gEpoch).count();
+}
+
+void profilerRecord(const char *name, uint64_t startNs, uint64_t endNs) {
+    ThreadRing &ring = threadRing();
+    uint64_t i = ring.head.load(std::memory_order_relaxed);
+    RingEvent &e = ring.events[i & (kProfileRingCapacity - 1)];
+    e.name.store(name, std::memory_order_relaxed);
+    e.startNs.store(startNs, std::memory_order_relaxed);
+    e.endNs.store(endNs, std::memory_order_relaxed);
+    ring.head.store(i + 1, std::memory_order_release);
+}
+
+std::vector<ZoneStats> profilerZoneStats(double windowSeconds) {
+    uint64_t now = profilerNowNs();
+    uint64_t window = (uint64_t)(windowSeconds * 1e9);
+    std::vector<Snapshot> events;
+    collect(now > window ? now - window : 0, events);
+
+    // Group by name; the same literal can have different addresses in different objects
+    std::sort(events.begin(), events.end(), [](const Snapshot &a, const Snapshot &b) { return std::strcmp(a.name, b.name) < 0; });
+    std::vector<ZoneStats> stats;
+    std::vector<double> durations;
+    for (size_t i = 0; i < events.size();) {
+        size_t j = i;
+        durations.clear();
+        while (j < events.size() && std::strcmp(events[j].name, events[i].name) == 0) {
+            durations.push_back((events[j].endNs - events[j].startNs) / 1e6);
+            ++j;
+        }
+        std::sort(durations.begin(), durations.end());
+        auto pct = [&](double p) { return durations[(size_t)(p * (durations.size() - 1) + 0.5)]; };
+        ZoneStats z{};
+        z.name = events[i].name;
+        z.count = (int)durations.size();
+        for (double d : durations) z.totalMs += d;
+        z.meanMs = z.totalMs / z.count;
+        z.p50Ms = pct(0.50);
+        z.p95Ms = pct(0.95);
+        z.p99Ms = pct(0.99);
+        z.maxMs = durations.back();
+        stats.push_back(z);
+        i = j;
+    }
+    std::sort(stats.begin(), stats.end(), [](const ZoneStats &a, const ZoneStats &b) { return a.totalMs > b.totalMs; });
+    return stats;
+}
+
+bool profilerWriteChromeTrace(const std::string &path, double lastSeconds) {
+    uint64_t now = profilerNowNs();
+    uint64_t window = (uint64_t)(lastSeconds * 1e9);
+    std::vector<Snapshot> events;
+    collect(now > window ? now - window : 0, events);
+
+    FILE *f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "{\"traceEvents\":[\n");
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        for (const auto &ring : gRings) {
+            std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                         first ? "" : ",\n", ring->threadId, ring->threadName);
+            first = false;
+        }
+    }
+    for (const Snapshot &e : events) {
+        std::fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", first ? "" : ",\n",
+                     e.name, e.threadId, e.startNs / 1000.0, (e.endNs - e.startNs) / 1000.0);
+        first = false;
+    }
+    std::fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    return std::fclose(f) == 0;
+}
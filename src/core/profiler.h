@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scoped-zone profiler. Each thread that records gets its own ring buffer of the last
+// kProfileRingCapacity zones; the owning thread is the only writer, so recording is a
+// couple of relaxed stores and one release store, with no locks. Readers (the overlay,
+// trace export) copy the rings and drop anything overwritten while they copied.
+//
+//     void stepSomething() {
+//         PROFILE_ZONE("something");
+//         ...
+//     }
+//
+// Zone names must be string literals (only the pointer is stored). Recording is off until
+// profilerSetEnabled(true); a disabled zone costs one atomic load.
+
+constexpr uint32_t kProfileRingCapacity = 1u << 16;
+
+extern std::atomic<bool> gProfilerEnabled;
+
+static inline bool profilerEnabled() { return gProfilerEnabled.load(std::memory_order_relaxed); }
+void profilerSetEnabled(bool enabled);
+
+// Labels the calling thread in trace output ("main", "asset worker", ...).
+void profilerSetThreadName(const char *name);
+
+// Nanoseconds since the profiler's epoch (first use).
+uint64_t profilerNowNs();
+void profilerRecord(const char *name, uint64_t startNs, uint64_t endNs);
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char *name)
+        : name_(profilerEnabled() ? name : nullptr), start_(name_ ? profilerNowNs() : 0) {}
+    ~ProfileZone() {
+        if (name_) profilerRecord(name_, start_, profilerNowNs());
+    }
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    const char *name_;
+    uint64_t start_;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+struct ZoneStats {
+    const char *name;
+    int count;
+    double totalMs;
+    double meanMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double maxMs;
+};
+
+// Per-zone timings over the last windowSeconds across all threads, largest total first.
+std::vector<ZoneStats> profilerZoneStats(double windowSeconds);
+
+// Writes the last lastSeconds of zones as Chrome trace_event JSON (chrome://tracing, Perfetto).
+bool profilerWriteChromeTrace(const std::string &path, double lastSeconds);
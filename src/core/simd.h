@@ -0,0 +1,78 @@
+#pragma once
+
+// Thin float-lane wrapper for the SoA sim kernels. Picks AVX (8 lanes) when the build
+// enables it, SSE2 (4 lanes, the x86-64 baseline) otherwise, and a scalar fallback on
+// other targets. Kernels are written once against these helpers.
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define EPIC_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EPIC_SIMD_SSE2 1
+#endif
+
+#if defined(EPIC_SIMD_AVX)
+
+constexpr int kSimdWidth = 8;
+struct F32x { __m256 v; };
+
+static inline F32x simdLoad(const float *p) { return {_mm256_load_ps(p)}; }
+static inline void simdStore(float *p, F32x a) { _mm256_store_ps(p, a.v); }
+static inline F32x simdSet(float s) { return {_mm256_set1_ps(s)}; }
+static inline F32x operator+(F32x a, F32x b) { return {_mm256_add_ps(a.v, b.v)}; }
+static inline F32x operator-(F32x a, F32x b) { return {_mm256_sub_ps(a.v, b.v)}; }
+static inline F32x operator*(F32x a, F32x b) { return {_mm256_mul_ps(a.v, b.v)}; }
+static inline F32x simdMin(F32x a, F32x b) { return {_mm256_min_ps(a.v, b.v)}; }
+static inline F32x simdMax(F32x a, F32x b) { return {_mm256_max_ps(a.v, b.v)}; }
+static inline F32x simdLessEq(F32x a, F32x b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+static inline F32x simdLess(F32x a, F32x b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+static inline F32x simdGreater(F32x a, F32x b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+static inline F32x simdAnd(F32x a, F32x b) { return {_mm256_and_ps(a.v, b.v)}; }
+// mask ? a : b
+static inline F32x simdSelect(F32x mask, F32x a, F32x b) { return {_mm256_blendv_ps(b.v, a.v, mask.v)}; }
+
+#elif defined(EPIC_SIMD_SSE2)
+
+constexpr int kSimdWidth = 4;
+struct F32x { __m128 v; };
+
+static inline F32x simdLoad(const float *p) { return {_mm_load_ps(p)}; }
+static inline void simdStore(float *p, F32x a) { _mm_store_ps(p, a.v); }
+static inline F32x simdSet(float s) { return {_mm_set1_ps(s)}; }
+static inline F32x operator+(F32x a, F32x b) { return {_mm_add_ps(a.v, b.v)}; }
+static inline F32x operator-(F32x a, F32x b) { return {_mm_sub_ps(a.v, b.v)}; }
+static inline F32x operator*(F32x a, F32x b) { return {_mm_mul_ps(a.v, b.v)}; }
+static inline F32x simdMin(F32x a, F32x b) { return {_mm_min_ps(a.v, b.v)}; }
+static inline F32x simdMax(F32x a, F32x b) { return {_mm_max_ps(a.v, b.v)}; }
+static inline F32x simdLessEq(F32x a, F32x b) { return {_mm_cmple_ps(a.v, b.v)}; }
+static inline F32x simdLess(F32x a, F32x b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+static inline F32x simdGreater(F32x a, F32x b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+static inline F32x simdAnd(F32x a, F32x b) { return {_mm_and_ps(a.v, b.v)}; }
+// mask ? a : b
+static inline F32x simdSelect(F32x mask, F32x a, F32x b) { return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))}; }
+
+#else
+
+constexpr int kSimdWidth = 1;
+struct F32x { float v; };
+
+static inline F32x simdLoad(const float *p) { return {*p}; }
+static inline void simdStore(float *p, F32x a) { *p = a.v; }
+static inline F32x simdSet(float s) { return {s}; }
+static inline F32x operator+(F32x a, F32x b) { return {a.v + b.v}; }
+static inline F32x operator-(F32x a, F32x b) { return {a.v - b.v}; }
+static inline F32x operator*(F32x a, F32x b) { return {a.v * b.v}; }
+static inline F32x simdMin(F32x a, F32x b) { return {a.v < b.v ? a.v : b.v}; }
+static inline F32x simdMax(F32x a, F32x b) { return {a.v > b.v ? a.v : b.v}; }
+// Scalar masks are 1.0f / 0.0f
+static inline F32x simdLessEq(F32x a, F32x b) { return {a.v <= b.v ? 1.0f : 0.0f}; }
+static inline F32x simdLess(F32x a, F32x b) { return {a.v < b.v ? 1.0f : 0.0f}; }
+static inline F32x simdGreater(F32x a, F32x b) { return {a.v > b.v ? 1.0f : 0.0f}; }
+static inline F32x simdAnd(F32x a, F32x b) { return {(a.v != 0.0f && b.v != 0.0f) ? 1.0f : 0.0f}; }
+static inline F32x simdSelect(F32x mask, F32x a, F32x b) { return {mask.v != 0.0f ? a.v : b.v}; }
+
+#endif
+
+// Rounds a lane count up to a whole number of SIMD registers.
+static inline int simdRoundUp(int count) { return (count + kSimdWidth - 1) / kSimdWidth * kSimdWidth; }
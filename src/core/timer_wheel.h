@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Hashed timing wheel for many periodic deadlines (e.g. one fixed tick per hosted match).
+// Timers are small integer ids with intrusive links, so scheduling, cancelling and firing
+// are O(1) and never allocate once the id range has been grown. Deadlines further out
+// than one revolution stay in their slot until the wheel comes round to the right tick.
+class TimerWheel {
+public:
+    // slotSeconds is the firing resolution; slots * slotSeconds should cover the usual period.
+    TimerWheel(double slotSeconds, int slots) : slotSeconds_(slotSeconds), heads_(slots, -1) {}
+
+    void schedule(int id, double when) {
+        grow(id);
+        if (armed_[id]) cancel(id);
+        int64_t t = (int64_t)std::ceil(when / slotSeconds_);
+        if (cursor_ == kUnstarted) cursor_ = t;
+        // A past deadline fires at the first slot still to be scanned: the cursor's own, or
+        // from inside advance() the next one, as the cursor's slot has already been scanned
+        const int64_t earliest = advancing_ ? cursor_ + 1 : cursor_;
+        if (t < earliest) t = earliest;
+        whenTick_[id] = t;
+        int slot = (int)(t % (int64_t)heads_.size());
+        prev_[id] = -1;
+        next_[id] = heads_[slot];
+        if (heads_[slot] >= 0) prev_[heads_[slot]] = id;
+        heads_[slot] = id;
+        armed_[id] = 1;
+        count_++;
+    }
+
+    void cancel(int id) {
+        if (id >= (int)armed_.size() || !armed_[id]) return;
+        int slot = (int)(whenTick_[id] % (int64_t)heads_.size());
+        if (prev_[id] >= 0) next_[prev_[id]] = next_[id];
+        else heads_[slot] = next_[id];
+        if (next_[id] >= 0) prev_[next_[id]] = prev_[id];
+        armed_[id] = 0;
+        count_--;
+    }
+
+    bool armed(int id) const { return id < (int)armed_.size() && armed_[id]; }
+    int count() const { return count_; }
+
+    // Fires every timer due by now, in slot order. fire(id) may reschedule id; a deadline
+    // already due then fires again later in the same call.
+    template <typename Fn>
+    void advance(double now, Fn &&fire) {
+        const int64_t target = (int64_t)std::floor(now / slotSeconds_);
+        const int64_t slots = (int64_t)heads_.size();
+        if (cursor_ == kUnstarted) cursor_ = target;
+        // After a long stall one revolution visits every slot, which already fires everything due
+        if (target - cursor_ >= slots) cursor_ = target - slots + 1;
+        advancing_ = true;
+        for (; cursor_ <= target; ++cursor_) {
+            if (count_ == 0) { cursor_ = target + 1; break; }
+            int slot = (int)(cursor_ % slots);
+            due_.clear();
+            for (int id = heads_[slot]; id >= 0; id = next_[id]) {
+                if (whenTick_[id] <= cursor_) due_.push_back(id);
+            }
+            for (int id : due_) {
+                cancel(id);
+                fire(id);
+            }
+        }
+        advancing_ = false;
+    }
+
+    // Start of the next slot holding a timer, scanning at most one revolution ahead;
+    // now + one revolution if nothing is that close. For sizing a poll timeout.
+    double nextDeadline(double now) const {
+        int64_t start = (int64_t)std::floor(now / slotSeconds_);
+        if (cursor_ != kUnstarted && cursor_ < start) start = cursor_;
+        const int64_t slots = (int64_t)heads_.size();
+        for (int64_t t = start; t < start + slots; ++t) {
+            for (int id = heads_[(int)(t % slots)]; id >= 0; id = next_[id]) {
+                if (whenTick_[id] <= t) return (double)t * slotSeconds_;
+            }
+        }
+        return now + (double)slots * slotSeconds_;
+    }
+
+private:
+    static constexpr int64_t kUnstarted = INT64_MIN;
+
+    void grow(int id) {
+        if (id < (int)armed_.size()) return;
+        size_t n = (size_t)id + 1;
+        next_.resize(n, -1);
+        prev_.resize(n, -1);
+        whenTick_.resize(n, 0);
+        armed_.resize(n, 0);
+    }
+
+    double slotSeconds_;
+    std::vector<int> heads_;
+    std::vector<int> next_;
+    std::vector<int> prev_;
+    std::vector<int64_t> whenTick_;
+    std::vector<uint8_t> armed_;
+    std::vector<int> due_;
+    int64_t cursor_ = kUnstarted;
+    int count_ = 0;
+    bool advancing_ = false;    // inside advance(), where the cursor's slot is already scanned
+};
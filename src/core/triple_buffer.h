@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+
+// Single-producer/single-consumer hand-off of the newest value, without locks or waiting.
+// Three slots: the producer owns one (back), the consumer owns one (front) and the third is
+// the one most recently published. publish() swaps back with it and acquire() swaps front
+// with it when something new arrived, so neither side ever sees a slot the other is using.
+// The consumer may skip values (it only ever gets the latest) but never sees a torn one.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer: fill writeSlot() completely, then publish(). The slot may hold an old value.
+    T &writeSlot() { return slots_[back_]; }
+
+    void publish() {
+        int previous = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+    }
+
+    // Consumer: the newest published value; stays valid (and unchanged) until the next call.
+    const T &acquire() {
+        if (middle_.load(std::memory_order_relaxed) & kFresh) {
+            int previous = middle_.exchange(front_, std::memory_order_acq_rel);
+            front_ = previous & kIndexMask;
+        }
+        return slots_[front_];
+    }
+
+private:
+    static constexpr int kIndexMask = 3;
+    static constexpr int kFresh = 4;
+
+    T slots_[3];
+    // back_ and front_ each belong to one thread; keep them and the shared index on separate lines
+    alignas(64) std::atomic<int> middle_{1};
+    alignas(64) int back_ = 0;
+    alignas(64) int front_ = 2;
+};
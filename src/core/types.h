@@ -1,12 +1,16 @@
 #pragma once
 
-#include "raylib.h"
 #include <vector>
 
-enum class GameState { Menu, ModeSelect, MapSelect, CharacterSelect, Settings, Arena, Pause, Exit };
+enum class GameState { Menu, ModeSelect, MapSelect, CharacterSelect, Settings, Arena, Pause, Replay, Exit };
 enum class ViewMode { FirstPerson, ThirdPerson };
-enum class MapType { Green, Desert };
-
-struct AABB { Vector3 min; Vector3 max; };
+// Texture resolution tier; the value is how many top mip levels of the baked chain are skipped.
+enum class TextureQuality { High = 0, Medium = 1, Low = 2 };
 
+// Plain value types shared by the simulation and the client. They deliberately
+// do not come from raylib so the sim library builds without any graphics dependency;
+// render/rl_convert.h maps them onto raylib's Vector3/Color.
+struct Vec3 { float x; float y; float z; };
+struct Rgba { unsigned char r; unsigned char g; unsigned char b; unsigned char a; };
 
+struct AABB { Vec3 min; Vec3 max; };
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+struct CharacterDef {
+    std::string name;
+    std::string gltfPath;
+    std::string textureDir;
+};
+
+// Character indices in match state, snapshots and replays are below this
+constexpr int kCharacterCount = 2;
+
+static const std::array<CharacterDef, kCharacterCount> kCharacters = {{
+    {"Asgore", "models/asgore/scene.gltf", "models/asgore/textures"},
+    {"Metrocop", "models/metrocop/scene.gltf", "models/metrocop/textures"}
+}};
@@ -0,0 +1,172 @@
+#include "game/map_file.h"
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include "assets/cache_io.h"
+
+static_assert(sizeof(AABB) == 24 && sizeof(Vec3) == 12, "map file stores AABB/Vec3 as packed floats");
+
+static const uint64_t kMaxGridCells = 1u << 22;    // matches buildObstacleGrid's cap
+
+static uint64_t alignUp(uint64_t v) { return (v + 15) & ~(uint64_t)15; }
+
+static bool parseColor(std::istringstream &in, Rgba &out) {
+    int c[4];
+    if (!(in >> c[0] >> c[1] >> c[2] >> c[3])) return false;
+    for (int v : c) {
+        if (v < 0 || v > 255) return false;
+    }
+    out = Rgba{(unsigned char)c[0], (unsigned char)c[1], (unsigned char)c[2], (unsigned char)c[3]};
+    return true;
+}
+
+bool parseMapText(const std::string &text, MapSource &out, std::string &error) {
+    out = MapSource{};
+    std::istringstream lines(text);
+    std::string line;
+    bool haveArena = false;
+    for (int lineNo = 1; std::getline(lines, line); ++lineNo) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        std::istringstream in(line);
+        std::string keyword;
+        if (!(in >> keyword)) continue;
+        bool ok = true;
+        if (keyword == "arena") {
+            Vec3 &a = out.arenaSize;
+            ok = (in >> a.x >> a.y >> a.z) && a.x > 0.0f && a.z > 0.0f;
+            haveArena = ok;
+        } else if (keyword == "arena_color") {
+            ok = parseColor(in, out.arenaColor);
+        } else if (keyword == "obstacle_color") {
+            ok = parseColor(in, out.obstacleColor);
+        } else if (keyword == "spawn") {
+            Vec3 p;
+            ok = (bool)(in >> p.x >> p.y >> p.z);
+            if (ok) out.spawns.push_back(p);
+        } else if (keyword == "box") {
+            AABB b;
+            ok = (in >> b.min.x >> b.min.y >> b.min.z >> b.max.x >> b.max.y >> b.max.z) &&
+                 b.min.x < b.max.x && b.min.y < b.max.y && b.min.z < b.max.z;
+            if (ok) out.obstacles.push_back(b);
+        } else {
+            error = "line " + std::to_string(lineNo) + ": unknown statement '" + keyword + "'";
+            return false;
+        }
+        std::string extra;
+        if (!ok || (in >> extra)) {
+            error = "line " + std::to_string(lineNo) + ": bad '" + keyword + "' statement";
+            return false;
+        }
+    }
+    if (!haveArena) {
+        error = "missing 'arena W H D'";
+        return false;
+    }
+    return true;
+}
+
+bool writeMapFile(const std::string &path, const MapSource &source, bool withGrid) {
+    ObstacleGrid grid;
+    ObstacleGridCells cells;
+    if (withGrid) buildObstacleGrid(grid, cells, source.obstacles.data(), (int)source.obstacles.size());
+
+    MapFileHeader header{};
+    header.magic = kMapFileMagic;
+    header.version = kMapFileVersion;
+    header.arenaSize[0] = source.arenaSize.x;
+    header.arenaSize[1] = source.arenaSize.y;
+    header.arenaSize[2] = source.arenaSize.z;
+    std::memcpy(header.arenaColor, &source.arenaColor, 4);
+    std::memcpy(header.obstacleColor, &source.obstacleColor, 4);
+    header.obstacleCount = (uint32_t)source.obstacles.size();
+    header.spawnCount = (uint32_t)source.spawns.size();
+
+    uint64_t offset = alignUp(sizeof(MapFileHeader));
+    auto place = [&](uint64_t bytes) -> uint64_t {
+        if (bytes == 0) return 0;
+        uint64_t at = offset;
+        offset = alignUp(offset + bytes);
+        return at;
+    };
+    header.obstacles = place(sizeof(AABB) * source.obstacles.size());
+    header.spawns = place(sizeof(Vec3) * source.spawns.size());
+    if (!grid.empty()) {
+        header.gridOrigin[0] = grid.originX;
+        header.gridOrigin[1] = grid.originZ;
+        header.gridCellSize = grid.cellSize;
+        header.gridCellsX = grid.cellsX;
+        header.gridCellsZ = grid.cellsZ;
+        header.gridItemCount = (uint32_t)cells.cellItems.size();
+        header.gridCellStart = place(sizeof(uint32_t) * cells.cellStart.size());
+        header.gridCellItems = place(sizeof(uint32_t) * cells.cellItems.size());
+    }
+
+    std::vector<unsigned char> blob(offset, 0);
+    std::memcpy(blob.data(), &header, sizeof(header));
+    auto copy = [&](uint64_t at, const void *src, size_t bytes) {
+        if (at) std::memcpy(&blob[at], src, bytes);
+    };
+    copy(header.obstacles, source.obstacles.data(), sizeof(AABB) * source.obstacles.size());
+    copy(header.spawns, source.spawns.data(), sizeof(Vec3) * source.spawns.size());
+    copy(header.gridCellStart, cells.cellStart.data(), sizeof(uint32_t) * cells.cellStart.size());
+    copy(header.gridCellItems, cells.cellItems.data(), sizeof(uint32_t) * cells.cellItems.size());
+    return writeFileAtomic(path, blob.data(), blob.size());
+}
+
+bool parseMapFile(const unsigned char *data, size_t size, MapData &out) {
+    if (!data || size < sizeof(MapFileHeader)) return false;
+    MapFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kMapFileMagic || header.version != kMapFileVersion) return false;
+    if (!(header.arenaSize[0] > 0.0f) || !(header.arenaSize[2] > 0.0f)) return false;
+
+    auto section = [&](uint64_t offset, uint64_t bytes, const void *&ptr) {
+        ptr = nullptr;
+        if (offset == 0) return bytes == 0;
+        if (offset % 16 != 0 || offset > size || bytes > size - offset) return false;
+        ptr = data + offset;
+        return true;
+    };
+    const void *obstacles = nullptr, *spawns = nullptr;
+    if (header.obstacleCount > (uint32_t)INT32_MAX || header.spawnCount > (uint32_t)INT32_MAX) return false;
+    if (!section(header.obstacles, sizeof(AABB) * (uint64_t)header.obstacleCount, obstacles)) return false;
+    if (!section(header.spawns, sizeof(Vec3) * (uint64_t)header.spawnCount, spawns)) return false;
+
+    out = MapData{};
+    out.arenaSize = {header.arenaSize[0], header.arenaSize[1], header.arenaSize[2]};
+    std::memcpy(&out.arenaColor, header.arenaColor, 4);
+    std::memcpy(&out.obstacleColor, header.obstacleColor, 4);
+    out.obstacles = (const AABB *)obstacles;
+    out.obstacleCount = (int)header.obstacleCount;
+    out.spawns = (const Vec3 *)spawns;
+    out.spawnCount = (int)header.spawnCount;
+
+    if (header.gridCellsX == 0) return true;
+    if (header.gridCellsX < 0 || header.gridCellsZ <= 0 || !(header.gridCellSize > 0.0f)) return false;
+    const uint64_t cellCount = (uint64_t)header.gridCellsX * (uint64_t)header.gridCellsZ;
+    if (cellCount > kMaxGridCells) return false;
+    const void *cellStart = nullptr, *cellItems = nullptr;
+    if (!section(header.gridCellStart, sizeof(uint32_t) * (cellCount + 1), cellStart) || !cellStart) return false;
+    if (!section(header.gridCellItems, sizeof(uint32_t) * (uint64_t)header.gridItemCount, cellItems)) return false;
+    const uint32_t *starts = (const uint32_t *)cellStart;
+    const uint32_t *items = (const uint32_t *)cellItems;
+    if (starts[0] != 0 || starts[cellCount] != header.gridItemCount) return false;
+    for (uint64_t c = 0; c < cellCount; ++c) {
+        if (starts[c] > starts[c + 1]) return false;
+    }
+    for (uint32_t i = 0; i < header.gridItemCount; ++i) {
+        if (items[i] >= header.obstacleCount) return false;
+    }
+    ObstacleGrid &grid = out.obstacleGrid;
+    grid.originX = header.gridOrigin[0];
+    grid.originZ = header.gridOrigin[1];
+    grid.cellSize = header.gridCellSize;
+    grid.invCellSize = 1.0f / header.gridCellSize;
+    grid.cellsX = header.gridCellsX;
+    grid.cellsZ = header.gridCellsZ;
+    grid.cellStart = starts;
+    grid.cellItems = items;
+    return true;
+}
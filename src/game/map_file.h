@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "game/maps.h"
+
+// Binary map file (.ebmap), written by epiCBattle_mapbake from a text description and
+// memory-mapped at load: MapData points straight at the arrays inside the file, so
+// opening a map costs a page-table entry per touched page, not a parse.
+//
+// Layout: MapFileHeader, then the obstacle AABBs, spawn points and (optionally) the
+// precomputed ObstacleGrid CSR arrays, each 16-byte aligned. Offsets are from the start
+// of the file. Any file in maps/ gets loaded, so loading checks the header, section sizes
+// and bounds, and that the grid's cell ranges ascend and every item names an obstacle:
+// grid queries index with them unchecked.
+
+constexpr uint32_t kMapFileMagic = 0x504D4245;     // "EBMP"
+constexpr uint32_t kMapFileVersion = 1;
+constexpr const char *kMapFileExtension = ".ebmap";
+
+struct MapFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    float arenaSize[3];
+    uint8_t arenaColor[4];
+    uint8_t obstacleColor[4];
+    uint32_t obstacleCount;
+    uint32_t spawnCount;
+    uint32_t reserved;
+    uint64_t obstacles;         // AABB per obstacle
+    uint64_t spawns;            // Vec3 per spawn point, 0 if none
+    // Precomputed ObstacleGrid; cellsX == 0 when the file has none
+    float gridOrigin[2];
+    float gridCellSize;
+    int32_t gridCellsX;
+    int32_t gridCellsZ;
+    uint32_t gridItemCount;
+    uint64_t gridCellStart;     // cellsX * cellsZ + 1 u32 offsets
+    uint64_t gridCellItems;     // gridItemCount u32 obstacle indices
+};
+
+// Text format, one statement per line, '#' starts a comment:
+//   arena W H D                  arena_color R G B A        obstacle_color R G B A
+//   spawn X Y Z                  box MINX MINY MINZ MAXX MAXY MAXZ
+// Returns false with a "line N: ..." message on malformed input.
+bool parseMapText(const std::string &text, MapSource &out, std::string &error);
+
+// Bakes source into a .ebmap, with the broadphase grid precomputed unless withGrid is false.
+bool writeMapFile(const std::string &path, const MapSource &source, bool withGrid = true);
+
+// Validates the blob and points out at the arrays inside it (no copies). out.obstacleGrid
+// is left empty when the file carries no grid.
+bool parseMapFile(const unsigned char *data, size_t size, MapData &out);
@@ -0,0 +1,67 @@
+#include "game/map_geometry.h"
+
+static const Rgba kSpawnMarkerColors[2] = {
+    {230, 41, 55, 255},     // P1 side, raylib RED
+    {0, 121, 241, 255},     // P2 side, raylib BLUE
+};
+
+static float axis(const Vec3 &v, int a) { return a == 0 ? v.x : (a == 1 ? v.y : v.z); }
+
+static StaticMeshChunk &chunkFor(std::vector<StaticMeshChunk> &chunks, int vertices) {
+    if (chunks.empty() || chunks.back().vertexCount() + vertices > kMaxChunkVertices) chunks.emplace_back();
+    return chunks.back();
+}
+
+// Appends one quad, wound counter-clockwise when seen from the side normal points to
+// (raylib culls back faces).
+static void addQuad(StaticMeshChunk &chunk, const Vec3 corners[4], const Vec3 &normal, Rgba color) {
+    Vec3 e1 = {corners[1].x - corners[0].x, corners[1].y - corners[0].y, corners[1].z - corners[0].z};
+    Vec3 e2 = {corners[2].x - corners[0].x, corners[2].y - corners[0].y, corners[2].z - corners[0].z};
+    Vec3 cross = {e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x};
+    bool flip = cross.x * normal.x + cross.y * normal.y + cross.z * normal.z < 0.0f;
+    unsigned short base = (unsigned short)chunk.vertexCount();
+    for (int i = 0; i < 4; ++i) {
+        const Vec3 &c = corners[flip ? 3 - i : i];
+        chunk.positions.insert(chunk.positions.end(), {c.x, c.y, c.z});
+        chunk.colors.insert(chunk.colors.end(), {color.r, color.g, color.b, color.a});
+    }
+    const unsigned short quad[6] = {0, 1, 2, 0, 2, 3};
+    for (unsigned short q : quad) chunk.indices.push_back((unsigned short)(base + q));
+}
+
+static void addBox(std::vector<StaticMeshChunk> &chunks, const AABB &box, Rgba color) {
+    StaticMeshChunk &chunk = chunkFor(chunks, 24);
+    for (int a = 0; a < 3; ++a) {
+        const int b = (a + 1) % 3;
+        const int c = (a + 2) % 3;
+        for (int side = 0; side < 2; ++side) {
+            float fixed = side ? axis(box.max, a) : axis(box.min, a);
+            // Walk the face's corners in cyclic order over the two other axes
+            const int walk[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+            Vec3 corners[4];
+            for (int k = 0; k < 4; ++k) {
+                float v[3];
+                v[a] = fixed;
+                v[b] = walk[k][0] ? axis(box.max, b) : axis(box.min, b);
+                v[c] = walk[k][1] ? axis(box.max, c) : axis(box.min, c);
+                corners[k] = {v[0], v[1], v[2]};
+            }
+            float n[3] = {0.0f, 0.0f, 0.0f};
+            n[a] = side ? 1.0f : -1.0f;
+            addQuad(chunk, corners, {n[0], n[1], n[2]}, color);
+        }
+    }
+}
+
+std::vector<StaticMeshChunk> buildStaticGeometry(const MapData &map) {
+    std::vector<StaticMeshChunk> chunks;
+    const float hx = map.arenaSize.x * 0.5f;
+    const float hz = map.arenaSize.z * 0.5f;
+    const Vec3 ground[4] = {{-hx, 0.0f, -hz}, {hx, 0.0f, -hz}, {hx, 0.0f, hz}, {-hx, 0.0f, hz}};
+    addQuad(chunkFor(chunks, 4), ground, {0.0f, 1.0f, 0.0f}, map.arenaColor);
+    for (int i = 0; i < map.obstacleCount; ++i) addBox(chunks, map.obstacles[i], map.obstacleColor);
+    // Spawn-side markers on the arena edges
+    addBox(chunks, {{-hx - 0.5f, 0.0f, -0.5f}, {-hx + 0.5f, 1.0f, 0.5f}}, kSpawnMarkerColors[0]);
+    addBox(chunks, {{hx - 0.5f, 0.0f, -0.5f}, {hx + 0.5f, 1.0f, 0.5f}}, kSpawnMarkerColors[1]);
+    return chunks;
+}
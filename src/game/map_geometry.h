@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include "core/types.h"
+#include "game/maps.h"
+
+// Merged static geometry for a map: the ground, every obstacle and the two spawn markers
+// baked into a few vertex-colored triangle lists, so the client draws the whole arena
+// with one draw call per chunk instead of one per box.
+
+// 16-bit indices (raylib's mesh index type) cap each chunk at 65536 vertices.
+constexpr int kMaxChunkVertices = 65536;
+
+struct StaticMeshChunk {
+    std::vector<float> positions;           // float3 per vertex
+    std::vector<unsigned char> colors;      // ubyte4 per vertex
+    std::vector<unsigned short> indices;    // 3 per triangle
+
+    int vertexCount() const { return (int)positions.size() / 3; }
+    int triangleCount() const { return (int)indices.size() / 3; }
+};
+
+std::vector<StaticMeshChunk> buildStaticGeometry(const MapData &map);
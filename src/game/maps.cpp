@@ -0,0 +1,57 @@
+#include "game/maps.h"
+
+#include <algorithm>
+#include <filesystem>
+#include "game/map_file.h"
+
+namespace fs = std::filesystem;
+
+bool GameMap::open(const std::string &path) {
+    MappedFile file;
+    MapData data;
+    if (!file.open(path.c_str()) || !parseMapFile(file.data(), file.size(), data)) return false;
+    *this = GameMap{};
+    file_ = std::move(file);
+    data_ = data;
+    if (data_.obstacleGrid.empty()) buildObstacleGrid(data_.obstacleGrid, cells_, data_.obstacles, data_.obstacleCount);
+    name_ = fs::path(path).stem().string();
+    return true;
+}
+
+void GameMap::build(const std::string &name, const MapSource &source) {
+    *this = GameMap{};
+    source_ = source;
+    data_.arenaSize = source_.arenaSize;
+    data_.arenaColor = source_.arenaColor;
+    data_.obstacleColor = source_.obstacleColor;
+    data_.obstacles = source_.obstacles.data();
+    data_.obstacleCount = (int)source_.obstacles.size();
+    data_.spawns = source_.spawns.data();
+    data_.spawnCount = (int)source_.spawns.size();
+    buildObstacleGrid(data_.obstacleGrid, cells_, data_.obstacles, data_.obstacleCount);
+    name_ = name;
+}
+
+std::vector<std::string> listMaps(const std::string &dir) {
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(dir, ec)) {
+        if (entry.path().extension() == kMapFileExtension) names.push_back(entry.path().stem().string());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool isMapName(const std::string &name) {
+    if (name.empty()) return false;
+    for (char c : name) {
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+std::string mapFilePath(const std::string &nameOrPath) {
+    if (fs::path(nameOrPath).extension() == kMapFileExtension) return nameOrPath;
+    return (fs::path(kMapDirectory) / (nameOrPath + kMapFileExtension)).string();
+}
@@ -1,31 +1,69 @@
 #pragma once
 
-#include "raylib.h"
+#include <string>
 #include <vector>
+#include "core/mapped_file.h"
 #include "core/types.h"
+#include "game/obstacle_grid.h"
 
+// A map as the sim and renderer see it. Plain view: the arrays live in a GameMap (a mapped
+// .ebmap file, or arrays built from a MapSource), which must outlive every MapData copy.
 struct MapData {
-    Vector3 arenaSize;
-    Color arenaColor;
+    Vec3 arenaSize = {0.0f, 0.0f, 0.0f};
+    Rgba arenaColor = {0, 0, 0, 255};
+    Rgba obstacleColor = {0, 0, 0, 255};
+    const AABB *obstacles = nullptr;
+    int obstacleCount = 0;
+    const Vec3 *spawns = nullptr;   // optional; used when there is one per player
+    int spawnCount = 0;
+    ObstacleGrid obstacleGrid;      // broadphase over obstacles
+};
+
+// What a map is made of before it is baked: the text format (game/map_file.h) parses
+// into this, and benchmarks that generate arenas fill it directly.
+struct MapSource {
+    Vec3 arenaSize = {30.0f, 1.0f, 30.0f};
+    Rgba arenaColor = {0, 117, 44, 255};
+    Rgba obstacleColor = {130, 130, 130, 255};
     std::vector<AABB> obstacles;
+    std::vector<Vec3> spawns;
+};
+
+// Owns a map's storage. Move-only; data() stays valid (same arrays) across moves.
+class GameMap {
+public:
+    GameMap() = default;
+    GameMap(const GameMap &) = delete;
+    GameMap &operator=(const GameMap &) = delete;
+    GameMap(GameMap &&) noexcept = default;
+    GameMap &operator=(GameMap &&) noexcept = default;
+
+    // Maps a .ebmap and uses it in place. The grid is built here only if the file lacks one.
+    bool open(const std::string &path);
+    // Takes a copy of source and builds the grid.
+    void build(const std::string &name, const MapSource &source);
+
+    const MapData &data() const { return data_; }
+    const std::string &name() const { return name_; }
+    bool loaded() const { return !name_.empty(); }
+
+private:
+    MappedFile file_;
+    MapSource source_;
+    ObstacleGridCells cells_;
+    MapData data_;
+    std::string name_;
 };
 
-static inline MapData loadMapData(MapType mapType) {
-    MapData data{};
-    if (mapType == MapType::Green) {
-        data.arenaSize = {30.0f, 1.0f, 30.0f};
-        data.arenaColor = DARKGREEN;
-        data.obstacles.push_back({ {-0.75f, 0.0f, -0.75f}, {0.75f, 1.5f, 0.75f} });
-        data.obstacles.push_back({ {-6.5f, 0.0f,  2.5f}, {-5.5f, 1.0f, 5.5f} });
-        data.obstacles.push_back({ { 5.5f, 0.0f, -5.5f}, { 6.5f, 1.0f,-2.5f} });
-    } else {
-        data.arenaSize = {36.0f, 1.0f, 22.0f};
-        data.arenaColor = Color{200, 180, 120, 255};
-        data.obstacles.push_back({ {-2.5f, 0.0f, -1.0f}, {2.5f, 1.2f, 1.0f} });
-        data.obstacles.push_back({ {-12.0f,0.0f, -9.0f}, {-9.0f, 1.0f,-6.0f} });
-        data.obstacles.push_back({ {  9.0f,0.0f,  6.0f}, {12.0f, 1.0f, 9.0f} });
-    }
-    return data;
-}
+// Maps ship as <kMapDirectory>/<name>.ebmap next to the executables.
+constexpr const char *kMapDirectory = "maps";
+
+// Names (file stems) of the .ebmap files in dir, sorted.
+std::vector<std::string> listMaps(const std::string &dir = kMapDirectory);
 
+// True for a bare map name: letters, digits, '_' and '-' only, so it cannot reach outside
+// kMapDirectory. Names from the network and from replay files are checked with this.
+bool isMapName(const std::string &name);
 
+// "desert" -> "maps/desert.ebmap"; anything already naming a .ebmap file is returned as is.
+std::string mapFilePath(const std::string &nameOrPath);
@@ -0,0 +1,155 @@
+#include "game/obstacle_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const int kMaxCells = 1 << 22;
+
+static bool boxContains(const AABB &b, Vec3 p) {
+    return p.x > b.min.x && p.x < b.max.x && p.y >= b.min.y && p.y <= b.max.y && p.z > b.min.z && p.z < b.max.z;
+}
+
+// Slab test against the segment a + t*(b-a), t in [0,1].
+static bool segmentHitsBox(const AABB &box, Vec3 a, Vec3 b) {
+    const float o[3] = {a.x, a.y, a.z};
+    const float d[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+    const float mn[3] = {box.min.x, box.min.y, box.min.z};
+    const float mx[3] = {box.max.x, box.max.y, box.max.z};
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (std::fabs(d[axis]) < 1e-8f) {
+            if (o[axis] <= mn[axis] || o[axis] >= mx[axis]) return false;
+            continue;
+        }
+        float inv = 1.0f / d[axis];
+        float t0 = (mn[axis] - o[axis]) * inv;
+        float t1 = (mx[axis] - o[axis]) * inv;
+        if (t0 > t1) std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin >= tMax) return false;
+    }
+    return true;
+}
+
+static int cellCoord(float v, float origin, float invCell, int count) {
+    int c = (int)std::floor((v - origin) * invCell);
+    return std::clamp(c, 0, count - 1);
+}
+
+void buildObstacleGrid(ObstacleGrid &grid, ObstacleGridCells &cells, const AABB *obstacles, int count) {
+    grid = ObstacleGrid{};
+    cells = ObstacleGridCells{};
+    if (count <= 0) return;
+
+    float minX = obstacles[0].min.x, maxX = obstacles[0].max.x;
+    float minZ = obstacles[0].min.z, maxZ = obstacles[0].max.z;
+    double extentSum = 0.0;
+    for (int i = 0; i < count; ++i) {
+        const AABB &b = obstacles[i];
+        minX = std::min(minX, b.min.x); maxX = std::max(maxX, b.max.x);
+        minZ = std::min(minZ, b.min.z); maxZ = std::max(maxZ, b.max.z);
+        extentSum += std::max(b.max.x - b.min.x, b.max.z - b.min.z);
+    }
+    float width = std::max(maxX - minX, 1e-3f);
+    float depth = std::max(maxZ - minZ, 1e-3f);
+
+    // Aim for about one obstacle per cell, but never smaller than a typical obstacle so
+    // boxes do not get copied into lots of cells.
+    float meanExtent = (float)(extentSum / count);
+    float cell = std::sqrt(width * depth / (float)count);
+    cell = std::max(cell, meanExtent);
+    while ((double)std::ceil(width / cell) * std::ceil(depth / cell) > kMaxCells) cell *= 1.5f;
+
+    grid.originX = minX;
+    grid.originZ = minZ;
+    grid.cellSize = cell;
+    grid.invCellSize = 1.0f / cell;
+    grid.cellsX = std::max(1, (int)std::ceil(width / cell));
+    grid.cellsZ = std::max(1, (int)std::ceil(depth / cell));
+
+    const size_t cellCount = (size_t)grid.cellsX * grid.cellsZ;
+    std::vector<uint32_t> counts(cellCount + 1, 0);
+    auto forEachCell = [&](const AABB &b, auto &&fn) {
+        int x0 = cellCoord(b.min.x, grid.originX, grid.invCellSize, grid.cellsX);
+        int x1 = cellCoord(b.max.x, grid.originX, grid.invCellSize, grid.cellsX);
+        int z0 = cellCoord(b.min.z, grid.originZ, grid.invCellSize, grid.cellsZ);
+        int z1 = cellCoord(b.max.z, grid.originZ, grid.invCellSize, grid.cellsZ);
+        for (int z = z0; z <= z1; ++z)
+            for (int x = x0; x <= x1; ++x) fn((size_t)z * grid.cellsX + x);
+    };
+    for (int i = 0; i < count; ++i) forEachCell(obstacles[i], [&](size_t c) { counts[c + 1]++; });
+    for (size_t c = 0; c < cellCount; ++c) counts[c + 1] += counts[c];
+    cells.cellStart = counts;
+    cells.cellItems.resize(counts[cellCount]);
+    for (uint32_t i = 0; i < (uint32_t)count; ++i) {
+        forEachCell(obstacles[i], [&](size_t c) { cells.cellItems[counts[c]++] = i; });
+    }
+    grid.cellStart = cells.cellStart.data();
+    grid.cellItems = cells.cellItems.data();
+}
+
+// Returns the cell holding (x, z), or -1 if it lies outside the grid (no obstacles there).
+static long cellAt(const ObstacleGrid &grid, float x, float z) {
+    if (grid.empty()) return -1;
+    float fx = (x - grid.originX) * grid.invCellSize;
+    float fz = (z - grid.originZ) * grid.invCellSize;
+    if (fx < 0.0f || fz < 0.0f || fx >= (float)grid.cellsX || fz >= (float)grid.cellsZ) return -1;
+    return (long)fz * grid.cellsX + (long)fx;
+}
+
+bool obstacleContainsPoint(const ObstacleGrid &grid, const AABB *obstacles, Vec3 p) {
+    long c = cellAt(grid, p.x, p.z);
+    if (c < 0) return false;
+    for (uint32_t k = grid.cellStart[c]; k < grid.cellStart[c + 1]; ++k) {
+        if (boxContains(obstacles[grid.cellItems[k]], p)) return true;
+    }
+    return false;
+}
+
+bool obstacleBlocksSegment(const ObstacleGrid &grid, const AABB *obstacles, Vec3 a, Vec3 b) {
+    if (grid.empty()) return false;
+    // 2D DDA over the cells the segment's XZ projection crosses
+    float fx = (a.x - grid.originX) * grid.invCellSize;
+    float fz = (a.z - grid.originZ) * grid.invCellSize;
+    float dx = (b.x - a.x) * grid.invCellSize;
+    float dz = (b.z - a.z) * grid.invCellSize;
+    int cx = (int)std::floor(fx);
+    int cz = (int)std::floor(fz);
+    const int endX = (int)std::floor(fx + dx);
+    const int endZ = (int)std::floor(fz + dz);
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepZ = dz > 0.0f ? 1 : -1;
+    const float inf = 1e30f;
+    float tDeltaX = dx != 0.0f ? std::fabs(1.0f / dx) : inf;
+    float tDeltaZ = dz != 0.0f ? std::fabs(1.0f / dz) : inf;
+    float tMaxX = dx != 0.0f ? ((stepX > 0 ? (cx + 1 - fx) : (fx - cx)) * tDeltaX) : inf;
+    float tMaxZ = dz != 0.0f ? ((stepZ > 0 ? (cz + 1 - fz) : (fz - cz)) * tDeltaZ) : inf;
+    const int maxSteps = std::abs(endX - cx) + std::abs(endZ - cz) + 1;
+    for (int step = 0; step < maxSteps; ++step) {
+        if (cx >= 0 && cz >= 0 && cx < grid.cellsX && cz < grid.cellsZ) {
+            size_t c = (size_t)cz * grid.cellsX + cx;
+            for (uint32_t k = grid.cellStart[c]; k < grid.cellStart[c + 1]; ++k) {
+                if (segmentHitsBox(obstacles[grid.cellItems[k]], a, b)) return true;
+            }
+        }
+        if (tMaxX < tMaxZ) { cx += stepX; tMaxX += tDeltaX; }
+        else { cz += stepZ; tMaxZ += tDeltaZ; }
+    }
+    return false;
+}
+
+bool obstacleContainsPointLinear(const AABB *obstacles, int count, Vec3 p) {
+    for (int i = 0; i < count; ++i) {
+        if (boxContains(obstacles[i], p)) return true;
+    }
+    return false;
+}
+
+bool obstacleBlocksSegmentLinear(const AABB *obstacles, int count, Vec3 a, Vec3 b) {
+    for (int i = 0; i < count; ++i) {
+        if (segmentHitsBox(obstacles[i], a, b)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/types.h"
+
+// Static uniform grid over the XZ plane for MapData::obstacles. Each cell stores the
+// indices of the obstacles overlapping it (CSR layout), so point/ground/segment queries
+// only look at the boxes near the query. The arrays are views: a map file stores the grid
+// precomputed and the sim queries it in place; otherwise buildObstacleGrid fills
+// ObstacleGridCells and points the grid at them.
+struct ObstacleGrid {
+    float originX = 0.0f;
+    float originZ = 0.0f;
+    float cellSize = 1.0f;
+    float invCellSize = 1.0f;
+    int cellsX = 0;
+    int cellsZ = 0;
+    const uint32_t *cellStart = nullptr;    // cellsX * cellsZ + 1 offsets into cellItems
+    const uint32_t *cellItems = nullptr;    // obstacle indices
+
+    bool empty() const { return cellsX == 0; }
+    size_t cellCount() const { return (size_t)cellsX * (size_t)cellsZ; }
+    uint32_t itemCount() const { return empty() ? 0 : cellStart[cellCount()]; }
+};
+
+// Backing storage for a grid built at load time.
+struct ObstacleGridCells {
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellItems;
+};
+
+void buildObstacleGrid(ObstacleGrid &grid, ObstacleGridCells &cells, const AABB *obstacles, int count);
+
+// True if p lies inside any obstacle (x/z exclusive, y inclusive), the same test the linear
+// scan in the tick always made.
+bool obstacleContainsPoint(const ObstacleGrid &grid, const AABB *obstacles, Vec3 p);
+
+// True if the segment a-b passes through any obstacle. Walks the grid cells along the segment.
+bool obstacleBlocksSegment(const ObstacleGrid &grid, const AABB *obstacles, Vec3 a, Vec3 b);
+
+// Reference linear scans, kept for the broadphase benchmark and for verifying the grid.
+bool obstacleContainsPointLinear(const AABB *obstacles, int count, Vec3 p);
+bool obstacleBlocksSegmentLinear(const AABB *obstacles, int count, Vec3 a, Vec3 b);
@@ -0,0 +1,105 @@
+#include "input/input_sampler.h"
+
+#include <cmath>
+#include "raymath.h"
+
+// raylib's desktop backend is GLFW; glfwPollEvents only runs its callbacks, which update the
+// current key/mouse state, while PollInputEvents() would also roll the previous-frame state
+extern "C" void glfwPollEvents(void);
+
+struct ButtonBinding {
+    int player;
+    int key;
+    bool mouse;
+    uint8_t button;
+};
+
+static const ButtonBinding kButtonBindings[] = {
+    {0, KEY_LEFT_SHIFT, false, kButtonSprint},
+    {0, KEY_SPACE, false, kButtonJump},
+    {0, MOUSE_BUTTON_LEFT, true, kButtonLight},
+    {0, MOUSE_BUTTON_RIGHT, true, kButtonHeavy},
+    {1, KEY_RIGHT_SHIFT, false, kButtonSprint},
+    {1, KEY_RIGHT_SHIFT, false, kButtonJump},
+    {1, KEY_RIGHT_CONTROL, false, kButtonLight},
+    {1, KEY_RIGHT_ALT, false, kButtonHeavy},
+};
+
+struct MoveBinding {
+    int forward, back, left, right;
+};
+
+static const MoveBinding kMoveBindings[2] = {
+    {KEY_W, KEY_S, KEY_A, KEY_D},
+    {KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT},
+};
+
+static const uint8_t kHeldButtons = kButtonSprint | kButtonLook;
+
+void InputSampler::sample(double now, InputQueue &queue) {
+    auto emit = [&](int player, uint8_t type, uint8_t button) {
+        InputEvent e = {};
+        e.time = now;
+        e.player = (uint8_t)player;
+        e.type = type;
+        e.button = button;
+        e.moveX = last_[player].moveX;
+        e.moveZ = last_[player].moveZ;
+        e.yaw = last_[player].yaw;
+        queue.push(e);
+    };
+
+    if (firstPerson_) {
+        // Only the part of raylib's delta that earlier samples this frame have not used yet
+        Vector2 delta = GetMouseDelta();
+        float dx = delta.x - consumedDelta_.x;
+        float dy = delta.y - consumedDelta_.y;
+        consumedDelta_ = delta;
+        lookYaw_ -= dx * 0.01f * sensitivity_;
+        lookYaw_ -= 6.2831853f * floorf(lookYaw_ / 6.2831853f);
+        lookPitch_ = Clamp(lookPitch_ - dy * 0.01f * sensitivity_, -1.3f, 1.3f);
+        uint16_t yaw = quantizeInputYaw(lookYaw_);
+        if (yaw != last_[0].yaw) {
+            last_[0].yaw = yaw;
+            emit(0, kInputLook, 0);
+        }
+    }
+
+    uint8_t down[2] = {(uint8_t)(firstPerson_ ? kButtonLook : 0), 0};
+    for (const ButtonBinding &b : kButtonBindings) {
+        if (b.mouse ? IsMouseButtonDown(b.key) : IsKeyDown(b.key)) down[b.player] |= b.button;
+    }
+    for (int p = 0; p < 2; ++p) {
+        PlayerState &last = last_[p];
+        const MoveBinding &m = kMoveBindings[p];
+        int8_t moveX = (int8_t)((IsKeyDown(m.right) ? 1 : 0) - (IsKeyDown(m.left) ? 1 : 0));
+        int8_t moveZ = (int8_t)((IsKeyDown(m.back) ? 1 : 0) - (IsKeyDown(m.forward) ? 1 : 0));
+        if (moveX != last.moveX || moveZ != last.moveZ) {
+            last.moveX = moveX;
+            last.moveZ = moveZ;
+            emit(p, kInputMove, 0);
+        }
+        uint8_t pressed = (uint8_t)(down[p] & ~last.down);
+        uint8_t released = (uint8_t)(last.down & ~down[p] & kHeldButtons);
+        last.down = down[p];
+        if (pressed) emit(p, kInputPress, pressed);
+        if (released) emit(p, kInputRelease, released);
+    }
+}
+
+void InputSampler::setFirstPerson(bool on, float yaw) {
+    firstPerson_ = on;
+    if (on) {
+        lookYaw_ = yaw;
+        lookPitch_ = 0.0f;
+    }
+}
+
+void InputSampler::reset() {
+    last_[0] = PlayerState{};
+    last_[1] = PlayerState{};
+}
+
+void pollInputBetweenFrames() {
+    glfwPollEvents();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include "raylib.h"
+#include "sim/input_queue.h"
+
+// Turns the keyboard and mouse into InputEvents for the two local players (P1: WASD, mouse,
+// Space, Left Shift; P2: arrows and the right-hand modifiers). Each sample() emits one
+// event per change since the previous sample, stamped with the sample's time, so timing
+// precision is the sampling rate rather than the frame rate. Main thread only (raylib).
+class InputSampler {
+public:
+    void sample(double now, InputQueue &queue);
+
+    // First person: the mouse turns the look yaw and player 1 moves relative to it.
+    void setFirstPerson(bool on, float yaw);
+    void setSensitivity(float sensitivity) { sensitivity_ = sensitivity; }
+    float lookYaw() const { return lookYaw_; }
+    float lookPitch() const { return lookPitch_; }
+
+    // raylib reset its mouse delta (frame poll, cursor recentred); call right after.
+    void mouseRecentered() { consumedDelta_ = {0.0f, 0.0f}; }
+
+    // Forget what is held; the next sample reports anything still down as a fresh press.
+    void reset();
+
+private:
+    struct PlayerState {
+        int8_t moveX = 0;
+        int8_t moveZ = 0;
+        uint8_t down = 0;       // kButton* bits whose binding is down
+        uint16_t yaw = 0;
+    };
+
+    PlayerState last_[2];
+    bool firstPerson_ = false;
+    float sensitivity_ = 0.25f;
+    float lookYaw_ = 0.0f;
+    float lookPitch_ = 0.0f;
+    Vector2 consumedDelta_ = {0.0f, 0.0f};
+};
+
+// Pumps the OS event queue without touching raylib's per-frame key/mouse history, so
+// IsKeyPressed() and GetMouseDelta() still cover the whole frame when this runs between frames.
+void pollInputBetweenFrames();
@@ -0,0 +1,197 @@
+// epiCBattle_loadgen: fake clients for load-testing epiCBattle_server.
+// Spins up N NetClients on local sockets, spread over a few threads, each sending a
+// random held-direction input every tick like a real player. Reports how many connected,
+// snapshot rate per client (60/s when the server keeps up) and decode failures. Run the
+// server's status line next to it for CPU per match and matches per core.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "net/net_client.h"
+#include "net/protocol.h"
+
+struct LoadConfig {
+    std::string server = "127.0.0.1";
+    int clients = 200;
+    int threads = 4;
+    double seconds = 20.0;
+    double rampSeconds = 2.0;       // connects are spread over this long
+};
+
+struct Rng {
+    uint32_t state;
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+static PlayerInput randomInput(Rng &rng, PlayerInput previous) {
+    PlayerInput in = previous;
+    in.buttons &= kButtonSprint;
+    if (rng.next() % 20 == 0) {
+        in.moveX = (int8_t)((int)(rng.next() % 3) - 1);
+        in.moveZ = (int8_t)((int)(rng.next() % 3) - 1);
+        in.buttons = (rng.next() % 3 == 0) ? kButtonSprint : 0;
+    }
+    uint32_t r = rng.next() % 64;
+    if (r == 0) in.buttons |= kButtonJump;
+    else if (r < 3) in.buttons |= kButtonLight;
+    return in;
+}
+
+struct WorkerResult {
+    int connected = 0;
+    int rejected = 0;
+    int lost = 0;
+    uint64_t snapshots = 0;
+    uint64_t undecodable = 0;
+    uint64_t bytesDown = 0;
+    uint64_t bytesUp = 0;
+    double connectedSeconds = 0.0;      // summed over clients, for the per-client rate
+};
+
+static void printUsage() {
+    std::printf(
+        "usage: epiCBattle_loadgen [options]\n"
+        "  --server HOST:PORT server address (default 127.0.0.1:%u)\n"
+        "  --clients N        fake clients (default 200)\n"
+        "  --threads N        client threads (default 4)\n"
+        "  --seconds S        test length (default 20)\n"
+        "  --ramp S           spread connects over S seconds (default 2)\n",
+        kDefaultServerPort);
+}
+
+static bool parseArgs(int argc, char **argv, LoadConfig &cfg) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto need = [&]() {
+            if (!value) { std::fprintf(stderr, "missing value for %s\n", arg); return false; }
+            ++i;
+            return true;
+        };
+        if (std::strcmp(arg, "--server") == 0) { if (!need()) return false; cfg.server = value; }
+        else if (std::strcmp(arg, "--clients") == 0) { if (!need()) return false; cfg.clients = std::atoi(value); }
+        else if (std::strcmp(arg, "--threads") == 0) { if (!need()) return false; cfg.threads = std::atoi(value); }
+        else if (std::strcmp(arg, "--seconds") == 0) { if (!need()) return false; cfg.seconds = std::atof(value); }
+        else if (std::strcmp(arg, "--ramp") == 0) { if (!need()) return false; cfg.rampSeconds = std::atof(value); }
+        else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) { printUsage(); std::exit(0); }
+        else { std::fprintf(stderr, "unknown option '%s'\n", arg); return false; }
+    }
+    if (cfg.clients < 1 || cfg.threads < 1 || cfg.seconds <= 0.0) { std::fprintf(stderr, "--clients, --threads and --seconds must be positive\n"); return false; }
+    if (cfg.threads > cfg.clients) cfg.threads = cfg.clients;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    LoadConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        printUsage();
+        return 2;
+    }
+    NetAddress server;
+    if (!parseNetAddress(cfg.server, kDefaultServerPort, server)) {
+        std::fprintf(stderr, "bad server address '%s'\n", cfg.server.c_str());
+        return 2;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto origin = Clock::now();
+    auto seconds = [&]() { return std::chrono::duration<double>(Clock::now() - origin).count(); };
+    std::vector<WorkerResult> results(cfg.threads);
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < cfg.threads; ++t) {
+        threads.emplace_back([&, t]() {
+            const int first = cfg.clients * t / cfg.threads;
+            const int count = cfg.clients * (t + 1) / cfg.threads - first;
+            std::vector<std::unique_ptr<NetClient>> clients;
+            std::vector<double> connectAt(count), joinedAt(count, -1.0);
+            std::vector<PlayerInput> inputs(count);
+            std::vector<Rng> rngs;
+            for (int c = 0; c < count; ++c) {
+                clients.emplace_back(new NetClient());
+                if (!clients[c]->open()) { failed.store(true); return; }
+                connectAt[c] = cfg.rampSeconds * (double)(first + c) / (double)cfg.clients;
+                rngs.push_back(Rng{2654435761u * (uint32_t)(first + c + 1)});
+            }
+            std::vector<bool> started(count, false);
+            double nextTick = 0.0;
+            for (;;) {
+                double now = seconds();
+                if (now >= cfg.seconds) break;
+                if (now < nextTick) {
+                    std::this_thread::sleep_for(std::chrono::duration<double>(nextTick - now));
+                    continue;
+                }
+                nextTick += kFixedDt;
+                for (int c = 0; c < count; ++c) {
+                    NetClient &client = *clients[c];
+                    if (!started[c]) {
+                        if (now < connectAt[c]) continue;
+                        client.connect(server, now);
+                        started[c] = true;
+                    }
+                    client.update(now);
+                    if (client.state() == NetClientState::Connected) {
+                        if (joinedAt[c] < 0.0) joinedAt[c] = now;
+                        inputs[c] = randomInput(rngs[c], inputs[c]);
+                        client.sendInput(inputs[c], now);
+                    }
+                }
+            }
+            WorkerResult &r = results[t];
+            double end = seconds();
+            for (int c = 0; c < count; ++c) {
+                NetClient &client = *clients[c];
+                NetClientState st = client.state();
+                if (st == NetClientState::Connected) r.connected++;
+                else if (st == NetClientState::Rejected) r.rejected++;
+                else if (joinedAt[c] >= 0.0) r.lost++;
+                if (joinedAt[c] >= 0.0) r.connectedSeconds += end - joinedAt[c];
+                r.snapshots += client.stats().snapshotsReceived;
+                r.undecodable += client.stats().snapshotsUndecodable;
+                r.bytesDown += client.stats().snapshotBytes;
+                r.bytesUp += client.stats().inputBytes;
+                client.disconnect();
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+    if (failed.load()) {
+        std::fprintf(stderr, "could not open enough client sockets\n");
+        return 1;
+    }
+
+    WorkerResult total;
+    for (const WorkerResult &r : results) {
+        total.connected += r.connected;
+        total.rejected += r.rejected;
+        total.lost += r.lost;
+        total.snapshots += r.snapshots;
+        total.undecodable += r.undecodable;
+        total.bytesDown += r.bytesDown;
+        total.bytesUp += r.bytesUp;
+        total.connectedSeconds += r.connectedSeconds;
+    }
+    double rate = total.connectedSeconds > 0.0 ? (double)total.snapshots / total.connectedSeconds : 0.0;
+    std::printf("server:         %s\n", formatNetAddress(server).c_str());
+    std::printf("clients:        %d connected, %d rejected, %d lost, %d never joined (of %d)\n", total.connected, total.rejected, total.lost,
+                cfg.clients - total.connected - total.rejected - total.lost, cfg.clients);
+    std::printf("snapshots:      %.1f per client per second (%.0f expected), %llu undecodable\n", rate, 1.0 / kFixedDt,
+                (unsigned long long)total.undecodable);
+    std::printf("traffic:        %.1f kB/s down, %.1f kB/s up per client\n",
+                total.connectedSeconds > 0.0 ? total.bytesDown / total.connectedSeconds / 1000.0 : 0.0,
+                total.connectedSeconds > 0.0 ? total.bytesUp / total.connectedSeconds / 1000.0 : 0.0);
+    return total.connected == cfg.clients ? 0 : 1;
+}
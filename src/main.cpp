@@ -1,44 +1,101 @@
 #include "raylib.h"
 #include "rlgl.h"
 #include "raymath.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "assets/asset_manager.h"
+#include "core/alloc_tracker.h"
+#include "core/frame_arena.h"
+#include "core/job_system.h"
+#include "core/profiler.h"
 #include "core/types.h"
+#include "game/characters.h"
 #include "game/maps.h"
+#include "input/input_sampler.h"
+#include "net/net_client.h"
+#include "net/protocol.h"
+#include "render/instanced_models.h"
+#include "render/lod.h"
+#include "render/particle_renderer.h"
+#include "render/particles.h"
+#include "render/render_stats.h"
+#include "render/rl_convert.h"
+#include "render/static_batch.h"
+#include "sim/bots.h"
+#include "sim/input_queue.h"
+#include "sim/replay.h"
+#include "sim/sim_events.h"
+#include "sim/rollback.h"
+#include "sim/sim_thread.h"
+#include "sim/sim.h"
 
 // Types declared in headers
 
-struct CharacterDef {
-    std::string name;
-    std::string gltfPath;
-    std::string textureDir;
-};
-
-struct LoadedCharacter {
-    CharacterDef def;
-    Model model;
-    Texture2D texture;
-    bool loaded = false;
-};
-
-static std::vector<CharacterDef> kCharacters = {
-    {"Asgore", "models/asgore/scene.gltf", "models/asgore/textures"},
-    {"Metrocop", "models/metrocop/scene.gltf", "models/metrocop/textures"}
-};
-
 static int ClampIndex(int value, int minValue, int maxValue) {
     if (value < minValue) return minValue;
     if (value > maxValue) return maxValue;
     return value;
 }
 
-int main() {
+// Fighters per piece of the per-frame visibility pass
+static const int kFightersPerJob = 32;
+
+// Every finished or abandoned match is written here; the menu replays the newest one.
+static const char *kReplayDir = "replays";
+
+static std::string latestReplayPath() {
+    std::string latest;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(kReplayDir, ec)) {
+        if (entry.path().extension() != ".ebrp") continue;
+        std::string path = entry.path().generic_string();
+        // Names are timestamps, so the lexically largest is the newest
+        if (path > latest) latest = path;
+    }
+    return latest;
+}
+
+int main(int argc, char **argv) {
+    // Cold start is measured from process entry to the first presented frame
+    auto processStart = std::chrono::steady_clock::now();
+    bool firstFramePresented = false;
+    // Zones are always recorded so a trace of the last few seconds can be dumped at any time
+    profilerSetEnabled(true);
+    profilerSetThreadName("main");
+
     int screenWidth = 1600;
     int screenHeight = 900;
     SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_WINDOW_RESIZABLE);
     InitWindow(screenWidth, screenHeight, "epiCBattle");
-    SetTargetFPS(120);
+    // The render rate is independent of the 60 Hz tick: --fps N (0 = uncapped). Frames are
+    // paced at the bottom of the loop instead of by raylib, so the wait can keep sampling input.
+    int targetFps = 120;
+    // Resident asset budgets in MB (--cpu-budget, --gpu-budget), see assets/asset_manager.h
+    AssetBudget assetBudget;
+    // Threads for the job system (--threads N, 0 = one per core), see core/job_system.h
+    int threadCount = 0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--fps") == 0) targetFps = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--cpu-budget") == 0) assetBudget.cpuBytes = (size_t)std::max(0, std::atoi(argv[i + 1])) << 20;
+        if (std::strcmp(argv[i], "--gpu-budget") == 0) assetBudget.gpuBytes = (size_t)std::max(0, std::atoi(argv[i + 1])) << 20;
+        if (std::strcmp(argv[i], "--threads") == 0) threadCount = std::atoi(argv[i + 1]);
+    }
+    // The sim tick, the per-frame visibility pass and asset decoding all run on it. At least
+    // one worker, so a load never runs inline on the main thread.
+    if (threadCount < 1) threadCount = (int)std::thread::hardware_concurrency();
+    JobSystem jobs(std::max(threadCount, 2));
+    TraceLog(LOG_INFO, "JOBS: %d threads", jobs.threadCount());
+    double nextFrameSeconds = inputClockSeconds();
 
     GameState gameState = GameState::Menu;
 
@@ -55,124 +112,290 @@ int main() {
     camera.fovy = fieldOfView;
     camera.projection = CAMERA_PERSPECTIVE;
     ViewMode viewMode = ViewMode::FirstPerson;
-    MapType currentMap = MapType::Green;
+
+    // Characters draw through the instancing shader, which also reads the model cache's
+    // quantized vertex formats; without it models are uploaded as floats for DrawModelEx
+    Shader instancingShader = loadInstancingShader();
+    if (instancingShader.id == 0) TraceLog(LOG_WARNING, "RENDER: Instancing shader unavailable, drawing fighters one by one");
+    // Hit sparks, landing dust and knockout bursts (render/particles.h), spawned from what
+    // changed between the match states on screen, so they never reach the sim
+    ParticleSystem particles;
+    ParticleRenderer particleRenderer;
+    if (!loadParticleRenderer(particleRenderer)) TraceLog(LOG_WARNING, "RENDER: Particle shader unavailable, no hit effects");
+    MatchState fxPrevious;
+    bool fxPreviousValid = false;
+    SimEventList simEvents;
 
     int selectedIndex = 0;
-    std::vector<LoadedCharacter> loaded(kCharacters.size());
-
-    auto unloadAll = [&]() {
-        for (auto &lc : loaded) {
-            if (lc.loaded) {
-                UnloadTexture(lc.texture);
-                UnloadModel(lc.model);
-                lc.loaded = false;
+    // Every character streams in on background jobs from startup; the main thread
+    // only uploads finished data, a few milliseconds per frame. The selected fighter and
+    // everyone in the match on screen are held; the rest stay cached until the budget
+    // needs their memory.
+    const double kUploadBudgetSeconds = 0.004;
+    AssetManager assets(jobs, instancingShader.id != 0, assetBudget);
+    std::vector<ModelHandle> characterModels(kCharacters.size());
+    auto holdCharacters = [&](const ServerState *roster) {
+        for (int c = 0; c < (int)kCharacters.size(); ++c) {
+            bool wanted = c == selectedIndex;
+            for (int i = 0; roster && i < roster->playerCount; ++i) wanted = wanted || roster->characterIndex[i] == c;
+            if (wanted && !characterModels[c].valid()) {
+                characterModels[c] = assets.acquireModel(kCharacters[c].gltfPath, c == selectedIndex);
+            } else if (!wanted && characterModels[c].valid()) {
+                assets.release(characterModels[c]);
+                characterModels[c] = ModelHandle{};
             }
         }
     };
-
-    auto ensureLoaded = [&](int index) {
-        if (index < 0 || index >= (int)kCharacters.size()) return;
-        if (loaded[index].loaded) return;
-        const CharacterDef &def = kCharacters[index];
-        LoadedCharacter lc;
-        lc.def = def;
-        // raylib loads .gltf via tinygltf; textures embedded or external. We'll load model only.
-        lc.model = LoadModel(def.gltfPath.c_str());
-        if (lc.model.materialCount > 0) {
-            // Try to assign base color texture if found; otherwise leave as-is
-            // We look for any png in textureDir ending with _baseColor or first png
-            // Minimal: try known names
-            std::string candidate;
-            if (def.name == "Asgore") candidate = def.textureDir + "/Asgore_Mat_baseColor.png";
-            else if (def.name == "Metrocop") candidate = def.textureDir + "/metrocop_body_baseColor.png";
-            Image img = LoadImage(candidate.c_str());
-            if (img.data) {
-                lc.texture = LoadTextureFromImage(img);
-                UnloadImage(img);
-                for (int m = 0; m < lc.model.materialCount; ++m) {
-                    SetMaterialTexture(&lc.model.materials[m], MATERIAL_MAP_ALBEDO, lc.texture);
-                }
-            } else {
-                // Create a white texture placeholder
-                Image white = GenImageColor(2, 2, RAYWHITE);
-                lc.texture = LoadTextureFromImage(white);
-                UnloadImage(white);
-            }
+    auto characterModel = [&](int c) -> const ModelAsset * {
+        return c >= 0 && c < (int)characterModels.size() ? assets.model(characterModels[c]) : nullptr;
+    };
+    holdCharacters(nullptr);
+    for (const CharacterDef &def : kCharacters) assets.prefetchModel(def.gltfPath);
+
+    // Maps are the baked .ebmap files in maps/, memory-mapped when picked; the static
+    // geometry is merged into a few meshes per map
+    const std::vector<std::string> mapNames = listMaps();
+    GameMap gameMap;
+    StaticBatch staticBatch;
+    auto openMap = [&](const std::string &name) {
+        GameMap next;
+        if (!next.open(mapFilePath(name))) {
+            TraceLog(LOG_WARNING, "MAP: Cannot open %s", mapFilePath(name).c_str());
+            return false;
         }
-        loaded[index] = lc;
-        loaded[index].loaded = true;
+        gameMap = std::move(next);
+        uploadStaticBatch(staticBatch, gameMap.data());
+        return true;
     };
+    int mapIdx = 0;
+    for (int i = 0; i < (int)mapNames.size(); ++i) {
+        if (mapNames[i] == "green") mapIdx = i;
+    }
+    if (mapNames.empty() || !openMap(mapNames[mapIdx])) {
+        TraceLog(LOG_ERROR, "MAP: No usable .ebmap in %s/ (build the 'maps' target)", kMapDirectory);
+        CloseWindow();
+        return 1;
+    }
 
-    ensureLoaded(selectedIndex);
-
-    // Simple ground from map data
-    MapData mapData = loadMapData(currentMap);
-
-    // Simple "server" state for local multiplayer (2 players)
-    struct PlayerState {
-        Vector3 position;
-        float velocityY;
-        float yawRadians;
-        int health;
-        bool attacking;
-        float attackCooldown;
-        float attackTimer;
-        int characterIndex;
+    // Fighters sharing a character and detail level are drawn instanced, grouped each frame
+    // into instanceBatches[character * kMaxModelLods + lod]. The transforms live in frameArena,
+    // emptied at the start of every frame; it starts out big enough for every player.
+    struct InstanceBatch {
+        Matrix *transforms = nullptr;
+        int count = 0;
     };
-    struct ServerState {
-        PlayerState players[2];
-    } server;
-    auto resetPlayer = [&](PlayerState &p){
-        p.position = {0.0f, 0.0f, 0.0f};
-        p.velocityY = 0.0f;
-        p.yawRadians = 0.0f;
-        p.health = 100;
-        p.attacking = false;
-        p.attackCooldown = 0.0f;
-        p.attackTimer = 0.0f;
-        p.characterIndex = selectedIndex;
+    std::vector<InstanceBatch> instanceBatches(kCharacters.size() * kMaxModelLods);
+    FrameArena frameArena(kMaxPlayers * sizeof(Matrix));
+    std::vector<int> playerLod(kMaxPlayers, 0);     // last frame's level, for hysteresis
+    // Culling, LOD and placement for every fighter run as a job graph: the visibility pass in
+    // parallel over the players, then grouping into batches. Only the draws themselves stay on
+    // the main thread. The graph is built once, further down; each frame fills in frameCull
+    // and runs it, which allocates nothing.
+    struct FighterView {
+        int lod = -1;           // -1: outside the frustum, or no model yet
+        float scale = 1.0f;
+        Matrix transform;
     };
-    resetPlayer(server.players[0]);
-    server.players[0].position = {-4.0f, 0.0f, 0.0f};
-    resetPlayer(server.players[1]);
-    server.players[1].position = { 4.0f, 0.0f, 0.0f};
-
-    auto damageIfInRange = [&](int attacker, int victim){
-        const float range = 2.5f;
-        const int damage = 10;
-        Vector3 a = server.players[attacker].position;
-        Vector3 b = server.players[victim].position;
-        float d = Vector3Distance(a, b);
-        if (d <= range) {
-            server.players[victim].health -= damage;
-            if (server.players[victim].health < 0) server.players[victim].health = 0;
-        }
+    struct FrameCull {
+        const ServerState *view = nullptr;
+        Frustum frustum;
+        int playerCount = 0;
+        bool instanced = false;
+        float moveSway = 0.0f;
     };
-    auto heavyDamageIfInRange = [&](int attacker, int victim){
-        const float range = 2.8f;
-        const int damage = 22;
-        Vector3 a = server.players[attacker].position;
-        Vector3 b = server.players[victim].position;
-        float d = Vector3Distance(a, b);
-        if (d <= range) {
-            server.players[victim].health -= damage;
-            if (server.players[victim].health < 0) server.players[victim].health = 0;
-        }
+    std::vector<FighterView> fighterViews(kMaxPlayers);
+    std::vector<const ModelAsset *> frameModels(kCharacters.size());
+    FrameCull frameCull;
+    JobGraph frameGraph;
+
+    // Debug overlay (F3) and resident assets (F7)
+    bool showRenderStats = false;
+    bool showAssets = false;
+    RenderStats renderStats;
+    FrameTimes frameTimes;
+    // Heap allocations by subsystem over the last frame, any thread (core/alloc_tracker.h)
+    AllocCounts allocsSeen[kAllocTagCount];
+    AllocCounts frameAllocs[kAllocTagCount];
+
+    // Profiler overlay (F4) and trace dump (F5), see core/profiler.h
+    const double kProfileWindowSeconds = 2.0;
+    const double kTraceDumpSeconds = 10.0;
+    bool showProfiler = false;
+    std::vector<ZoneStats> profileStats;
+    double profileStatsTime = 0.0;
+
+    // Match simulation (see sim/sim.h); the client only feeds it input and draws it
+    MatchState match;
+    int arenaPlayers = kDuelPlayers;
+    bool matchNeedsReset = false;   // mode or map changed since the match was set up
+    bool botOpponent = false;       // player 2 is a bot rather than the arrow keys
+
+    // Rollback (sim/rollback.h): saved states and inputs for the last few ticks
+    std::unique_ptr<RollbackSession> rollback(new RollbackSession);
+    // Bots (sim/bots.h): fill every player slot no human is on
+    std::unique_ptr<BotSystem> bots(new BotSystem);
+
+    // Input (input/input_sampler.h): sampled at frame start and ~1 kHz between frames into
+    // timestamped events; each tick takes the ones inside its window
+    InputSampler sampler;
+    InputQueue inputQueue;
+    bool sampling = false;
+    const double kInputSampleSeconds = 0.001;
+    sampler.setFirstPerson(viewMode == ViewMode::FirstPerson, 0.0f);
+    // F6: input-to-present latency, sample time of a press to the swap of the first frame showing it
+    bool latencyMode = false;
+    FrameTimes inputLatency;
+    double latencyPress = 0.0;      // newest press the sim has taken
+    double latencyShown = 0.0;      // newest press already measured
+
+    // Replays (sim/replay.h): every tick of the local match is recorded
+    ReplayRecorder recording;
+    auto saveRecording = [&]() {
+        if (recording.replay.tickCount == 0) return;
+        finishReplay(recording, match);
+        char name[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(name, sizeof(name), "%Y%m%d_%H%M%S.ebrp", std::localtime(&now));
+        std::error_code ec;
+        std::filesystem::create_directories(kReplayDir, ec);
+        std::string path = std::string(kReplayDir) + "/" + name;
+        if (saveReplay(path, recording.replay)) TraceLog(LOG_INFO, "REPLAY: Saved %s (%u ticks)", path.c_str(), recording.replay.tickCount);
+        else TraceLog(LOG_WARNING, "REPLAY: Could not write %s", path.c_str());
+        recording.replay = Replay{};
+    };
+    Replay playback;
+    ReplayCursor playbackCursor;
+    bool playbackPaused = false;
+    bool playbackFastForward = false;
+    bool playbackDesync = false;
+
+    auto startMatch = [&]() {
+        saveRecording();
+        int characters[kMaxPlayers];
+        for (int i = 0; i < arenaPlayers; ++i) characters[i] = selectedIndex;
+        resetMatch(match, gameMap.data(), arenaPlayers, characters);
+        startRollback(*rollback, match);
+        // Everyone past the humans is a bot; their inputs are recorded like the humans'
+        bots->reset(gameMap.data(), arenaPlayers, botOpponent ? 1 : kDuelPlayers, (uint32_t)std::time(nullptr));
+        matchNeedsReset = false;
     };
+    startMatch();
+    ServerState &server = match.server;
+
+    // Offline the match ticks on its own thread (sim/sim_thread.h) while the arena is on screen.
+    // Each frame draws `shown`: match itself, or the sim's newest frame interpolated into `interpolated`.
+    std::unique_ptr<SimThread> simThread(new SimThread);
+    MatchState interpolated;
+    uint32_t simDroppedTicks = 0;
+
+    // Online play (--connect host:port): the server owns the match, this client sends its
+    // input every tick and draws the newest snapshot instead of stepping the sim itself.
+    NetClient netClient;
+    bool online = false;
+    bool joined = false;
+    int localPlayer = 0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--connect") != 0) continue;
+        NetAddress address;
+        if (!parseNetAddress(argv[i + 1], kDefaultServerPort, address) || !netClient.open()) {
+            TraceLog(LOG_WARNING, "NET: Cannot connect to '%s'", argv[i + 1]);
+            break;
+        }
+        netClient.connect(address, GetTime());
+        online = true;
+        TraceLog(LOG_INFO, "NET: Connecting to %s", formatNetAddress(address).c_str());
+    }
 
-    // Rounds / scoring
-    int playerScore[2] = {0, 0};
-    int targetScore = 3;
-    float koTimer = 0.0f;
-    int lastScorer = -1;
-    bool roundActive = true;
+    // Nodes and their chunks run on job workers, which have no scope of their own, so each
+    // opens one to keep the overlay from counting them as "other"
+    const int visibilityNode = frameGraph.add("visibility", [&]() {
+        AllocScope renderScope(AllocTag::Render);
+        const FrameCull &f = frameCull;
+        const ServerState &view = *f.view;
+        jobs.parallelFor(f.playerCount, kFightersPerJob, [&](int begin, int end) {
+            AllocScope chunkScope(AllocTag::Render);
+            for (int i = begin; i < end; ++i) {
+                FighterView &fighter = fighterViews[i];
+                fighter.lod = -1;
+                const ModelAsset *lc = frameModels[view.characterIndex[i]];
+                if (!lc) continue;
+                float atkPulse = view.attacking(i) ? 0.2f : 0.0f;
+                float scale = 1.0f + f.moveSway + atkPulse;
+                Vector3 p = toRl(view.position(i));
+
+                // Bounding sphere that holds the model at any yaw: centred on the yaw axis
+                Vector3 mid = Vector3Scale(Vector3Add(lc->bounds.min, lc->bounds.max), 0.5f);
+                float radius = (Vector3Distance(lc->bounds.min, lc->bounds.max) * 0.5f + sqrtf(mid.x * mid.x + mid.z * mid.z)) * scale;
+                Vector3 center = {p.x, p.y + mid.y * scale, p.z};
+                if (!sphereInFrustum(f.frustum, center, radius)) continue;
+                int lod = selectLod(projectedSize(camera, center, radius), playerLod[i], lc->lodCount);
+                playerLod[i] = lod;
+                fighter.lod = lod;
+                fighter.scale = scale;
+                // Same composition as DrawModelEx: scale, yaw, translate, after the model's own transform
+                Matrix placement = MatrixMultiply(MatrixMultiply(MatrixScale(scale, scale, scale), MatrixRotateY(view.yawRadians[i])),
+                                                  MatrixTranslate(p.x, p.y, p.z));
+                fighter.transform = MatrixMultiply(lc->lod(lod).transform, placement);
+            }
+        });
+    });
+    frameGraph.add("batches", [&]() {
+        AllocScope renderScope(AllocTag::Render);
+        const FrameCull &f = frameCull;
+        const ServerState &view = *f.view;
+        for (InstanceBatch &batch : instanceBatches) batch.count = 0;
+        for (int i = 0; i < f.playerCount; ++i) {
+            const FighterView &fighter = fighterViews[i];
+            if (!frameModels[view.characterIndex[i]]) continue;
+            if (fighter.lod < 0) {
+                renderStats.culled++;
+                continue;
+            }
+            renderStats.lodInstances[fighter.lod]++;
+            if (f.instanced && i != localPlayer) instanceBatches[view.characterIndex[i] * kMaxModelLods + fighter.lod].count++;
+        }
+        // Counted, so every batch gets an exact array; then fill them
+        for (InstanceBatch &batch : instanceBatches) {
+            batch.transforms = batch.count > 0 ? frameArena.allocateArray<Matrix>(batch.count) : nullptr;
+            batch.count = 0;
+        }
+        for (int i = 0; f.instanced && i < f.playerCount; ++i) {
+            const FighterView &fighter = fighterViews[i];
+            if (fighter.lod < 0 || i == localPlayer) continue;
+            InstanceBatch &batch = instanceBatches[view.characterIndex[i] * kMaxModelLods + fighter.lod];
+            batch.transforms[batch.count++] = fighter.transform;
+        }
+    }, {visibilityNode});
 
-    float fixedDt = 1.0f/60.0f;
+    const float fixedDt = kFixedDt;
     double accumulator = 0.0;
     double lastTime = GetTime();
 
     while (!WindowShouldClose()) {
+        PROFILE_ZONE("frame");
+        {
+            AllocCounts counts[kAllocTagCount];
+            allocTagCounts(counts);
+            for (int i = 0; i < kAllocTagCount; ++i) {
+                frameAllocs[i] = {counts[i].allocations - allocsSeen[i].allocations, counts[i].bytes - allocsSeen[i].bytes};
+                allocsSeen[i] = counts[i];
+            }
+        }
+        frameArena.reset();
         // Update
+        assets.pumpUploads(kUploadBudgetSeconds);
+        frameTimes.push(GetFrameTime() * 1000.0f);
+        if (IsKeyPressed(KEY_F3)) showRenderStats = !showRenderStats;
+        if (IsKeyPressed(KEY_F4)) showProfiler = !showProfiler;
+        if (IsKeyPressed(KEY_F6)) latencyMode = !latencyMode;
+        if (IsKeyPressed(KEY_F7)) showAssets = !showAssets;
+        if (IsKeyPressed(KEY_F5)) {
+            char name[64];
+            std::time_t now = std::time(nullptr);
+            std::strftime(name, sizeof(name), "trace_%Y%m%d_%H%M%S.json", std::localtime(&now));
+            if (profilerWriteChromeTrace(name, kTraceDumpSeconds)) TraceLog(LOG_INFO, "PROFILE: Wrote last %.0f s to %s", kTraceDumpSeconds, name);
+            else TraceLog(LOG_WARNING, "PROFILE: Could not write %s", name);
+        }
         if (IsKeyPressed(KEY_F11)) {
             bool fs = IsWindowFullscreen();
             if (!fs) {
@@ -186,29 +409,91 @@ int main() {
                 SetWindowSize(screenWidth, screenHeight);
             }
         }
+        // The sim thread owns match, rollback, recording and the input queue's consuming end
+        // exactly while the local arena is up
+        const bool inArena = gameState == GameState::Arena;
+        const bool simulate = inArena && !online;
+        if (!simulate && simThread->running()) simThread->stop();
+        if (inArena != sampling) {
+            // Entering or leaving the arena: nothing queued or held carries over
+            inputQueue.reset();
+            sampler.reset();
+            sampling = inArena;
+        }
+        if (simulate && !simThread->running()) simThread->start(match, *rollback, recording, inputQueue, gameMap.data(), bots.get(), &jobs);
+        const MatchState *shown = &match;
+
+        if (online) {
+            AllocScope netScope(AllocTag::Net);
+            netClient.update(GetTime());
+            NetClientState netState = netClient.state();
+            if (netState == NetClientState::Connected && !joined && !openMap(netClient.mapName())) {
+                TraceLog(LOG_WARNING, "NET: Server map '%s' is not installed", netClient.mapName().c_str());
+                netClient.disconnect();
+                netState = NetClientState::Disconnected;
+            }
+            if (netState == NetClientState::Connected && !joined) {
+                joined = true;
+                localPlayer = netClient.playerIndex();
+                accumulator = 0.0;
+                lastTime = GetTime();
+                gameState = GameState::Arena;
+                TraceLog(LOG_INFO, "NET: Joined as player %d", localPlayer + 1);
+            } else if (netState != NetClientState::Connected && netState != NetClientState::Connecting) {
+                TraceLog(LOG_WARNING, "NET: %s, back to local play", netState == NetClientState::Rejected ? "Server is full" : "Connection lost");
+                online = false;
+                joined = false;
+                localPlayer = 0;
+                startMatch();
+                gameState = GameState::Menu;
+            }
+        }
         switch (gameState) {
             case GameState::Menu: {
                 if (IsKeyPressed(KEY_ENTER) || IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
                     gameState = GameState::ModeSelect;
                 }
+                if (IsKeyPressed(KEY_R)) {
+                    std::string path = latestReplayPath();
+                    if (!path.empty() && loadReplay(path, playback) && openMap(playback.map)) {
+                        saveRecording();
+                        resetMatch(match, gameMap.data(), playback.playerCount, playback.characterIndex);
+                        matchNeedsReset = true;
+                        startReplay(playbackCursor, playback);
+                        playbackPaused = false;
+                        playbackFastForward = false;
+                        playbackDesync = false;
+                        accumulator = 0.0;
+                        lastTime = GetTime();
+                        gameState = GameState::Replay;
+                        TraceLog(LOG_INFO, "REPLAY: Playing %s", path.c_str());
+                    } else {
+                        TraceLog(LOG_WARNING, "REPLAY: No readable replay in %s/", kReplayDir);
+                    }
+                }
             } break;
             case GameState::ModeSelect: {
-                if (IsKeyPressed(KEY_ENTER)) {
+                if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_F)) {
+                    int players = IsKeyPressed(KEY_F) ? kDefaultFreeForAllPlayers : kDuelPlayers;
+                    if (players != arenaPlayers) matchNeedsReset = true;
+                    arenaPlayers = players;
                     gameState = GameState::MapSelect;
                 }
+                if (IsKeyPressed(KEY_B)) {
+                    botOpponent = !botOpponent;
+                    matchNeedsReset = true;
+                }
                 if (IsKeyPressed(KEY_ESCAPE)) {
                     gameState = GameState::Menu;
                 }
             } break;
             case GameState::MapSelect: {
-                static int mapIdx = 0;
                 int delta = 0;
                 if (IsKeyPressed(KEY_RIGHT) || GetMouseWheelMove() < 0) delta = 1;
                 if (IsKeyPressed(KEY_LEFT) || GetMouseWheelMove() > 0) delta = -1;
-                if (delta != 0) mapIdx = ClampIndex(mapIdx + delta, 0, 1);
-                if (IsKeyPressed(KEY_ENTER)) {
-                    currentMap = (mapIdx == 0) ? MapType::Green : MapType::Desert;
-                    mapData = loadMapData(currentMap);
+                if (delta != 0) mapIdx = ClampIndex(mapIdx + delta, 0, (int)mapNames.size() - 1);
+                if (IsKeyPressed(KEY_ENTER) && openMap(mapNames[mapIdx])) {
+                    matchNeedsReset = true;
                     gameState = GameState::CharacterSelect;
                 }
                 if (IsKeyPressed(KEY_ESCAPE)) gameState = GameState::ModeSelect;
@@ -217,11 +502,12 @@ int main() {
                 int delta = 0;
                 if (IsKeyPressed(KEY_RIGHT) || GetMouseWheelMove() < 0) delta = 1;
                 if (IsKeyPressed(KEY_LEFT) || GetMouseWheelMove() > 0) delta = -1;
-                if (delta != 0) {
-                    selectedIndex = ClampIndex(selectedIndex + delta, 0, (int)kCharacters.size() - 1);
-                    ensureLoaded(selectedIndex);
-                }
+                if (delta != 0) selectedIndex = ClampIndex(selectedIndex + delta, 0, (int)kCharacters.size() - 1);
                 if (IsKeyPressed(KEY_ENTER)) {
+                    if (matchNeedsReset) startMatch();
+                    for (int i = 0; i < server.playerCount; ++i) server.characterIndex[i] = selectedIndex;
+                    startRollback(*rollback, match);   // characters changed outside the tick
+                    if (recording.replay.tickCount == 0) beginReplay(recording, gameMap.name(), match);
                     gameState = GameState::Arena;
                 }
                 if (IsKeyPressed(KEY_ESCAPE)) {
@@ -239,13 +525,34 @@ int main() {
                 if (IsKeyPressed(KEY_LEFT_BRACKET)) mouseSensitivity = Clamp(mouseSensitivity - 0.02f, 0.05f, 1.0f);
                 camera.fovy = fieldOfView;
                 if (IsKeyPressed(KEY_L)) lockCursor = !lockCursor;
+                if (IsKeyPressed(KEY_T)) {
+                    int next = ((int)assets.textureQuality() + 1) % 3;
+                    assets.setTextureQuality((TextureQuality)next);
+                }
                 if (IsKeyPressed(KEY_ESCAPE)) gameState = GameState::Menu;
                 if (IsKeyPressed(KEY_ENTER)) gameState = GameState::CharacterSelect;
             } break;
             case GameState::Arena: {
+                if (simThread->running()) {
+                    const SimFrame &frame = simThread->latest();
+                    interpolateFrame(frame, simThread->alpha(frame), interpolated);
+                    shown = &interpolated;
+                    simDroppedTicks = frame.droppedTicks;
+                    latencyPress = frame.pressSeconds;
+                    if (frame.match.matchOver) {
+                        simThread->stop();
+                        saveRecording();
+                        gameState = GameState::ModeSelect;
+                        matchNeedsReset = true;
+                        break;
+                    }
+                }
+                const ServerState &view = shown->server;
+
                 // Switch view mode
                 if (IsKeyPressed(KEY_C)) {
                     viewMode = (viewMode == ViewMode::FirstPerson) ? ViewMode::ThirdPerson : ViewMode::FirstPerson;
+                    sampler.setFirstPerson(viewMode == ViewMode::FirstPerson, view.yawRadians[localPlayer]);
                 }
                 if (IsKeyPressed(KEY_P)) {
                     gameState = GameState::Settings;
@@ -255,178 +562,116 @@ int main() {
                     break;
                 }
 
-                // Input for two local players
-                auto moveDir = [&](int playerIndex){
-                    Vector3 dir = {0};
-                    if (playerIndex == 0) {
-                        if (IsKeyDown(KEY_W)) dir.z -= 1.0f;
-                        if (IsKeyDown(KEY_S)) dir.z += 1.0f;
-                        if (IsKeyDown(KEY_A)) dir.x -= 1.0f;
-                        if (IsKeyDown(KEY_D)) dir.x += 1.0f;
-                    } else {
-                        if (IsKeyDown(KEY_UP)) dir.z -= 1.0f;
-                        if (IsKeyDown(KEY_DOWN)) dir.z += 1.0f;
-                        if (IsKeyDown(KEY_LEFT)) dir.x -= 1.0f;
-                        if (IsKeyDown(KEY_RIGHT)) dir.x += 1.0f;
-                    }
-                    return dir;
-                };
-
-                auto doLightAttackPressed = [&](int playerIndex){
-                    return playerIndex == 0 ? IsMouseButtonPressed(MOUSE_BUTTON_LEFT) : IsKeyPressed(KEY_RIGHT_CONTROL);
-                };
-                auto doHeavyAttackPressed = [&](int playerIndex){
-                    return playerIndex == 0 ? IsMouseButtonPressed(MOUSE_BUTTON_RIGHT) : IsKeyPressed(KEY_RIGHT_ALT);
-                };
+                {
+                    PROFILE_ZONE("input");
+                    AllocScope inputScope(AllocTag::Input);
+                    sampler.setSensitivity(mouseSensitivity);
+                    sampler.sample(inputClockSeconds(), inputQueue);
+                }
 
-                // Fixed-step server tick
-                double now = GetTime();
-                accumulator += (now - lastTime);
-                lastTime = now;
-                while (accumulator >= fixedDt) {
-                    for (int i = 0; i < 2; ++i) {
-                        Vector3 dir = moveDir(i);
-                        if (Vector3Length(dir) > 0.0f) dir = Vector3Normalize(dir);
-                        float speed = 5.0f;
-                        if ((i == 0 && IsKeyDown(KEY_LEFT_SHIFT)) || (i == 1 && IsKeyDown(KEY_RIGHT_SHIFT))) speed *= 1.8f;
-                        // Rotate to movement direction if any
-                        if (dir.x != 0.0f || dir.z != 0.0f) {
-                            server.players[i].yawRadians = atan2f(-dir.x, -dir.z);
-                        }
-                        // Move in world plane XZ with simple obstacle collisions
-                        Vector3 nextPos = server.players[i].position;
-                        nextPos.x += dir.x * speed * fixedDt;
-                        auto intersects = [&](Vector3 p){
-                            for (const auto &b : mapData.obstacles) {
-                                if (p.x > b.min.x && p.x < b.max.x && p.y >= b.min.y && p.y <= b.max.y && p.z > b.min.z && p.z < b.max.z) return true;
-                            }
-                            return false;
-                        };
-                        if (!intersects({nextPos.x, server.players[i].position.y, server.players[i].position.z})) {
-                            server.players[i].position.x = nextPos.x;
-                        }
-                        nextPos = server.players[i].position;
-                        nextPos.z += dir.z * speed * fixedDt;
-                        if (!intersects({server.players[i].position.x, server.players[i].position.y, nextPos.z})) {
-                            server.players[i].position.z = nextPos.z;
-                        }
-
-                        // Jump/gravity
-                        const float gravity = -22.0f;
-                        bool wantJump = (i == 0) ? IsKeyPressed(KEY_SPACE) : IsKeyPressed(KEY_RIGHT_SHIFT);
-                        bool grounded = (server.players[i].position.y <= 0.0f);
-                        if (grounded) {
-                            server.players[i].position.y = 0.0f;
-                            if (wantJump) server.players[i].velocityY = 8.5f;
-                        }
-                        server.players[i].velocityY += gravity * fixedDt;
-                        server.players[i].position.y += server.players[i].velocityY * fixedDt;
-                        if (server.players[i].position.y < 0.0f) {
-                            server.players[i].position.y = 0.0f;
-                            server.players[i].velocityY = 0.0f;
-                        }
-
-                        // Clamp to arena bounds
-                        server.players[i].position.x = Clamp(server.players[i].position.x, -mapData.arenaSize.x * 0.5f + 1.0f, mapData.arenaSize.x * 0.5f - 1.0f);
-                        server.players[i].position.z = Clamp(server.players[i].position.z, -mapData.arenaSize.z * 0.5f + 1.0f, mapData.arenaSize.z * 0.5f - 1.0f);
-
-                        // Attack logic
-                        server.players[i].attackCooldown -= fixedDt;
-                        if (server.players[i].attackCooldown < 0.0f) server.players[i].attackCooldown = 0.0f;
-                        if (roundActive && server.players[i].attackCooldown <= 0.0f) {
-                            if (doLightAttackPressed(i)) {
-                                server.players[i].attacking = true;
-                                server.players[i].attackTimer = 0.18f;
-                                server.players[i].attackCooldown = 0.45f;
-                                int victim = (i == 0) ? 1 : 0;
-                                damageIfInRange(i, victim);
-                            } else if (doHeavyAttackPressed(i)) {
-                                server.players[i].attacking = true;
-                                server.players[i].attackTimer = 0.35f;
-                                server.players[i].attackCooldown = 0.9f;
-                                int victim = (i == 0) ? 1 : 0;
-                                heavyDamageIfInRange(i, victim);
-                            }
-                        }
-                        if (server.players[i].attacking) {
-                            server.players[i].attackTimer -= fixedDt;
-                            if (server.players[i].attackTimer <= 0.0f) server.players[i].attacking = false;
-                        }
-                    }
-                    // KO / round logic
-                    if (roundActive) {
-                        for (int i = 0; i < 2; ++i) {
-                            if (server.players[i].health <= 0) {
-                                int scorer = (i == 0) ? 1 : 0;
-                                playerScore[scorer]++;
-                                lastScorer = scorer;
-                                koTimer = 2.0f;
-                                roundActive = false;
-                                break;
-                            }
-                        }
-                    } else {
-                        koTimer -= fixedDt;
-                        if (koTimer <= 0.0f) {
-                            // Respawn both
-                            resetPlayer(server.players[0]);
-                            server.players[0].position = {-4.0f, 0.0f, 0.0f};
-                            resetPlayer(server.players[1]);
-                            server.players[1].position = { 4.0f, 0.0f, 0.0f};
-                            roundActive = true;
-                            // Match end
-                            if (playerScore[0] >= targetScore || playerScore[1] >= targetScore) {
-                                gameState = GameState::ModeSelect;
-                                playerScore[0] = playerScore[1] = 0;
-                            }
-                        }
+                // Offline the sim thread runs the tick itself, taking the sampled events
+                if (online) {
+                    // One input per tick to the server; the match on screen is its newest snapshot
+                    AllocScope netScope(AllocTag::Net);
+                    double now = GetTime();
+                    accumulator = std::min(accumulator + (now - lastTime), (double)kMaxCatchUpTicks * fixedDt);
+                    lastTime = now;
+                    // The oldest pending tick fell due accumulator - fixedDt ago; each takes its window's events
+                    double due = inputClockSeconds() - accumulator + fixedDt;
+                    while (accumulator >= fixedDt) {
+                        PlayerInput inputs[2];
+                        inputQueue.take(due, inputs, 2);
+                        netClient.sendInput(inputs[0], now);
+                        accumulator -= fixedDt;
+                        due += fixedDt;
                     }
-
-                    accumulator -= fixedDt;
+                    if (const Snapshot *snap = netClient.latest()) applySnapshot(*snap, match);
                 }
 
-                // Camera update based on primary player (index 0)
-                const PlayerState &p0 = server.players[0];
+                // Camera update based on the local player. In first person the look direction is
+                // local (the sim only sees its quantized yaw), so the view never waits on a tick.
+                PROFILE_ZONE("camera");
                 if (viewMode == ViewMode::FirstPerson) {
-                    // Mouse look
                     if (lockCursor) DisableCursor(); else EnableCursor();
-                    Vector2 md = GetMouseDelta();
-                    static float pitch = 0.0f;
-                    p0; // silence unused warning for reference
-                    server.players[0].yawRadians -= md.x * 0.01f * mouseSensitivity;
-                    pitch -= md.y * 0.01f * mouseSensitivity;
-                    pitch = Clamp(pitch, -1.3f, 1.3f);
-                    Vector3 forward = { -sinf(server.players[0].yawRadians), 0.0f, -cosf(server.players[0].yawRadians) };
-                    Vector3 right = { -forward.z, 0.0f, forward.x };
-                    // Move with WASD relative to look
-                    Vector3 rel = {0};
-                    if (IsKeyDown(KEY_W)) rel = Vector3Add(rel, forward);
-                    if (IsKeyDown(KEY_S)) rel = Vector3Subtract(rel, forward);
-                    if (IsKeyDown(KEY_A)) rel = Vector3Subtract(rel, right);
-                    if (IsKeyDown(KEY_D)) rel = Vector3Add(rel, right);
-                    if (Vector3Length(rel) > 0) rel = Vector3Normalize(rel);
-                    float speed = 6.0f * GetFrameTime();
-                    if (IsKeyDown(KEY_LEFT_SHIFT)) speed *= 1.8f;
-                    server.players[0].position = Vector3Add(server.players[0].position, Vector3Scale(rel, speed));
-                    camera.position = Vector3Add(server.players[0].position, {0.0f, 1.7f, 0.0f});
-                    Vector3 lookDir = { cosf(pitch) * -sinf(server.players[0].yawRadians), sinf(pitch), cosf(pitch) * -cosf(server.players[0].yawRadians) };
+                    sampler.mouseRecentered();
+                    camera.position = Vector3Add(toRl(view.position(localPlayer)), {0.0f, 1.7f, 0.0f});
+                    const float lookYaw = sampler.lookYaw();
+                    const float lookPitch = sampler.lookPitch();
+                    Vector3 lookDir = { cosf(lookPitch) * -sinf(lookYaw), sinf(lookPitch), cosf(lookPitch) * -cosf(lookYaw) };
                     camera.target = Vector3Add(camera.position, lookDir);
                 } else {
-                    // Third-person camera: orbit behind player 0
+                    // Third-person camera: orbit behind the local player
                     float dist = 5.0f;
                     float height = 2.0f;
-                    Vector3 back = { sinf(server.players[0].yawRadians), 0.0f, cosf(server.players[0].yawRadians) };
-                    camera.target = Vector3Add(server.players[0].position, {0.0f, 1.5f, 0.0f});
+                    Vector3 back = { sinf(view.yawRadians[localPlayer]), 0.0f, cosf(view.yawRadians[localPlayer]) };
+                    camera.target = Vector3Add(toRl(view.position(localPlayer)), {0.0f, 1.5f, 0.0f});
                     camera.position = Vector3Add(camera.target, Vector3Add(Vector3Scale(back, dist), Vector3{0.0f, height, 0.0f}));
                     EnableCursor();
+                    sampler.mouseRecentered();
+                }
+
+            } break;
+            case GameState::Replay: {
+                if (IsKeyPressed(KEY_ESCAPE)) {
+                    gameState = GameState::Menu;
+                    break;
+                }
+                if (IsKeyPressed(KEY_SPACE)) playbackPaused = !playbackPaused;
+                if (IsKeyPressed(KEY_F)) playbackFastForward = !playbackFastForward;
+
+                // Feed the fixed-step tick from the file: in real time, or uncapped while
+                // fast-forwarding (as many ticks as fit in ~12 ms so the window stays responsive)
+                double now = GetTime();
+                const float dt = playback.tickDt();
+                accumulator = std::min(accumulator + (now - lastTime), (double)kMaxCatchUpTicks * dt);
+                lastTime = now;
+                PlayerInput inputs[kMaxPlayers];
+                auto stepPlayback = [&]() {
+                    if (!nextReplayTick(playbackCursor, inputs)) return false;
+                    stepMatch(match, gameMap.data(), inputs, dt, &jobs);
+                    if (!checkReplayTick(playbackCursor, match) && !playbackDesync) {
+                        playbackDesync = true;
+                        TraceLog(LOG_WARNING, "REPLAY: Desync detected by tick %u", playbackCursor.tick);
+                    }
+                    return true;
+                };
+                if (playbackPaused) {
+                    accumulator = 0.0;
+                } else if (playbackFastForward) {
+                    while (GetTime() - now < 0.012 && stepPlayback()) {}
+                    accumulator = 0.0;
+                } else {
+                    while (accumulator >= dt) {
+                        accumulator -= dt;
+                        if (!stepPlayback()) { accumulator = 0.0; break; }
+                    }
                 }
 
+                // Third-person camera behind player 0
+                Vector3 back = { sinf(server.yawRadians[0]), 0.0f, cosf(server.yawRadians[0]) };
+                camera.target = Vector3Add(toRl(server.position(0)), {0.0f, 1.5f, 0.0f});
+                camera.position = Vector3Add(camera.target, Vector3Add(Vector3Scale(back, 5.0f), Vector3{0.0f, 2.0f, 0.0f}));
+                EnableCursor();
             } break;
             case GameState::Pause: {
+                if (online) {
+                    // Stand still rather than let the server time the seat out
+                    double now = GetTime();
+                    accumulator = std::min(accumulator + (now - lastTime), (double)kMaxCatchUpTicks * fixedDt);
+                    lastTime = now;
+                    for (; accumulator >= fixedDt; accumulator -= fixedDt) netClient.sendInput(PlayerInput{}, now);
+                }
                 if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_ESCAPE)) {
                     gameState = GameState::Arena;
                 }
                 if (IsKeyPressed(KEY_BACKSPACE)) {
+                    if (online) {
+                        netClient.disconnect();
+                        online = false;
+                        joined = false;
+                        localPlayer = 0;
+                        startMatch();
+                    }
                     gameState = GameState::Menu;
                 }
             } break;
@@ -436,23 +681,50 @@ int main() {
             }
         }
 
-        // Draw
+        const bool matchOnScreen = gameState == GameState::Arena || gameState == GameState::Replay || gameState == GameState::Pause;
+        {
+            AllocScope assetScope(AllocTag::Assets);
+            holdCharacters(matchOnScreen ? &shown->server : nullptr);
+        }
+        if (matchOnScreen) {
+            PROFILE_ZONE("particles");
+            AllocScope particleScope(AllocTag::Particles);
+            if (fxPreviousValid) {
+                simEvents.clear();
+                collectSimEvents(fxPrevious, *shown, simEvents);
+                for (const SimEvent &event : simEvents) particles.spawn(event);
+            }
+            fxPrevious = *shown;
+            fxPreviousValid = true;
+            if (gameState != GameState::Pause) particles.update(GetFrameTime());
+        } else if (fxPreviousValid) {
+            particles.clear();
+            fxPreviousValid = false;
+        }
+
+        // Draw; everything from here to the end of the frame counts as rendering
+        AllocScope renderScope(AllocTag::Render);
         BeginDrawing();
         ClearBackground(BLACK);
+        renderStats.reset();
 
         if (gameState == GameState::Menu) {
             DrawText("epiCBattle", 40, 40, 64, RAYWHITE);
             DrawText("Press Enter to Start", 40, 130, 30, LIGHTGRAY);
             DrawText("Press S for Settings", 40, 170, 24, GRAY);
+            DrawText("Press R to watch the last replay", 40, 200, 24, GRAY);
         } else if (gameState == GameState::ModeSelect) {
             DrawText("Select Mode", 40, 40, 48, RAYWHITE);
             DrawText("1v1 Arena (Enter)", 40, 110, 28, LIGHTGRAY);
-            DrawText("Esc: Back", 40, 160, 20, GRAY);
+            DrawText(TextFormat("Free-for-all, %d fighters (F)", kDefaultFreeForAllPlayers), 40, 145, 28, LIGHTGRAY);
+            DrawText(TextFormat("Player 2: %s (B)", botOpponent ? "bot" : "arrow keys"), 40, 195, 24, GRAY);
+            DrawText("Esc: Back", 40, 235, 20, GRAY);
         } else if (gameState == GameState::MapSelect) {
             DrawText("Select Map", 40, 40, 48, RAYWHITE);
             DrawText("Left/Right: Change, Enter: Confirm, Esc: Back", 40, 100, 20, GRAY);
-            DrawText("Green Arena", 60, 160, 32, DARKGREEN);
-            DrawText("Desert Arena", 60, 210, 32, Color{200,180,120,255});
+            for (int i = 0; i < (int)mapNames.size(); ++i) {
+                DrawText(mapNames[i].c_str(), 60, 160 + i * 50, 32, i == mapIdx ? YELLOW : GRAY);
+            }
         } else if (gameState == GameState::CharacterSelect) {
             DrawText("Select Your Fighter", 40, 40, 48, RAYWHITE);
             DrawText("Left/Right to change, Enter to confirm, Esc to back", 40, 100, 20, GRAY);
@@ -474,64 +746,115 @@ int main() {
             rlViewport((int)vp.x, (int)vp.y, (int)vp.width, (int)vp.height);
             BeginMode3D(camera);
             DrawGrid(10, 1.0f);
-            if (selectedIndex >= 0 && selectedIndex < (int)loaded.size() && loaded[selectedIndex].loaded) {
+            const ModelAsset *preview = characterModel(selectedIndex);
+            if (preview) {
                 // Idle sway
                 float t = (float)GetTime();
                 float scale = 1.0f + 0.03f * sinf(t * 2.0f);
                 Vector3 pos = {0.0f, 0.0f, 0.0f};
-                DrawModelEx(loaded[selectedIndex].model, pos, {0,1,0}, 0.0f, {scale, scale, scale}, WHITE);
+                if (instancingShader.id != 0) {
+                    Matrix transform = MatrixMultiply(preview->model.transform, MatrixScale(scale, scale, scale));
+                    drawModelInstanced(preview->model, instancingShader, &transform, 1, WHITE, renderStats, preview->dequantizationData());
+                } else {
+                    DrawModelEx(preview->model, pos, {0,1,0}, 0.0f, {scale, scale, scale}, WHITE);
+                }
+            } else {
+                // Placeholder until the model finishes streaming in
+                float t = (float)GetTime();
+                DrawCubeWires({0.0f, 1.0f + 0.1f * sinf(t * 3.0f), 0.0f}, 0.8f, 2.0f, 0.8f, GRAY);
             }
             EndMode3D();
             rlViewport(0, 0, GetScreenWidth(), GetScreenHeight());
             DrawRectangleLines(vpX, vpY, vpW, vpH, DARKGRAY);
-        } else if (gameState == GameState::Arena) {
-            BeginMode3D(camera);
-            DrawPlane({0.0f, 0.0f, 0.0f}, {mapData.arenaSize.x, mapData.arenaSize.z}, mapData.arenaColor);
-            for (const auto &b : mapData.obstacles) {
-                Vector3 size = { b.max.x - b.min.x, b.max.y - b.min.y, b.max.z - b.min.z };
-                Vector3 center = { (b.min.x + b.max.x)*0.5f, (b.min.y + b.max.y)*0.5f, (b.min.z + b.max.z)*0.5f };
-                bool isDesert = (mapData.arenaColor.r==200 && mapData.arenaColor.g==180);
-                DrawCube(center, size.x, size.y, size.z, isDesert?Color{160,140,100,255}:GRAY);
-            }
-            DrawCube({-mapData.arenaSize.x * 0.5f, 0.5f, 0.0f}, 1.0f, 1.0f, 1.0f, RED);
-            DrawCube({ mapData.arenaSize.x * 0.5f, 0.5f, 0.0f}, 1.0f, 1.0f, 1.0f, BLUE);
-            // Draw two players
-            for (int i = 0; i < 2; ++i) {
-                int ci = server.players[i].characterIndex;
-                if (ci >= 0 && ci < (int)loaded.size() && loaded[ci].loaded) {
-                    float t = (float)GetTime();
-                    float moveSway = 0.02f * sinf(t * 6.0f);
-                    float atkPulse = server.players[i].attacking ? 0.2f : 0.0f;
-                    float scale = 1.0f + moveSway + atkPulse;
-                    Color tint = i == 0 ? WHITE : LIGHTGRAY;
-                    DrawModelEx(
-                        loaded[ci].model,
-                        server.players[i].position,
-                        {0,1,0},
-                        server.players[i].yawRadians * RAD2DEG,
-                        {scale, scale, scale},
-                        tint
-                    );
+            if (!preview) DrawText("Loading...", vpX + 20, vpY + 20, 24, GRAY);
+        } else if (gameState == GameState::Arena || gameState == GameState::Replay) {
+            // Offline this is the sim thread's newest tick blended toward the present
+            const MatchState &view = *shown;
+            {
+                PROFILE_ZONE("draw 3D");
+                BeginMode3D(camera);
+                drawStaticBatch(staticBatch, renderStats);
+                // Draw all players: the local one on its own for the highlight tint, everyone else batched per character
+                float t = (float)GetTime();
+                // Model lookups touch the asset manager, so they happen here and not in the jobs
+                for (int c = 0; c < (int)frameModels.size(); ++c) frameModels[c] = characterModel(c);
+                frameCull.view = &view.server;
+                frameCull.frustum = currentFrustum();
+                frameCull.playerCount = view.server.playerCount;
+                frameCull.instanced = instancingShader.id != 0;
+                frameCull.moveSway = 0.02f * sinf(t * 6.0f);
+                const int playerCount = frameCull.playerCount;
+                const bool instanced = frameCull.instanced;
+                frameGraph.run(jobs);
+
+                for (int i = 0; i < playerCount; ++i) {
+                    const ModelAsset *lc = frameModels[view.server.characterIndex[i]];
+                    Color tint = i == localPlayer ? WHITE : LIGHTGRAY;
+                    if (!lc) {
+                        // Still streaming in: stand-in box of roughly the fighter's size
+                        Vector3 p = toRl(view.server.position(i));
+                        DrawCubeWires({p.x, p.y + 1.0f, p.z}, 0.8f, 2.0f, 0.8f, tint);
+                        continue;
+                    }
+                    const FighterView &fighter = fighterViews[i];
+                    if (fighter.lod < 0) continue;
+                    const Model &model = lc->lod(fighter.lod);
+                    if (!instanced) {
+                        const float scale = fighter.scale;
+                        DrawModelEx(model, toRl(view.server.position(i)), {0,1,0}, view.server.yawRadians[i] * RAD2DEG, {scale, scale, scale}, tint);
+                        renderStats.drawCalls += model.meshCount;
+                        renderStats.instances++;
+                        for (int m = 0; m < model.meshCount; ++m) renderStats.triangles += model.meshes[m].triangleCount;
+                    } else if (i == localPlayer) {
+                        drawModelInstanced(model, instancingShader, &fighter.transform, 1, tint, renderStats, lc->dequantizationData());
+                    }
+                }
+                for (int slot = 0; slot < (int)instanceBatches.size(); ++slot) {
+                    const ModelAsset *lc = frameModels[slot / kMaxModelLods];
+                    const InstanceBatch &batch = instanceBatches[slot];
+                    if (!lc || batch.count == 0) continue;
+                    drawModelInstanced(lc->lod(slot % kMaxModelLods), instancingShader, batch.transforms, batch.count, LIGHTGRAY,
+                                       renderStats, lc->dequantizationData());
                 }
+                drawParticles(particleRenderer, particles, camera, renderStats);
+                EndMode3D();
             }
-            EndMode3D();
             // HUD
-            DrawText("Esc: Pause | C: View | P: Settings | F11: Fullscreen", 20, 20, 20, GRAY);
-            DrawText("LMB/RMB: Light/Heavy (P1), RCtrl/RAlt: Light/Heavy (P2)", 20, 44, 18, DARKGRAY);
+            PROFILE_ZONE("draw HUD");
+            if (gameState == GameState::Replay) {
+                bool ended = playbackCursor.tick >= playback.tickCount;
+                DrawText(TextFormat("REPLAY  tick %u/%u%s%s", playbackCursor.tick, playback.tickCount,
+                                    ended ? "  (end)" : (playbackPaused ? "  (paused)" : (playbackFastForward ? "  (fast-forward)" : "")),
+                                    playbackDesync ? "  DESYNC" : ""), 20, 20, 20, playbackDesync ? RED : GRAY);
+                DrawText("Space: Pause | F: Fast-forward | Esc: Main Menu", 20, 44, 18, DARKGRAY);
+            } else {
+                DrawText("Esc: Pause | C: View | P: Settings | F3: Stats | F6: Latency | F7: Assets | F11: Fullscreen", 20, 20, 20, GRAY);
+                DrawText("LMB/RMB: Light/Heavy (P1), RCtrl/RAlt: Light/Heavy (P2)", 20, 44, 18, DARKGRAY);
+            }
             // Health bars
             float barW = 300.0f;
             float barH = 20.0f;
             DrawRectangle(20, 60, (int)barW, (int)barH, DARKGRAY);
-            DrawRectangle(20, 60, (int)(barW * (server.players[0].health/100.0f)), (int)barH, RED);
-            DrawRectangle(GetScreenWidth() - 20 - (int)barW, 60, (int)barW, (int)barH, DARKGRAY);
-            DrawRectangle(GetScreenWidth() - 20 - (int)barW, 60, (int)(barW * (server.players[1].health/100.0f)), (int)barH, BLUE);
-            // Scoreboard
-            DrawText(TextFormat("Score %d - %d", playerScore[0], playerScore[1]), GetScreenWidth()/2 - 80, 20, 24, YELLOW);
-            if (!roundActive && lastScorer != -1) {
-                DrawText(lastScorer == 0 ? "KO! Player 1 scores" : "KO! Player 2 scores", GetScreenWidth()/2 - 120, 60, 24, ORANGE);
+            DrawRectangle(20, 60, (int)(barW * (view.server.health[0]/100.0f)), (int)barH, RED);
+            if (!view.freeForAll()) {
+                DrawRectangle(GetScreenWidth() - 20 - (int)barW, 60, (int)barW, (int)barH, DARKGRAY);
+                DrawRectangle(GetScreenWidth() - 20 - (int)barW, 60, (int)(barW * (view.server.health[1]/100.0f)), (int)barH, BLUE);
+                // Scoreboard
+                DrawText(TextFormat("Score %d - %d", view.playerScore[0], view.playerScore[1]), GetScreenWidth()/2 - 80, 20, 24, YELLOW);
+                if (!view.roundActive && view.lastScorer != -1) {
+                    DrawText(view.lastScorer == 0 ? "KO! Player 1 scores" : "KO! Player 2 scores", GetScreenWidth()/2 - 120, 60, 24, ORANGE);
+                }
+            } else {
+                int alive = 0;
+                for (int i = 0; i < view.server.playerCount; ++i) alive += view.server.alive(i) ? 1 : 0;
+                DrawText(TextFormat("Alive %d/%d | Your score %d", alive, view.server.playerCount, view.playerScore[0]), GetScreenWidth()/2 - 140, 20, 24, YELLOW);
+                if (!view.roundActive) {
+                    const char *msg = view.lastScorer < 0 ? "Draw!" : TextFormat("Player %d wins the round", view.lastScorer + 1);
+                    DrawText(msg, GetScreenWidth()/2 - 140, 60, 24, ORANGE);
+                }
             }
             // Crosshair for FPS
-            if (viewMode == ViewMode::FirstPerson) {
+            if (viewMode == ViewMode::FirstPerson && gameState == GameState::Arena) {
                 int cx = GetScreenWidth()/2;
                 int cy = GetScreenHeight()/2;
                 DrawLine(cx-8, cy, cx+8, cy, RAYWHITE);
@@ -542,17 +865,126 @@ int main() {
             DrawText(TextFormat("FOV: %d  (+/= , -)", (int)fieldOfView), 40, 110, 24, LIGHTGRAY);
             DrawText(TextFormat("Mouse sensitivity: %.2f  ([ , ])", mouseSensitivity), 40, 140, 24, LIGHTGRAY);
             DrawText(TextFormat("Cursor lock (L): %s", lockCursor ? "ON" : "OFF"), 40, 170, 24, LIGHTGRAY);
-            DrawText("Enter: Back to Select | Esc: Main Menu", 40, 210, 20, GRAY);
+            static const char *kQualityNames[] = {"High", "Medium", "Low"};
+            DrawText(TextFormat("Texture quality (T): %s  (%.1f MB resident)", kQualityNames[(int)assets.textureQuality()],
+                                assets.residentTextureBytes() / (1024.0 * 1024.0)), 40, 200, 24, LIGHTGRAY);
+            DrawText("Enter: Back to Select | Esc: Main Menu", 40, 240, 20, GRAY);
         } else if (gameState == GameState::Pause) {
             DrawText("Paused", GetScreenWidth()/2 - 60, GetScreenHeight()/2 - 40, 48, RAYWHITE);
             DrawText("Enter/Esc: Resume", GetScreenWidth()/2 - 100, GetScreenHeight()/2 + 20, 20, GRAY);
             DrawText("Backspace: Main Menu", GetScreenWidth()/2 - 110, GetScreenHeight()/2 + 50, 20, GRAY);
         }
 
-        EndDrawing();
+        if (showRenderStats) {
+            int x = GetScreenWidth() - 300;
+            DrawRectangle(x - 10, GetScreenHeight() - 220, 300, 210, Fade(BLACK, 0.6f));
+            // Heap use since the previous frame: the total, then each subsystem that allocated
+            unsigned long long heapAllocs = 0;
+            double heapBytes = 0.0;
+            char tags[192] = "";
+            int tagsLength = 0;
+            for (int i = 0; i < kAllocTagCount; ++i) {
+                heapAllocs += frameAllocs[i].allocations;
+                heapBytes += (double)frameAllocs[i].bytes;
+                if (frameAllocs[i].allocations == 0 || tagsLength >= (int)sizeof(tags)) continue;
+                tagsLength += std::snprintf(tags + tagsLength, sizeof(tags) - tagsLength, "%s%s %llu", tagsLength > 0 ? "  " : "",
+                                            allocTagName((AllocTag)i), (unsigned long long)frameAllocs[i].allocations);
+            }
+            DrawText(TextFormat("Heap this frame: %llu allocs, %.1f KB", heapAllocs, heapBytes / 1024.0), x, GetScreenHeight() - 210, 16,
+                     heapAllocs > 0 ? YELLOW : GREEN);
+            DrawText(tagsLength > 0 ? tags : "(no subsystem allocated)", x, GetScreenHeight() - 188, 14, heapAllocs > 0 ? YELLOW : GREEN);
+            DrawText(TextFormat("FPS %d  frame %.2f ms (worst %.2f)", GetFPS(), frameTimes.average(), frameTimes.worst()), x, GetScreenHeight() - 166, 16, GREEN);
+            DrawText(TextFormat("Sim ticks dropped: %u", simDroppedTicks), x, GetScreenHeight() - 144, 16, GREEN);
+            DrawText(TextFormat("Fighters LOD0-3: %d/%d/%d/%d", renderStats.lodInstances[0], renderStats.lodInstances[1],
+                                renderStats.lodInstances[2], renderStats.lodInstances[3]), x, GetScreenHeight() - 122, 16, GREEN);
+            DrawText(TextFormat("Culled: %d  Particles: %d", renderStats.culled, particles.liveCount()), x, GetScreenHeight() - 100, 16, GREEN);
+            DrawText(TextFormat("Mesh draw calls: %d", renderStats.drawCalls), x, GetScreenHeight() - 78, 16, GREEN);
+            DrawText(TextFormat("Instances: %d", renderStats.instances), x, GetScreenHeight() - 56, 16, GREEN);
+            DrawText(TextFormat("Triangles: %lld", renderStats.triangles), x, GetScreenHeight() - 34, 16, GREEN);
+        }
+
+        if (showProfiler) {
+            if (GetTime() - profileStatsTime > 0.25) {
+                profileStats = profilerZoneStats(kProfileWindowSeconds);
+                profileStatsTime = GetTime();
+            }
+            int rows = (int)profileStats.size() < 14 ? (int)profileStats.size() : 14;
+            int y = GetScreenHeight() - 40 - rows * 18;
+            DrawRectangle(10, y - 34, 620, rows * 18 + 60, Fade(BLACK, 0.6f));
+            DrawText(TextFormat("Profiler, last %.0f s (ms)     count    mean     p50     p95     p99     max", kProfileWindowSeconds), 20, y - 26, 14, GREEN);
+            for (int i = 0; i < rows; ++i) {
+                const ZoneStats &z = profileStats[i];
+                DrawText(z.name, 20, y + i * 18, 14, GREEN);
+                DrawText(TextFormat("%6d %7.3f %7.3f %7.3f %7.3f %7.3f", z.count, z.meanMs, z.p50Ms, z.p95Ms, z.p99Ms, z.maxMs), 220, y + i * 18, 14, GREEN);
+            }
+            DrawText(TextFormat("F5: dump last %.0f s to a Chrome trace", kTraceDumpSeconds), 20, y + rows * 18 + 4, 14, GRAY);
+        }
+
+        if (showAssets) {
+            // Resident bytes per asset against the budgets; unreferenced ones are eviction candidates
+            static const char *kKindNames[] = {"model", "material", "texture"};
+            const std::vector<AssetInfo> rows = assets.assets();
+            const AssetBudget &budget = assets.budget();
+            int y = 60;
+            DrawRectangle(10, y - 10, 760, (int)rows.size() * 18 + 50, Fade(BLACK, 0.6f));
+            DrawText(TextFormat("Assets  CPU %.1f / %.1f MB  GPU %.1f / %.1f MB", assets.residentCpuBytes() / (1024.0 * 1024.0),
+                                budget.cpuBytes / (1024.0 * 1024.0), assets.residentGpuBytes() / (1024.0 * 1024.0),
+                                budget.gpuBytes / (1024.0 * 1024.0)), 20, y, 16, GREEN);
+            DrawText("kind        refs   CPU KB    GPU KB   state", 20, y + 22, 14, GREEN);
+            for (int i = 0; i < (int)rows.size(); ++i) {
+                const AssetInfo &a = rows[i];
+                const char *state = a.loading ? "loading" : (a.resident ? "resident" : "evicted");
+                DrawText(TextFormat("%-9s %4d %9.1f %9.1f   %-8s  %s", kKindNames[(int)a.kind], a.refs, a.cpuBytes / 1024.0,
+                                    a.gpuBytes / 1024.0, state, a.name.c_str()), 20, y + 40 + i * 18, 14, a.resident ? GREEN : GRAY);
+            }
+        }
+
+        // Latency mode: a white square on the frame that first shows a new press, for a camera
+        // or photodiode to check the in-game number against
+        const bool latencyFrame = latencyMode && latencyPress > latencyShown;
+        if (latencyMode) {
+            DrawText(TextFormat("Input to present %.1f ms (worst %.1f, %d presses)", inputLatency.average(), inputLatency.worst(),
+                                inputLatency.count), GetScreenWidth() - 460, 20, 16, GREEN);
+            if (latencyFrame) DrawRectangle(GetScreenWidth() - 70, 50, 60, 60, WHITE);
+        }
+
+        {
+            PROFILE_ZONE("present");
+            EndDrawing();
+        }
+        sampler.mouseRecentered();  // EndDrawing polled input, which restarts raylib's mouse delta
+        if (latencyFrame) {
+            inputLatency.push((float)((inputClockSeconds() - latencyPress) * 1000.0));
+            latencyShown = latencyPress;
+        }
+        // Wait out the rest of the frame, sampling input meanwhile so its timing does not
+        // depend on the frame rate
+        if (targetFps > 0) {
+            PROFILE_ZONE("frame wait");
+            nextFrameSeconds = std::max(nextFrameSeconds + 1.0 / targetFps, inputClockSeconds());
+            for (double now = inputClockSeconds(); now < nextFrameSeconds; now = inputClockSeconds()) {
+                if (sampling) {
+                    AllocScope inputScope(AllocTag::Input);
+                    pollInputBetweenFrames();
+                    sampler.sample(now, inputQueue);
+                }
+                WaitTime(std::min(kInputSampleSeconds, nextFrameSeconds - now));
+            }
+        }
+        if (!firstFramePresented) {
+            firstFramePresented = true;
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - processStart).count();
+            TraceLog(LOG_INFO, "STARTUP: cold start to first frame %.1f ms", ms);
+        }
     }
 
-    unloadAll();
+    if (online) netClient.disconnect();
+    simThread->stop();
+    saveRecording();
+    assets.unloadAll();
+    unloadStaticBatch(staticBatch);
+    unloadParticleRenderer(particleRenderer);
+    if (instancingShader.id != 0) UnloadShader(instancingShader);
     CloseWindow();
     return 0;
 }
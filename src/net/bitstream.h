@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Little-endian bit packing for network packets, buffered through a 64-bit scratch word.
+// Writers and readers never touch memory past their buffer: an overflowing write or an
+// over-read sets the failed flag instead. Values are at most 32 bits.
+
+static inline uint32_t bitMask(int bits) { return bits >= 32 ? 0xFFFFFFFFu : ((1u << bits) - 1); }
+
+class BitWriter {
+public:
+    BitWriter(uint8_t *data, size_t capacity) : data_(data), capacity_(capacity) {}
+
+    void write(uint32_t value, int bits) {
+        scratch_ |= (uint64_t)(value & bitMask(bits)) << scratchBits_;
+        scratchBits_ += bits;
+        while (scratchBits_ >= 8) {
+            if (pos_ >= capacity_) { failed_ = true; return; }
+            data_[pos_++] = (uint8_t)scratch_;
+            scratch_ >>= 8;
+            scratchBits_ -= 8;
+        }
+        // Keep the partial byte in the buffer so bytes() is always complete
+        if (scratchBits_ > 0) {
+            if (pos_ >= capacity_) { failed_ = true; return; }
+            data_[pos_] = (uint8_t)scratch_;
+        }
+    }
+    void writeBool(bool value) { write(value ? 1u : 0u, 1); }
+    // Two's complement in `bits` bits; the caller guarantees the value fits.
+    void writeSigned(int32_t value, int bits) { write((uint32_t)value, bits); }
+
+    size_t bytes() const { return pos_ + (scratchBits_ > 0 ? 1 : 0); }
+    bool failed() const { return failed_; }
+
+private:
+    uint8_t *data_;
+    size_t capacity_;
+    size_t pos_ = 0;
+    uint64_t scratch_ = 0;
+    int scratchBits_ = 0;
+    bool failed_ = false;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    uint32_t read(int bits) {
+        while (scratchBits_ < bits) {
+            if (pos_ >= size_) { failed_ = true; return 0; }
+            scratch_ |= (uint64_t)data_[pos_++] << scratchBits_;
+            scratchBits_ += 8;
+        }
+        uint32_t value = (uint32_t)scratch_ & bitMask(bits);
+        scratch_ >>= bits;
+        scratchBits_ -= bits;
+        return value;
+    }
+    bool readBool() { return read(1) != 0; }
+    int32_t readSigned(int bits) {
+        uint32_t v = read(bits);
+        if (bits < 32 && (v & (1u << (bits - 1)))) v |= ~bitMask(bits);
+        return (int32_t)v;
+    }
+
+    bool failed() const { return failed_; }
+
+private:
+    const uint8_t *data_;
+    size_t size_;
+    size_t pos_ = 0;
+    uint64_t scratch_ = 0;
+    int scratchBits_ = 0;
+    bool failed_ = false;
+};
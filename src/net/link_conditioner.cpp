@@ -0,0 +1,33 @@
+#include "net/link_conditioner.h"
+
+#include <algorithm>
+
+float LinkConditioner::uniform() {
+    // xorshift32
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return (float)(rng_ >> 8) / 16777216.0f;
+}
+
+void LinkConditioner::enqueue(const NetAddress &to, const void *data, size_t size, double now) {
+    if (uniform() * 100.0f < config_.lossPercent) {
+        dropped_++;
+        return;
+    }
+    double delayMs = config_.latencyMs + (uniform() * 2.0f - 1.0f) * config_.jitterMs;
+    if (uniform() * 100.0f < config_.reorderPercent) {
+        // Held back long enough for the next few packets to overtake it
+        delayMs += 2.0 * config_.jitterMs + 40.0;
+        reordered_++;
+    }
+    if (delayMs < 0.0) delayMs = 0.0;
+    const uint8_t *bytes = (const uint8_t *)data;
+    queue_.push_back({now + delayMs / 1000.0, nextOrder_++, to, std::vector<uint8_t>(bytes, bytes + size)});
+}
+
+void LinkConditioner::sortQueue() {
+    std::sort(queue_.begin(), queue_.end(), [](const Delayed &a, const Delayed &b) {
+        return a.deliverAt != b.deliverAt ? a.deliverAt < b.deliverAt : a.order < b.order;
+    });
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "net/udp_socket.h"
+
+// Simulates a bad network on the sending side of a UdpSocket: drops, delays with jitter
+// and reorders datagrams. Deterministic for a given seed.
+struct LinkConditionerConfig {
+    float lossPercent = 0.0f;
+    float latencyMs = 0.0f;         // one way
+    float jitterMs = 0.0f;          // uniform +-jitter on top of latency
+    float reorderPercent = 0.0f;    // extra delay so the packet lands behind later ones
+    uint32_t seed = 1;
+};
+
+class LinkConditioner {
+public:
+    explicit LinkConditioner(const LinkConditionerConfig &config) : config_(config), rng_(config.seed ? config.seed : 1) {}
+
+    void enqueue(const NetAddress &to, const void *data, size_t size, double now);
+
+    // Hands every datagram due by now to send, in delivery order.
+    template <typename SendFn>
+    void release(double now, SendFn &&send) {
+        size_t kept = 0;
+        sortQueue();
+        for (size_t i = 0; i < queue_.size(); ++i) {
+            if (queue_[i].deliverAt <= now) send(queue_[i].to, queue_[i].data.data(), queue_[i].data.size());
+            else if (kept++ != i) queue_[kept - 1] = std::move(queue_[i]);
+        }
+        queue_.resize(kept);
+    }
+
+    uint64_t dropped() const { return dropped_; }
+    uint64_t reordered() const { return reordered_; }
+
+private:
+    struct Delayed {
+        double deliverAt;
+        uint64_t order;
+        NetAddress to;
+        std::vector<uint8_t> data;
+    };
+
+    float uniform();    // [0, 1)
+    void sortQueue();
+
+    LinkConditionerConfig config_;
+    uint32_t rng_;
+    uint64_t nextOrder_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t reordered_ = 0;
+    std::vector<Delayed> queue_;
+};
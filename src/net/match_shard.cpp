@@ -0,0 +1,198 @@
+#include "net/match_shard.h"
+
+#include <chrono>
+#include <thread>
+#include "core/profiler.h"
+#include "net/protocol.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+static const double kWheelSlotSeconds = 0.001;
+static const int kWheelSlots = 64;              // 64 ms, a few ticks
+static const double kStatsPublishSeconds = 0.25;
+
+bool pinThreadToCore(int cpu) {
+    if (cpu < 0) return false;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#else
+    return false;
+#endif
+}
+
+MatchShard::MatchShard(const ShardConfig &config)
+    : config_(config), wheel_(kWheelSlotSeconds, kWheelSlots), batch_(new RecvBatch) {}
+
+MatchShard::~MatchShard() {
+#ifdef __linux__
+    if (epoll_ >= 0) ::close(epoll_);
+#endif
+}
+
+bool MatchShard::open() {
+    if (!socket_.open(config_.port, false, true)) return false;
+#ifdef __linux__
+    epoll_ = epoll_create1(0);
+    if (epoll_ < 0) return false;
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = socket_.handle();
+    if (epoll_ctl(epoll_, EPOLL_CTL_ADD, socket_.handle(), &ev) != 0) return false;
+#endif
+    return true;
+}
+
+ShardStats MatchShard::stats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return published_;
+}
+
+void MatchShard::publishStats() {
+    ShardStats s = work_;
+    s.matches = 0;
+    s.clients = 0;
+    s.net = retired_;
+    for (size_t id = 0; id < matches_.size(); ++id) {
+        if (!live_[id]) continue;
+        s.matches++;
+        s.clients += matches_[id]->clientCount();
+        s.net.add(matches_[id]->stats());
+    }
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    published_ = s;
+}
+
+// A match with a free seat, creating one if needed; -1 when the shard is full.
+int MatchShard::openMatch(double now) {
+    for (size_t id = 0; id < matches_.size(); ++id) {
+        if (live_[id] && matches_[id]->clientCount() < matches_[id]->seatCount()) return (int)id;
+    }
+    int id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    } else {
+        if ((int)matches_.size() >= config_.maxMatches) return -1;
+        id = (int)matches_.size();
+        matches_.emplace_back(new NetMatch(config_.historyDepth));
+        live_.push_back(0);
+        deadline_.push_back(0.0);
+    }
+    int characters[kMaxPlayers] = {};
+    matches_[id]->start(config_.map->data(), config_.map->name(), config_.playersPerMatch, characters);
+    live_[id] = 1;
+    // Each match keeps its own phase, so ticks spread over the frame instead of bunching up
+    deadline_[id] = now + kFixedDt;
+    wheel_.schedule(id, deadline_[id]);
+    return id;
+}
+
+void MatchShard::retireMatch(int id) {
+    wheel_.cancel(id);
+    retired_.add(matches_[id]->stats());
+    live_[id] = 0;
+    freeIds_.push_back(id);
+}
+
+void MatchShard::handle(const NetAddress &from, const uint8_t *data, int size, double now) {
+    uint8_t type = readPacketHeader(data, size);
+    if (type == 0) return;
+    auto route = routes_.find(addressKey(from));
+    if (route != routes_.end()) {
+        NetMatch &match = *matches_[route->second];
+        if (type == kPacketConnect) match.join(from, now, outbox_);
+        else match.handlePacket(from, type, data + kPacketHeaderBytes, size - kPacketHeaderBytes, now);
+        return;
+    }
+    if (type != kPacketConnect) return;
+    int id = openMatch(now);
+    if (id >= 0 && matches_[id]->join(from, now, outbox_)) {
+        routes_[addressKey(from)] = id;
+        return;
+    }
+    work_.rejected++;
+    uint8_t reject[kPacketHeaderBytes];
+    outbox_.push(from, reject, (size_t)writePacketHeader(reject, kPacketReject));
+}
+
+void MatchShard::tickMatch(int id, double now) {
+    NetMatch &match = *matches_[id];
+    if (now - deadline_[id] > kWheelSlotSeconds * 2) work_.lateTicks++;
+    auto start = std::chrono::steady_clock::now();
+    match.tick(now, outbox_);
+    work_.tickSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    work_.matchTicks++;
+
+    departed_.clear();
+    match.takeDeparted(departed_);
+    for (const NetAddress &a : departed_) routes_.erase(addressKey(a));
+    if (match.clientCount() == 0) {
+        retireMatch(id);
+        return;
+    }
+    // Deadlines advance by exactly one tick, so a late wake-up does not shift the phase
+    deadline_[id] += kFixedDt;
+    if (deadline_[id] < now - 8 * kFixedDt) deadline_[id] = now + kFixedDt;   // far behind: resync
+    wheel_.schedule(id, deadline_[id]);
+}
+
+void MatchShard::run(const std::atomic<bool> &stop) {
+    profilerSetThreadName("match worker");
+    pinThreadToCore(config_.cpu);
+    using Clock = std::chrono::steady_clock;
+    const auto origin = Clock::now();
+    auto seconds = [&]() { return std::chrono::duration<double>(Clock::now() - origin).count(); };
+    double nextPublish = 0.0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        double now = seconds();
+        // Sleep until the next match tick or a datagram, whichever comes first
+        double wait = wheel_.count() > 0 ? wheel_.nextDeadline(now) - now : 0.05;
+        int timeoutMs = wait <= 0.0 ? 0 : (int)(wait * 1000.0) + 1;
+        if (timeoutMs > 50) timeoutMs = 50;
+#ifdef __linux__
+        epoll_event ev;
+        epoll_wait(epoll_, &ev, 1, timeoutMs);
+#else
+        if (timeoutMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+        const double wake = seconds();
+        now = wake;
+        {
+            PROFILE_ZONE("shard receive");
+            while (socket_.receiveBatch(*batch_) > 0) {
+                work_.recvBatches++;
+                work_.packetsIn += (uint64_t)batch_->count;
+                for (int i = 0; i < batch_->count; ++i) {
+                    if (batch_->size[i] > 0) handle(batch_->from[i], batch_->data[i], batch_->size[i], now);
+                }
+                if (batch_->count < RecvBatch::kMaxPackets) break;
+            }
+        }
+        wheel_.advance(now, [&](int id) { tickMatch(id, now); });
+        if (!outbox_.empty()) {
+            PROFILE_ZONE("shard send");
+            work_.packetsOut += outbox_.count();
+            work_.sendBatches += (outbox_.count() + 63) / 64;
+            socket_.sendBatch(outbox_);
+            outbox_.clear();
+        }
+        work_.busySeconds += seconds() - wake;
+        if (wake >= nextPublish) {
+            publishStats();
+            nextPublish = wake + kStatsPublishSeconds;
+        }
+    }
+    publishStats();
+}
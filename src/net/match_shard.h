@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "core/timer_wheel.h"
+#include "game/maps.h"
+#include "net/net_match.h"
+#include "net/outbox.h"
+#include "net/udp_socket.h"
+
+// One worker thread's share of the dedicated server: a socket bound to the shared port
+// (SO_REUSEPORT, so the kernel keeps each client on the same worker), up to maxMatches
+// NetMatches, and a timer wheel that fires each match's fixed tick. Matches are created
+// when a client connects and no match here has a free seat, and freed when empty. The
+// worker sleeps in epoll (Linux) until the next tick or a datagram, drains the socket in
+// recvmmsg batches and sends each round of snapshots with sendmmsg.
+
+struct ShardConfig {
+    uint16_t port = 0;
+    const GameMap *map = nullptr;   // shared read-only by every shard; must outlive them
+    int playersPerMatch = 2;
+    int maxMatches = 256;
+    int historyDepth = 16;          // snapshot history per match; 1v1 full snapshots are tiny
+    int cpu = -1;                   // core to pin to, -1 = leave to the scheduler
+};
+
+struct ShardStats {
+    int matches = 0;
+    int clients = 0;
+    uint64_t rejected = 0;
+    uint64_t matchTicks = 0;
+    uint64_t lateTicks = 0;         // fired more than one slot after their deadline
+    uint64_t packetsIn = 0;
+    uint64_t packetsOut = 0;
+    uint64_t recvBatches = 0;
+    uint64_t sendBatches = 0;
+    double busySeconds = 0.0;       // everything but waiting in epoll
+    double tickSeconds = 0.0;       // inside NetMatch::tick
+    NetServerStats net;             // summed over live and finished matches
+};
+
+class MatchShard {
+public:
+    explicit MatchShard(const ShardConfig &config);
+    ~MatchShard();
+
+    bool open();
+    uint16_t localPort() const { return socket_.localPort(); }
+
+    // Runs until stop is set. Call on the worker thread.
+    void run(const std::atomic<bool> &stop);
+
+    // Thread-safe copy, refreshed by the worker a few times per second.
+    ShardStats stats() const;
+
+private:
+    static uint64_t addressKey(const NetAddress &a) { return ((uint64_t)a.ip << 16) | a.port; }
+
+    void handle(const NetAddress &from, const uint8_t *data, int size, double now);
+    int openMatch(double now);
+    void tickMatch(int id, double now);
+    void retireMatch(int id);
+    void publishStats();
+
+    ShardConfig config_;
+    UdpSocket socket_;
+    int epoll_ = -1;
+    TimerWheel wheel_;
+    std::vector<std::unique_ptr<NetMatch>> matches_;
+    std::vector<uint8_t> live_;
+    std::vector<double> deadline_;
+    std::vector<int> freeIds_;
+    std::unordered_map<uint64_t, int> routes_;      // client address -> match id
+    std::vector<NetAddress> departed_;
+    std::unique_ptr<RecvBatch> batch_;
+    Outbox outbox_;
+    ShardStats work_;
+    NetServerStats retired_;
+    mutable std::mutex statsMutex_;
+    ShardStats published_;
+};
+
+// Pins the calling thread to one core; false where unsupported.
+bool pinThreadToCore(int cpu);
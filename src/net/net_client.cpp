@@ -0,0 +1,133 @@
+#include "net/net_client.h"
+
+#include <cstring>
+#include "game/maps.h"
+#include "sim/replay.h"
+
+static const double kConnectResendSeconds = 0.25;
+
+NetClient::NetClient() : history_(new Snapshot[kSnapshotHistory]) {
+    for (int i = 0; i < kSnapshotHistory; ++i) history_[i].tick = 0;
+    std::memset(recentInputs_, 0, sizeof(recentInputs_));
+}
+
+bool NetClient::open() {
+    return socket_.open(0);
+}
+
+void NetClient::connect(const NetAddress &server, double now) {
+    server_ = server;
+    state_ = NetClientState::Connecting;
+    player_ = -1;
+    inputSeq_ = 0;
+    latestTick_ = 0;
+    appliedSeq_ = 0;
+    for (int i = 0; i < kSnapshotHistory; ++i) history_[i].tick = 0;
+    lastHeard_ = now;
+    lastSent_ = now - kConnectResendSeconds;   // send on the first update
+}
+
+void NetClient::disconnect() {
+    if (state_ == NetClientState::Connected || state_ == NetClientState::Connecting) {
+        uint8_t packet[kPacketHeaderBytes];
+        socket_.send(server_, packet, (size_t)writePacketHeader(packet, kPacketDisconnect));
+        socket_.pump(lastSent_);
+    }
+    state_ = NetClientState::Disconnected;
+}
+
+void NetClient::handleSnapshot(const uint8_t *data, int size) {
+    if (size < 4) return;
+    stats_.snapshotsReceived++;
+    stats_.snapshotBytes += (uint64_t)size + kPacketHeaderBytes;
+    uint32_t appliedSeq = readU32(data);
+    BitReader reader(data + 4, (size_t)(size - 4));
+    // The tick leads the packet; peek it so stale snapshots are dropped without decoding
+    BitReader tickPeek = reader;
+    uint32_t tick = tickPeek.read(32);
+    if (tickPeek.failed() || tick <= latestTick_) {
+        stats_.snapshotsStale++;
+        return;
+    }
+    uint32_t baseTick = peekSnapshotBaseline(reader);
+    const Snapshot *baseline = nullptr;
+    if (baseTick != 0) {
+        const Snapshot &held = history_[baseTick % kSnapshotHistory];
+        if (held.tick != baseTick) {
+            stats_.snapshotsUndecodable++;
+            return;
+        }
+        baseline = &held;
+    }
+    // Decode into the slot the tick will live in. The baseline is at most
+    // kSnapshotHistory - 1 ticks older, so it never shares that slot.
+    Snapshot &slot = history_[tick % kSnapshotHistory];
+    if (!decodeSnapshot(reader, baseline, slot)) {
+        slot.tick = 0;
+        stats_.snapshotsUndecodable++;
+        return;
+    }
+    latestTick_ = tick;
+    appliedSeq_ = appliedSeq;
+}
+
+void NetClient::update(double now) {
+    socket_.pump(now);
+    uint8_t packet[kMaxPacketBytes];
+    NetAddress from;
+    int size;
+    while ((size = socket_.receive(from, packet, sizeof(packet))) >= 0) {
+        if (from != server_) continue;
+        uint8_t type = readPacketHeader(packet, size);
+        const uint8_t *body = packet + kPacketHeaderBytes;
+        const int bodySize = size - kPacketHeaderBytes;
+        if (type == 0) continue;
+        lastHeard_ = now;
+        if (type == kPacketAccept && state_ == NetClientState::Connecting) {
+            // Seat and map name are used as an index and a file name; ignore anything off
+            if (bodySize < 3 || bodySize != 3 + body[2] || body[2] > kMaxMapNameBytes) continue;
+            const int seat = body[0] | (body[1] << 8);
+            std::string name((const char *)body + 3, body[2]);
+            if (seat >= kMaxPlayers || !isMapName(name)) continue;
+            player_ = seat;
+            mapName_ = std::move(name);
+            state_ = NetClientState::Connected;
+        } else if (type == kPacketReject && state_ == NetClientState::Connecting) {
+            state_ = NetClientState::Rejected;
+        } else if (type == kPacketSnapshot && state_ == NetClientState::Connected) {
+            handleSnapshot(body, bodySize);
+        } else if (type == kPacketDisconnect) {
+            state_ = NetClientState::Disconnected;
+        }
+    }
+    if ((state_ == NetClientState::Connecting || state_ == NetClientState::Connected) && now - lastHeard_ > kConnectionTimeoutSeconds) {
+        state_ = NetClientState::TimedOut;
+    }
+    if (state_ == NetClientState::Connecting && now - lastSent_ >= kConnectResendSeconds) {
+        uint8_t connect[kPacketHeaderBytes];
+        socket_.send(server_, connect, (size_t)writePacketHeader(connect, kPacketConnect));
+        lastSent_ = now;
+    }
+    socket_.pump(now);
+}
+
+void NetClient::sendInput(const PlayerInput &input, double now) {
+    if (state_ != NetClientState::Connected) return;
+    // Sequences start at 1 so 0 can mean "none yet" on the server
+    inputSeq_++;
+    std::memmove(recentInputs_ + 1, recentInputs_, sizeof(recentInputs_[0]) * (kInputRedundancy - 1));
+    recentInputs_[0] = packInput(input);
+    int count = inputSeq_ < (uint32_t)kInputRedundancy ? (int)inputSeq_ : kInputRedundancy;
+
+    std::vector<uint8_t> &packet = packetScratch_;
+    packet.resize(kPacketHeaderBytes + 9);
+    int n = writePacketHeader(packet.data(), kPacketInput);
+    writeU32(&packet[n], latestTick_);
+    writeU32(&packet[n + 4], inputSeq_);
+    packet[n + 8] = (uint8_t)count;
+    for (int k = 0; k < count; ++k) putVarint(packet, recentInputs_[k]);
+    socket_.send(server_, packet.data(), packet.size());
+    stats_.inputBytes += (uint64_t)packet.size();
+    lastSent_ = now;
+    socket_.pump(now);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "core/types.h"
+#include "net/protocol.h"
+#include "net/snapshot.h"
+#include "net/udp_socket.h"
+#include "sim/sim.h"
+
+// Client side of the UDP protocol. Sends one input per fixed tick, each packet carrying the
+// last kInputRedundancy inputs so a lost packet is covered by the next one. Received
+// snapshots are decoded against the client's own copy of the baseline and kept in a small
+// history; the newest tick decoded is acknowledged with every input packet.
+
+enum class NetClientState { Disconnected, Connecting, Connected, Rejected, TimedOut };
+
+struct NetClientStats {
+    uint64_t snapshotsReceived = 0;
+    uint64_t snapshotBytes = 0;
+    uint64_t snapshotsStale = 0;        // older than the newest already decoded
+    uint64_t snapshotsUndecodable = 0;  // baseline no longer held, or a malformed packet
+    uint64_t inputBytes = 0;
+};
+
+class NetClient {
+public:
+    NetClient();
+
+    bool open();
+    UdpSocket &socket() { return socket_; }
+
+    void connect(const NetAddress &server, double now);
+    void disconnect();
+    // Drains the socket and resends Connect while connecting. now is in seconds.
+    void update(double now);
+    void sendInput(const PlayerInput &input, double now);
+
+    NetClientState state() const { return state_; }
+    int playerIndex() const { return player_; }
+    const std::string &mapName() const { return mapName_; }
+    // Newest decoded snapshot, or null before the first one.
+    const Snapshot *latest() const { return latestTick_ ? &history_[latestTick_ % kSnapshotHistory] : nullptr; }
+    uint32_t latestTick() const { return latestTick_; }
+    // The newest input sequence the server had applied when it sent latest().
+    uint32_t appliedInputSeq() const { return appliedSeq_; }
+    const NetClientStats &stats() const { return stats_; }
+
+private:
+    void handleSnapshot(const uint8_t *data, int size);
+
+    UdpSocket socket_;
+    NetAddress server_;
+    NetClientState state_ = NetClientState::Disconnected;
+    double lastSent_ = 0.0;
+    double lastHeard_ = 0.0;
+    int player_ = -1;
+    std::string mapName_;
+    uint32_t inputSeq_ = 0;
+    uint32_t recentInputs_[kInputRedundancy];
+    uint32_t latestTick_ = 0;
+    uint32_t appliedSeq_ = 0;
+    std::unique_ptr<Snapshot[]> history_;
+    std::vector<uint8_t> packetScratch_;
+    NetClientStats stats_;
+};
@@ -0,0 +1,188 @@
+#include "net/net_match.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "core/profiler.h"
+#include "net/protocol.h"
+#include "sim/replay.h"
+
+void NetServerStats::add(const NetServerStats &o) {
+    ticks += o.ticks;
+    snapshotsSent += o.snapshotsSent;
+    fullSnapshots += o.fullSnapshots;
+    snapshotBytes += o.snapshotBytes;
+    fullSnapshotBytes += o.fullSnapshotBytes;
+    inputPackets += o.inputPackets;
+    inputBytes += o.inputBytes;
+    inputsApplied += o.inputsApplied;
+    inputsMissed += o.inputsMissed;
+    snapshotSeconds += o.snapshotSeconds;
+}
+
+NetMatch::NetMatch(int historyDepth) : historyDepth_(historyDepth), history_(new Snapshot[historyDepth]) {
+    for (int i = 0; i < historyDepth_; ++i) history_[i].tick = 0;
+}
+
+void NetMatch::start(const MapData &map, const std::string &mapName, int playerCount, const int characterIndices[]) {
+    map_ = &map;
+    mapName_ = mapName;
+    resetMatch(match_, map, playerCount, characterIndices);
+    tick_ = 0;
+    for (int i = 0; i < historyDepth_; ++i) history_[i].tick = 0;
+    seats_.assign(match_.server.playerCount, Seat{});
+    departed_.clear();
+}
+
+int NetMatch::clientCount() const {
+    int n = 0;
+    for (const Seat &s : seats_) n += s.connected ? 1 : 0;
+    return n;
+}
+
+const Snapshot *NetMatch::history(uint32_t tick) const {
+    if (tick == 0) return nullptr;
+    const Snapshot &snap = history_[tick & (uint32_t)(historyDepth_ - 1)];
+    return snap.tick == tick ? &snap : nullptr;
+}
+
+int NetMatch::findSeat(const NetAddress &from) const {
+    for (int i = 0; i < (int)seats_.size(); ++i) {
+        if (seats_[i].connected && seats_[i].address == from) return i;
+    }
+    return -1;
+}
+
+void NetMatch::unseat(Seat &seat) {
+    seat.connected = false;
+    departed_.push_back(seat.address);
+}
+
+void NetMatch::takeDeparted(std::vector<NetAddress> &out) {
+    out.insert(out.end(), departed_.begin(), departed_.end());
+    departed_.clear();
+}
+
+bool NetMatch::join(const NetAddress &from, double now, Outbox &out) {
+    // Connect is resent until Accept arrives, so a seated address just gets Accept again
+    int seat = findSeat(from);
+    for (int i = 0; i < (int)seats_.size() && seat < 0; ++i) {
+        if (seats_[i].connected) continue;
+        seats_[i] = Seat{};
+        seats_[i].connected = true;
+        seats_[i].address = from;
+        seat = i;
+    }
+    if (seat < 0) return false;
+    seats_[seat].lastHeard = now;
+    uint8_t packet[kPacketHeaderBytes + 3 + kMaxMapNameBytes];
+    const size_t nameBytes = std::min(mapName_.size(), (size_t)kMaxMapNameBytes);
+    int n = writePacketHeader(packet, kPacketAccept);
+    packet[n++] = (uint8_t)seat;
+    packet[n++] = (uint8_t)(seat >> 8);
+    packet[n++] = (uint8_t)nameBytes;
+    std::memcpy(packet + n, mapName_.data(), nameBytes);
+    n += (int)nameBytes;
+    out.push(from, packet, (size_t)n);
+    return true;
+}
+
+void NetMatch::handlePacket(const NetAddress &from, uint8_t type, const uint8_t *body, int size, double now) {
+    int seat = findSeat(from);
+    if (seat < 0) return;
+    if (type == kPacketInput) handleInput(seats_[seat], body, size, now);
+    else if (type == kPacketDisconnect) unseat(seats_[seat]);
+}
+
+void NetMatch::handleInput(Seat &seat, const uint8_t *data, int size, double now) {
+    if (size < 9) return;
+    uint32_t ack = readU32(data);
+    uint32_t newest = readU32(data + 4);
+    int count = data[8];
+    if (count < 1 || count > kInputRedundancy || newest < (uint32_t)count) return;
+    uint32_t codes[kInputRedundancy];
+    size_t pos = 9;
+    for (int k = 0; k < count; ++k) {
+        if (!getVarint(data, (size_t)size, pos, codes[k])) return;
+    }
+    seat.lastHeard = now;
+    stats_.inputPackets++;
+    stats_.inputBytes += (uint64_t)size + kPacketHeaderBytes;
+    // Acks only move forward; a reordered old packet must not pull the baseline back
+    if (ack > seat.ackedTick && ack <= tick_) seat.ackedTick = ack;
+    if (seat.nextSeq == 0) seat.nextSeq = newest;
+    for (int k = 0; k < count; ++k) {
+        uint32_t seq = newest - (uint32_t)k;
+        if (seq < seat.nextSeq) break;
+        int slot = (int)(seq % kInputBuffer);
+        seat.inputs[slot] = unpackInput(codes[k]);
+        seat.inputSeq[slot] = seq;
+    }
+    if (newest > seat.newestSeq) seat.newestSeq = newest;
+}
+
+PlayerInput NetMatch::takeInput(Seat &seat) {
+    if (seat.nextSeq == 0) return PlayerInput{};
+    // A client far ahead (server hitch, clock drift) skips forward rather than building latency
+    if (seat.newestSeq > seat.nextSeq + kInputBuffer / 2) seat.nextSeq = seat.newestSeq - 2;
+    int slot = (int)(seat.nextSeq % kInputBuffer);
+    if (seat.inputSeq[slot] == seat.nextSeq) {
+        seat.last = seat.inputs[slot];
+        seat.appliedSeq = seat.nextSeq++;
+        stats_.inputsApplied++;
+        return seat.last;
+    }
+    // Missing: lost beyond the redundancy window, or simply late. Hold the last input.
+    // Only skip the sequence if newer ones already arrived, otherwise wait for it.
+    if (seat.newestSeq > seat.nextSeq) seat.nextSeq++;
+    stats_.inputsMissed++;
+    return heldInput(seat.last);
+}
+
+void NetMatch::queueSnapshot(Seat &seat, const Snapshot &snap, Outbox &out) {
+    uint8_t packet[kMaxPacketBytes];
+    int n = writePacketHeader(packet, kPacketSnapshot);
+    writeU32(packet + n, seat.appliedSeq);
+    n += 4;
+    const Snapshot *baseline = (snap.tick - seat.ackedTick < (uint32_t)historyDepth_) ? history(seat.ackedTick) : nullptr;
+    BitWriter writer(packet + n, sizeof(packet) - n);
+    encodeSnapshot(snap, baseline, writer);
+    if (writer.failed()) return;
+    size_t size = n + writer.bytes();
+    out.push(seat.address, packet, size);
+    stats_.snapshotsSent++;
+    stats_.snapshotBytes += size;
+    if (!baseline) {
+        stats_.fullSnapshots++;
+        stats_.fullSnapshotBytes += size;
+    }
+}
+
+void NetMatch::tick(double now, Outbox &out) {
+    PROFILE_ZONE("server tick");
+    PlayerInput inputs[kMaxPlayers];
+    for (int i = 0; i < (int)seats_.size(); ++i) {
+        Seat &seat = seats_[i];
+        if (!seat.connected) continue;
+        if (now - seat.lastHeard > kConnectionTimeoutSeconds) unseat(seat);
+        else inputs[i] = takeInput(seat);
+    }
+    stepMatch(match_, *map_, inputs, kFixedDt);
+    tick_++;
+    stats_.ticks++;
+
+    auto start = std::chrono::steady_clock::now();
+    Snapshot &snap = history_[tick_ & (uint32_t)(historyDepth_ - 1)];
+    captureSnapshot(match_, tick_, snap);
+    for (Seat &seat : seats_) {
+        if (seat.connected) queueSnapshot(seat, snap, out);
+    }
+    stats_.snapshotSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (match_.matchOver) {
+        // Next match straight away; clients saw matchOver in this snapshot and see the reset in the next
+        int characters[kMaxPlayers];
+        for (int i = 0; i < match_.server.playerCount; ++i) characters[i] = match_.server.characterIndex[i];
+        resetMatch(match_, *map_, match_.server.playerCount, characters);
+    }
+}
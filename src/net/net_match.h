@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "game/maps.h"
+#include "net/outbox.h"
+#include "net/snapshot.h"
+#include "net/udp_socket.h"
+#include "sim/sim.h"
+
+// One authoritative match and its seats, without any socket of its own. The owner routes
+// datagrams in with handlePacket() and calls tick() at kFixedDt; everything the match
+// wants to send lands in an Outbox. NetServer wraps one of these around a socket; the
+// dedicated server packs hundreds into each worker thread (see net/match_shard.h).
+//
+// Each tick the match steps with the newest input each seated client has sent (seats
+// nobody has claimed stand idle) and sends every client the snapshot, delta-coded against
+// the newest one it acknowledged, or full if that baseline has left the history.
+
+struct NetServerStats {
+    uint64_t ticks = 0;
+    uint64_t snapshotsSent = 0;
+    uint64_t fullSnapshots = 0;
+    uint64_t snapshotBytes = 0;         // payload + packet headers, all clients
+    uint64_t fullSnapshotBytes = 0;
+    uint64_t inputPackets = 0;
+    uint64_t inputBytes = 0;
+    uint64_t inputsApplied = 0;
+    uint64_t inputsMissed = 0;          // seats with a client but no input for the tick
+    double snapshotSeconds = 0.0;       // capture + per-client encode, all ticks
+
+    void add(const NetServerStats &o);
+};
+
+class NetMatch {
+public:
+    // historyDepth: power of two <= kSnapshotHistory. Small matches can keep a short
+    // history; a baseline that has aged out just costs one full snapshot.
+    explicit NetMatch(int historyDepth = kSnapshotHistory);
+
+    // map must outlive the match; matches on the same map can share one GameMap. mapName is
+    // sent to clients on Accept so they open the same map file.
+    void start(const MapData &map, const std::string &mapName, int playerCount, const int characterIndices[]);
+
+    // Connect: seats the address (or re-sends Accept to a seated one). False when full.
+    bool join(const NetAddress &from, double now, Outbox &out);
+    // Input and Disconnect from a seated address; anything else is ignored.
+    void handlePacket(const NetAddress &from, uint8_t type, const uint8_t *body, int size, double now);
+    // Steps the match, queues every client's snapshot and unseats clients that timed out.
+    void tick(double now, Outbox &out);
+
+    bool seated(const NetAddress &from) const { return findSeat(from) >= 0; }
+    int clientCount() const;
+    int seatCount() const { return (int)seats_.size(); }
+    // Addresses unseated (timeout or Disconnect) since the last call.
+    void takeDeparted(std::vector<NetAddress> &out);
+
+    const MatchState &match() const { return match_; }
+    const MapData &map() const { return *map_; }
+    uint32_t currentTick() const { return tick_; }
+    const NetServerStats &stats() const { return stats_; }
+    // The snapshot sent for tick, if still in the history ring.
+    const Snapshot *history(uint32_t tick) const;
+
+private:
+    static constexpr int kInputBuffer = 64;     // per-client input ring, by sequence
+
+    struct Seat {
+        bool connected = false;
+        NetAddress address;
+        double lastHeard = 0.0;
+        uint32_t ackedTick = 0;
+        uint32_t nextSeq = 0;           // next input sequence to apply; 0 until the first input arrives
+        uint32_t newestSeq = 0;
+        uint32_t appliedSeq = 0;
+        PlayerInput last;
+        PlayerInput inputs[kInputBuffer];
+        uint32_t inputSeq[kInputBuffer];
+    };
+
+    int findSeat(const NetAddress &from) const;
+    void unseat(Seat &seat);
+    void handleInput(Seat &seat, const uint8_t *data, int size, double now);
+    PlayerInput takeInput(Seat &seat);
+    void queueSnapshot(Seat &seat, const Snapshot &snap, Outbox &out);
+
+    const MapData *map_ = nullptr;
+    std::string mapName_;
+    MatchState match_;
+    uint32_t tick_ = 0;
+    int historyDepth_;
+    std::vector<Seat> seats_;
+    std::vector<NetAddress> departed_;
+    std::unique_ptr<Snapshot[]> history_;
+    NetServerStats stats_;
+};
@@ -0,0 +1,46 @@
+#include "net/net_server.h"
+
+#include "net/protocol.h"
+
+bool NetServer::open(uint16_t port, bool loopbackOnly) {
+    return socket_.open(port, loopbackOnly);
+}
+
+bool NetServer::startMatch(const std::string &mapName, int playerCount, const int characterIndices[]) {
+    if (!map_.open(mapFilePath(mapName))) return false;
+    match_.start(map_.data(), map_.name(), playerCount, characterIndices);
+    return true;
+}
+
+void NetServer::flush(double now) {
+    socket_.pump(now);
+    for (size_t i = 0; i < outbox_.count(); ++i) {
+        const OutPacket &p = outbox_.packet(i);
+        socket_.send(p.to, outbox_.data(p), p.size);
+    }
+    outbox_.clear();
+    socket_.pump(now);
+}
+
+void NetServer::receive(double now) {
+    uint8_t packet[kMaxPacketBytes];
+    NetAddress from;
+    int size;
+    while ((size = socket_.receive(from, packet, sizeof(packet))) >= 0) {
+        uint8_t type = readPacketHeader(packet, size);
+        if (type == kPacketConnect) {
+            if (!match_.join(from, now, outbox_)) {
+                uint8_t reject[kPacketHeaderBytes];
+                outbox_.push(from, reject, (size_t)writePacketHeader(reject, kPacketReject));
+            }
+        } else if (type != 0) {
+            match_.handlePacket(from, type, packet + kPacketHeaderBytes, size - kPacketHeaderBytes, now);
+        }
+    }
+    flush(now);
+}
+
+void NetServer::tick(double now) {
+    match_.tick(now, outbox_);
+    flush(now);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "game/maps.h"
+#include "net/net_match.h"
+#include "net/outbox.h"
+#include "net/udp_socket.h"
+
+// A single NetMatch on its own socket. The caller drives time: receive() as often as it
+// likes, tick() at kFixedDt. Used by the loopback harness (epiCBattle_netsim); the
+// dedicated server shards many matches per thread instead (net/match_shard.h).
+class NetServer {
+public:
+    bool open(uint16_t port, bool loopbackOnly = false);
+    UdpSocket &socket() { return socket_; }
+
+    // Opens maps/<mapName>.ebmap (or a .ebmap path); false if it cannot be loaded.
+    bool startMatch(const std::string &mapName, int playerCount, const int characterIndices[]);
+
+    // Drains the socket: connects, inputs and disconnects. now is in seconds.
+    void receive(double now);
+    // Steps the match and sends everyone a snapshot.
+    void tick(double now);
+
+    const MatchState &match() const { return match_.match(); }
+    const MapData &map() const { return map_.data(); }
+    uint32_t currentTick() const { return match_.currentTick(); }
+    int clientCount() const { return match_.clientCount(); }
+    const NetServerStats &stats() const { return match_.stats(); }
+    const Snapshot *history(uint32_t tick) const { return match_.history(tick); }
+
+private:
+    void flush(double now);
+
+    UdpSocket socket_;
+    GameMap map_;
+    NetMatch match_;
+    Outbox outbox_;
+};
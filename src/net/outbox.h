@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "net/udp_socket.h"
+
+// Datagrams queued during a tick and sent together afterwards, so a server can hand a
+// whole batch to the kernel at once (UdpSocket::sendBatch). Storage is reused between
+// flushes; after warm-up pushing does not allocate.
+struct OutPacket {
+    NetAddress to;
+    uint32_t offset;
+    uint32_t size;
+};
+
+class Outbox {
+public:
+    void push(const NetAddress &to, const void *data, size_t size) {
+        size_t offset = bytes_.size();
+        bytes_.resize(offset + size);
+        std::memcpy(&bytes_[offset], data, size);
+        packets_.push_back({to, (uint32_t)offset, (uint32_t)size});
+    }
+    void clear() {
+        bytes_.clear();
+        packets_.clear();
+    }
+
+    bool empty() const { return packets_.empty(); }
+    size_t count() const { return packets_.size(); }
+    const OutPacket &packet(size_t i) const { return packets_[i]; }
+    const uint8_t *data(const OutPacket &p) const { return &bytes_[p.offset]; }
+
+private:
+    std::vector<uint8_t> bytes_;
+    std::vector<OutPacket> packets_;
+};
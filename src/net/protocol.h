@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+// Packet layout shared by NetServer and NetClient. Every packet starts with the protocol
+// magic and a PacketType byte; the rest is type specific.
+//
+//   Connect     client -> server  (resent until accepted)
+//   Accept      server -> client  u16 player index, u8 length + map name (file stem)
+//   Reject      server -> client  server full
+//   Input       client -> server  u32 acked snapshot tick, u32 newest input sequence,
+//                                 u8 count, count LEB128 packInput codes (newest first)
+//   Snapshot    server -> client  u32 newest input sequence applied, bit-packed snapshot
+//   Disconnect  either way
+
+constexpr uint32_t kProtocolMagic = 0x4E424245;     // "EBBN"
+constexpr uint16_t kDefaultServerPort = 27015;
+constexpr int kMaxPacketBytes = 8192;               // a full 256-player snapshot fits; loopback/LAN only beyond ~1200
+constexpr int kInputRedundancy = 8;                 // each input packet repeats the last N inputs
+constexpr double kConnectionTimeoutSeconds = 5.0;
+constexpr int kMaxMapNameBytes = 64;               // longer map names are cut in Accept
+
+enum PacketType : uint8_t {
+    kPacketConnect = 1,
+    kPacketAccept = 2,
+    kPacketReject = 3,
+    kPacketInput = 4,
+    kPacketSnapshot = 5,
+    kPacketDisconnect = 6,
+};
+
+constexpr int kPacketHeaderBytes = 5;   // magic + type
+
+static inline void writeU32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+static inline uint32_t readU32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline int writePacketHeader(uint8_t *p, PacketType type) {
+    writeU32(p, kProtocolMagic);
+    p[4] = type;
+    return kPacketHeaderBytes;
+}
+
+// Returns the packet type, or 0 when the datagram is not ours.
+static inline uint8_t readPacketHeader(const uint8_t *p, int size) {
+    if (size < kPacketHeaderBytes || readU32(p) != kProtocolMagic) return 0;
+    return p[4];
+}
@@ -0,0 +1,171 @@
+#include "net/snapshot.h"
+
+#include <cmath>
+#include <cstring>
+#include "game/characters.h"
+
+static const NetPlayer kZeroPlayer = {};
+
+static int32_t quantizePosition(float v) { return (int32_t)lrintf(v * (float)kPositionScale); }
+
+static uint16_t quantizeYaw(float radians) {
+    const float turn = 6.2831853f;
+    float t = radians / turn;
+    t -= floorf(t);
+    return (uint16_t)((int)lrintf(t * (float)(1 << kYawBits)) & ((1 << kYawBits) - 1));
+}
+
+void captureSnapshot(const MatchState &match, uint32_t tick, Snapshot &out) {
+    const ServerState &s = match.server;
+    out.tick = tick;
+    out.playerCount = s.playerCount;
+    out.roundActive = match.roundActive;
+    out.matchOver = match.matchOver;
+    out.lastScorer = match.lastScorer;
+    for (int i = 0; i < s.playerCount; ++i) {
+        NetPlayer &p = out.players[i];
+        p.x = quantizePosition(s.posX[i]);
+        p.y = quantizePosition(s.posY[i]);
+        p.z = quantizePosition(s.posZ[i]);
+        p.yaw = quantizeYaw(s.yawRadians[i]);
+        int health = s.health[i] < 0 ? 0 : (s.health[i] > 127 ? 127 : s.health[i]);
+        p.health = (uint8_t)health;
+        p.attacking = s.attacking(i) ? 1 : 0;
+        p.characterIndex = (uint8_t)s.characterIndex[i];
+        int score = match.playerScore[i];
+        out.scores[i] = (uint8_t)(score < 0 ? 0 : (score > 63 ? 63 : score));
+    }
+}
+
+void applySnapshot(const Snapshot &snap, MatchState &match) {
+    ServerState &s = match.server;
+    s.playerCount = snap.playerCount;
+    match.roundActive = snap.roundActive;
+    match.matchOver = snap.matchOver;
+    match.lastScorer = snap.lastScorer;
+    const float inv = 1.0f / (float)kPositionScale;
+    for (int i = 0; i < snap.playerCount; ++i) {
+        const NetPlayer &p = snap.players[i];
+        s.setPosition(i, {p.x * inv, p.y * inv, p.z * inv});
+        s.yawRadians[i] = (float)p.yaw * (6.2831853f / (float)(1 << kYawBits));
+        s.health[i] = p.health;
+        // Only "is attacking" is sent; any positive timer draws the attack pose
+        s.attackTimer[i] = p.attacking ? kFixedDt : 0.0f;
+        s.characterIndex[i] = p.characterIndex;
+        match.playerScore[i] = snap.scores[i];
+    }
+}
+
+static const NetPlayer &baselinePlayer(const Snapshot *baseline, int i) {
+    return (baseline && i < baseline->playerCount) ? baseline->players[i] : kZeroPlayer;
+}
+
+static void writePosition(BitWriter &out, int32_t value, int32_t base) {
+    int32_t delta = value - base;
+    out.writeBool(delta != 0);
+    if (delta == 0) return;
+    const int32_t limit = 1 << (kPositionDeltaBits - 1);
+    bool small = delta >= -limit && delta < limit;
+    out.writeBool(small);
+    if (small) out.writeSigned(delta, kPositionDeltaBits);
+    else out.writeSigned(value, kPositionBits);
+}
+
+static int32_t readPosition(BitReader &in, int32_t base) {
+    if (!in.readBool()) return base;
+    if (in.readBool()) return base + in.readSigned(kPositionDeltaBits);
+    return in.readSigned(kPositionBits);
+}
+
+void encodeSnapshot(const Snapshot &snap, const Snapshot *baseline, BitWriter &out) {
+    out.write(snap.tick, 32);
+    // Baseline as a tick offset: 0 means none
+    out.write(baseline ? snap.tick - baseline->tick : 0, 6);
+    out.write((uint32_t)snap.playerCount, 9);
+    out.writeBool(snap.roundActive);
+    out.writeBool(snap.matchOver);
+    out.write((uint32_t)(snap.lastScorer + 1), 9);
+
+    bool scoresChanged = !baseline || baseline->playerCount != snap.playerCount ||
+                         std::memcmp(baseline->scores, snap.scores, (size_t)snap.playerCount) != 0;
+    out.writeBool(scoresChanged);
+    if (scoresChanged) {
+        for (int i = 0; i < snap.playerCount; ++i) out.write(snap.scores[i], kScoreBits);
+    }
+
+    for (int i = 0; i < snap.playerCount; ++i) {
+        const NetPlayer &p = snap.players[i];
+        const NetPlayer &b = baselinePlayer(baseline, i);
+        bool changed = p.x != b.x || p.y != b.y || p.z != b.z || p.yaw != b.yaw || p.health != b.health ||
+                       p.attacking != b.attacking || p.characterIndex != b.characterIndex;
+        out.writeBool(changed);
+        if (!changed) continue;
+        writePosition(out, p.x, b.x);
+        writePosition(out, p.y, b.y);
+        writePosition(out, p.z, b.z);
+        out.writeBool(p.yaw != b.yaw);
+        if (p.yaw != b.yaw) out.write(p.yaw, kYawBits);
+        out.writeBool(p.health != b.health);
+        if (p.health != b.health) out.write(p.health, kHealthBits);
+        out.writeBool(p.attacking != 0);
+        out.writeBool(p.characterIndex != b.characterIndex);
+        if (p.characterIndex != b.characterIndex) out.write(p.characterIndex, 8);
+    }
+}
+
+uint32_t peekSnapshotBaseline(BitReader reader) {
+    uint32_t tick = reader.read(32);
+    uint32_t offset = reader.read(6);
+    if (reader.failed() || offset == 0) return 0;
+    return tick - offset;
+}
+
+bool decodeSnapshot(BitReader &in, const Snapshot *baseline, Snapshot &out) {
+    out.tick = in.read(32);
+    uint32_t offset = in.read(6);
+    if ((offset != 0) != (baseline != nullptr)) return false;
+    if (baseline && baseline->tick != out.tick - offset) return false;
+    out.playerCount = (int)in.read(9);
+    if (out.playerCount > kMaxPlayers) return false;
+    out.roundActive = in.readBool();
+    out.matchOver = in.readBool();
+    out.lastScorer = (int)in.read(9) - 1;
+    if (out.lastScorer >= out.playerCount) return false;
+
+    if (in.readBool()) {
+        for (int i = 0; i < out.playerCount; ++i) out.scores[i] = (uint8_t)in.read(kScoreBits);
+    } else {
+        if (!baseline) return false;
+        std::memcpy(out.scores, baseline->scores, (size_t)out.playerCount);
+    }
+
+    for (int i = 0; i < out.playerCount; ++i) {
+        const NetPlayer &b = baselinePlayer(baseline, i);
+        NetPlayer &p = out.players[i];
+        if (!in.readBool()) {
+            p = b;
+            continue;
+        }
+        p.x = readPosition(in, b.x);
+        p.y = readPosition(in, b.y);
+        p.z = readPosition(in, b.z);
+        p.yaw = in.readBool() ? (uint16_t)in.read(kYawBits) : b.yaw;
+        p.health = in.readBool() ? (uint8_t)in.read(kHealthBits) : b.health;
+        p.attacking = in.readBool() ? 1 : 0;
+        p.characterIndex = in.readBool() ? (uint8_t)in.read(8) : b.characterIndex;
+        if (p.characterIndex >= kCharacterCount) return false;
+    }
+    return !in.failed();
+}
+
+bool snapshotsEqual(const Snapshot &a, const Snapshot &b) {
+    if (a.tick != b.tick || a.playerCount != b.playerCount || a.roundActive != b.roundActive ||
+        a.matchOver != b.matchOver || a.lastScorer != b.lastScorer) return false;
+    for (int i = 0; i < a.playerCount; ++i) {
+        const NetPlayer &p = a.players[i];
+        const NetPlayer &q = b.players[i];
+        if (p.x != q.x || p.y != q.y || p.z != q.z || p.yaw != q.yaw || p.health != q.health ||
+            p.attacking != q.attacking || p.characterIndex != q.characterIndex || a.scores[i] != b.scores[i]) return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include "net/bitstream.h"
+#include "sim/sim.h"
+
+// What the server tells clients each tick: the visible part of MatchState, quantized.
+// Positions are fixed point (1/256 m), yaw is 12 bits, health 7 bits. Snapshots are
+// encoded as a delta against a baseline the client has acknowledged: unchanged players
+// cost one bit, small moves a few bits per axis. With no baseline the delta is taken
+// against an all-zero snapshot, which makes a full snapshot the same code path.
+
+constexpr int kPositionScale = 256;
+constexpr int kPositionBits = 20;           // +-2048 m
+constexpr int kPositionDeltaBits = 10;      // +-2 m between snapshot and baseline
+constexpr int kYawBits = 12;
+constexpr int kHealthBits = 7;
+constexpr int kScoreBits = 6;
+constexpr int kSnapshotHistory = 64;        // baselines older than this are not delta-coded
+
+struct NetPlayer {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    uint16_t yaw;
+    uint8_t health;
+    uint8_t attacking;
+    uint8_t characterIndex;
+};
+
+struct Snapshot {
+    uint32_t tick;                  // server tick, starting at 1; 0 = empty slot
+    int playerCount;
+    bool roundActive;
+    bool matchOver;
+    int lastScorer;
+    NetPlayer players[kMaxPlayers];
+    uint8_t scores[kMaxPlayers];
+};
+
+void captureSnapshot(const MatchState &match, uint32_t tick, Snapshot &out);
+
+// Writes out the dequantized state for rendering. Velocity and cooldowns are not sent.
+void applySnapshot(const Snapshot &snap, MatchState &match);
+
+// baseline may be null (full snapshot). Its tick must be within kSnapshotHistory of snap.
+void encodeSnapshot(const Snapshot &snap, const Snapshot *baseline, BitWriter &out);
+
+// Returns the baseline tick the packet was encoded against (0 for a full snapshot) without
+// consuming anything from a copy of the reader, so callers can look the baseline up first.
+uint32_t peekSnapshotBaseline(BitReader reader);
+
+// False for a malformed packet, or one whose values the client could not index with: a
+// player count over kMaxPlayers, a character index at or over kCharacterCount, or a last
+// scorer that is not -1 or one of the players.
+bool decodeSnapshot(BitReader &in, const Snapshot *baseline, Snapshot &out);
+
+bool snapshotsEqual(const Snapshot &a, const Snapshot &b);
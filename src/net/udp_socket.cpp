@@ -0,0 +1,226 @@
+#include "net/udp_socket.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include "net/link_conditioner.h"
+#include "net/outbox.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+static bool ensureWinsock() {
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+#endif
+
+bool parseNetAddress(const std::string &text, uint16_t defaultPort, NetAddress &out) {
+    std::string host = text;
+    uint16_t port = defaultPort;
+    size_t colon = text.rfind(':');
+    if (colon != std::string::npos) {
+        host = text.substr(0, colon);
+        int p = std::atoi(text.c_str() + colon + 1);
+        if (p <= 0 || p > 65535) return false;
+        port = (uint16_t)p;
+    }
+    if (host == "localhost") host = "127.0.0.1";
+    unsigned a, b, c, d;
+    char tail;
+    if (std::sscanf(host.c_str(), "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) != 4 || a > 255 || b > 255 || c > 255 || d > 255) return false;
+    out.ip = (a << 24) | (b << 16) | (c << 8) | d;
+    out.port = port;
+    return true;
+}
+
+std::string formatNetAddress(const NetAddress &addr) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%u.%u.%u.%u:%u", addr.ip >> 24, (addr.ip >> 16) & 255, (addr.ip >> 8) & 255, addr.ip & 255, addr.port);
+    return text;
+}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(uint16_t port, bool loopbackOnly, bool shared) {
+    close();
+#ifdef _WIN32
+    if (!ensureWinsock()) return false;
+#endif
+    Handle h = (Handle)::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (h == kInvalid) return false;
+    bool ok = true;
+    if (shared) {
+#if defined(SO_REUSEPORT)
+        int on = 1;
+        ok = setsockopt(h, SOL_SOCKET, SO_REUSEPORT, (const char *)&on, sizeof(on)) == 0;
+#else
+        ok = false;
+#endif
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+    ok = ok && ::bind(h, (const sockaddr *)&addr, sizeof(addr)) == 0;
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ok = ok && ioctlsocket(h, FIONBIO, &nonBlocking) == 0;
+#else
+    ok = ok && fcntl(h, F_SETFL, fcntl(h, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    socklen_t len = sizeof(addr);
+    ok = ok && getsockname(h, (sockaddr *)&addr, &len) == 0;
+    if (!ok) {
+#ifdef _WIN32
+        closesocket(h);
+#else
+        ::close(h);
+#endif
+        return false;
+    }
+    handle_ = h;
+    localPort_ = ntohs(addr.sin_port);
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle_ == kInvalid) return;
+#ifdef _WIN32
+    closesocket(handle_);
+#else
+    ::close(handle_);
+#endif
+    handle_ = kInvalid;
+}
+
+static void toSockaddr(const NetAddress &a, sockaddr_in &out) {
+    out = sockaddr_in{};
+    out.sin_family = AF_INET;
+    out.sin_port = htons(a.port);
+    out.sin_addr.s_addr = htonl(a.ip);
+}
+
+bool UdpSocket::sendRaw(const NetAddress &to, const void *data, size_t size) {
+    sockaddr_in addr;
+    toSockaddr(to, addr);
+    return ::sendto(handle_, (const char *)data, (int)size, 0, (const sockaddr *)&addr, sizeof(addr)) == (int)size;
+}
+
+bool UdpSocket::send(const NetAddress &to, const void *data, size_t size) {
+    if (handle_ == kInvalid) return false;
+    bytesSent_ += size;
+    packetsSent_++;
+    if (conditioner_) {
+        conditioner_->enqueue(to, data, size, now_);
+        return true;
+    }
+    return sendRaw(to, data, size);
+}
+
+int UdpSocket::receive(NetAddress &from, void *buffer, size_t capacity) {
+    if (handle_ == kInvalid) return -1;
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    int n = (int)::recvfrom(handle_, (char *)buffer, (int)capacity, 0, (sockaddr *)&addr, &len);
+    if (n < 0) return -1;
+    from.ip = ntohl(addr.sin_addr.s_addr);
+    from.port = ntohs(addr.sin_port);
+    return n;
+}
+
+int UdpSocket::receiveBatch(RecvBatch &batch) {
+    batch.count = 0;
+    if (handle_ == kInvalid) return 0;
+#ifdef __linux__
+    sockaddr_in addrs[RecvBatch::kMaxPackets];
+    iovec iov[RecvBatch::kMaxPackets];
+    mmsghdr msgs[RecvBatch::kMaxPackets];
+    for (int i = 0; i < RecvBatch::kMaxPackets; ++i) {
+        iov[i] = {batch.data[i], RecvBatch::kMaxBytes};
+        msgs[i] = mmsghdr{};
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int n = recvmmsg(handle_, msgs, RecvBatch::kMaxPackets, MSG_DONTWAIT, nullptr);
+    if (n <= 0) return 0;
+    for (int i = 0; i < n; ++i) {
+        batch.from[i].ip = ntohl(addrs[i].sin_addr.s_addr);
+        batch.from[i].port = ntohs(addrs[i].sin_port);
+        // Truncated datagrams are reported as too long so the protocol check rejects them
+        batch.size[i] = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1 : (int)msgs[i].msg_len;
+    }
+    batch.count = n;
+#else
+    while (batch.count < RecvBatch::kMaxPackets) {
+        int n = receive(batch.from[batch.count], batch.data[batch.count], RecvBatch::kMaxBytes);
+        if (n < 0) break;
+        batch.size[batch.count++] = n;
+    }
+#endif
+    return batch.count;
+}
+
+void UdpSocket::sendBatch(const Outbox &out) {
+    if (handle_ == kInvalid || out.empty()) return;
+#ifdef __linux__
+    if (!conditioner_) {
+        constexpr int kChunk = 64;
+        sockaddr_in addrs[kChunk];
+        iovec iov[kChunk];
+        mmsghdr msgs[kChunk];
+        for (size_t base = 0; base < out.count(); base += kChunk) {
+            int n = (int)(out.count() - base < (size_t)kChunk ? out.count() - base : (size_t)kChunk);
+            for (int i = 0; i < n; ++i) {
+                const OutPacket &p = out.packet(base + i);
+                toSockaddr(p.to, addrs[i]);
+                iov[i] = {(void *)out.data(p), p.size};
+                msgs[i] = mmsghdr{};
+                msgs[i].msg_hdr.msg_name = &addrs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                bytesSent_ += p.size;
+            }
+            // A full send buffer drops the rest of the chunk, as a single sendto would; any
+            // other error is one bad datagram, so skip it and carry on
+            int sent = 0;
+            while (sent < n) {
+                int r = sendmmsg(handle_, msgs + sent, (unsigned)(n - sent), 0);
+                if (r > 0) sent += r;
+                else if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                else sent++;
+            }
+            packetsSent_ += (uint64_t)n;
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < out.count(); ++i) {
+        const OutPacket &p = out.packet(i);
+        send(p.to, out.data(p), p.size);
+    }
+}
+
+void UdpSocket::pump(double now) {
+    now_ = now;
+    if (!conditioner_) return;
+    conditioner_->release(now, [&](const NetAddress &to, const uint8_t *data, size_t size) { sendRaw(to, data, size); });
+}
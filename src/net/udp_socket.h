@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class LinkConditioner;
+class Outbox;
+
+// IPv4 address in host byte order.
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    bool operator==(const NetAddress &o) const { return ip == o.ip && port == o.port; }
+    bool operator!=(const NetAddress &o) const { return !(*this == o); }
+};
+
+// "host:port" or "host" (default port); host is a dotted quad or "localhost".
+bool parseNetAddress(const std::string &text, uint16_t defaultPort, NetAddress &out);
+std::string formatNetAddress(const NetAddress &addr);
+
+// Datagrams pulled off a socket in one go (UdpSocket::receiveBatch). Sized for client to
+// server traffic; longer datagrams are truncated and should be dropped by the caller.
+struct RecvBatch {
+    static constexpr int kMaxPackets = 64;
+    static constexpr int kMaxBytes = 512;
+    int count = 0;
+    NetAddress from[kMaxPackets];
+    int size[kMaxPackets];
+    uint8_t data[kMaxPackets][kMaxBytes];
+};
+
+// Non-blocking UDP socket. An attached LinkConditioner delays or drops outgoing datagrams
+// (test harness only); pump() then releases the ones that are due.
+class UdpSocket {
+public:
+#ifdef _WIN32
+    using Handle = uintptr_t;
+    static constexpr Handle kInvalid = ~(uintptr_t)0;
+#else
+    using Handle = int;
+    static constexpr Handle kInvalid = -1;
+#endif
+
+    UdpSocket() = default;
+    ~UdpSocket();
+    UdpSocket(const UdpSocket &) = delete;
+    UdpSocket &operator=(const UdpSocket &) = delete;
+
+    // port 0 picks an ephemeral port. Binds to all interfaces, or loopback only if requested.
+    // shared: SO_REUSEPORT, so several sockets (one per worker) bind the same port and the
+    // kernel spreads clients across them by address; where unsupported, open fails.
+    bool open(uint16_t port, bool loopbackOnly = false, bool shared = false);
+    void close();
+    bool isOpen() const { return handle_ != kInvalid; }
+    uint16_t localPort() const { return localPort_; }
+    Handle handle() const { return handle_; }
+
+    bool send(const NetAddress &to, const void *data, size_t size);
+    // Bytes received, or -1 when nothing is pending.
+    int receive(NetAddress &from, void *buffer, size_t capacity);
+
+    // Batched versions: one recvmmsg/sendmmsg per 64 datagrams on Linux, a loop elsewhere
+    // (and whenever a conditioner is attached). receiveBatch returns batch.count.
+    int receiveBatch(RecvBatch &batch);
+    void sendBatch(const Outbox &out);
+
+    void setConditioner(LinkConditioner *conditioner) { conditioner_ = conditioner; }
+    void pump(double now);
+
+    uint64_t bytesSent() const { return bytesSent_; }
+    uint64_t packetsSent() const { return packetsSent_; }
+
+private:
+    bool sendRaw(const NetAddress &to, const void *data, size_t size);
+
+    Handle handle_ = kInvalid;
+    uint16_t localPort_ = 0;
+    LinkConditioner *conditioner_ = nullptr;
+    double now_ = 0.0;
+    uint64_t bytesSent_ = 0;
+    uint64_t packetsSent_ = 0;
+};
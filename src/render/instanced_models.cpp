@@ -0,0 +1,68 @@
+#include "render/instanced_models.h"
+
+#include "rlgl.h"
+
+// vertexPosition is either float model space (offset 0, scale 1) or the cache's 16-bit grid
+// over the mesh bounds; texcoords arrive as float or half float and read the same
+static const char *kInstancingVs = R"(#version 330
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec4 vertexColor;
+in mat4 instanceTransform;
+uniform mat4 mvp;
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+out vec2 fragTexCoord;
+out vec4 fragColor;
+void main() {
+    fragTexCoord = vertexTexCoord;
+    fragColor = vertexColor;
+    gl_Position = mvp * instanceTransform * vec4(positionOffset + vertexPosition * positionScale, 1.0);
+}
+)";
+
+// Same output as raylib's default shader, so instanced and DrawModelEx draws look identical
+static const char *kInstancingFs = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+void main() {
+    finalColor = texture(texture0, fragTexCoord) * colDiffuse * fragColor;
+}
+)";
+
+Shader loadInstancingShader() {
+    Shader shader = LoadShaderFromMemory(kInstancingVs, kInstancingFs);
+    // raylib hands back its default shader when compilation fails
+    if (!IsShaderReady(shader) || shader.id == rlGetShaderIdDefault()) return Shader{};
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(shader, "instanceTransform");
+    return shader;
+}
+
+void drawModelInstanced(const Model &model, Shader shader, const Matrix *transforms, int count, Color tint,
+                        RenderStats &stats, const MeshDequantization *dequantization) {
+    if (count <= 0) return;
+    const int offsetLoc = GetShaderLocation(shader, "positionOffset");
+    const int scaleLoc = GetShaderLocation(shader, "positionScale");
+    for (int i = 0; i < model.meshCount; ++i) {
+        const MeshDequantization identity = {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+        const MeshDequantization &dq = dequantization ? dequantization[i] : identity;
+        SetShaderValue(shader, offsetLoc, &dq.positionOffset, SHADER_UNIFORM_VEC3);
+        SetShaderValue(shader, scaleLoc, &dq.positionScale, SHADER_UNIFORM_VEC3);
+        int materialIndex = model.meshMaterial ? model.meshMaterial[i] : 0;
+        Material material = model.materials[materialIndex];
+        material.shader = shader;
+        // Tinted like DrawModelEx; maps is shared with the model, so restore it after the draw
+        Color saved = material.maps[MATERIAL_MAP_DIFFUSE].color;
+        material.maps[MATERIAL_MAP_DIFFUSE].color = {
+            (unsigned char)(saved.r * tint.r / 255), (unsigned char)(saved.g * tint.g / 255),
+            (unsigned char)(saved.b * tint.b / 255), (unsigned char)(saved.a * tint.a / 255)};
+        DrawMeshInstanced(model.meshes[i], material, transforms, count);
+        material.maps[MATERIAL_MAP_DIFFUSE].color = saved;
+        stats.drawCalls++;
+        stats.triangles += (long long)model.meshes[i].triangleCount * count;
+    }
+    stats.instances += count;
+}
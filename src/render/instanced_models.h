@@ -0,0 +1,19 @@
+#pragma once
+
+#include "raylib.h"
+#include "assets/model_loader.h"
+#include "render/render_stats.h"
+
+// GPU instancing for characters: every fighter using the same model is drawn with one
+// DrawMeshInstanced per mesh, so draw calls grow with the number of distinct characters
+// rather than the number of players.
+
+// Unlit textured shader reading a per-instance model matrix. It also draws the model cache's
+// quantized vertex formats (16-bit positions, half-float texcoords). Returns a shader with id 0
+// when the driver rejects it; callers then fall back to DrawModelEx on float meshes.
+Shader loadInstancingShader();
+
+// transforms already include model.transform. tint is applied to all instances.
+// dequantization has one entry per mesh for quantized models and is null for float ones.
+void drawModelInstanced(const Model &model, Shader shader, const Matrix *transforms, int count, Color tint,
+                        RenderStats &stats, const MeshDequantization *dequantization = nullptr);
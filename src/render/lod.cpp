@@ -0,0 +1,53 @@
+#include "render/lod.h"
+
+#include <cmath>
+#include "raymath.h"
+#include "rlgl.h"
+#include "assets/model_cache.h"
+
+// A fighter drops to LOD l + 1 when it covers less than kLodThresholds[l] of the screen
+// height, and comes back once it is kLodHysteresis larger than that again
+static const float kLodThresholds[kMaxModelLods - 1] = {0.25f, 0.12f, 0.05f};
+static const float kLodHysteresis = 0.15f;
+
+Frustum currentFrustum() {
+    // Gribb-Hartmann: each plane is the last row of the clip matrix plus or minus another row
+    Matrix m = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    const Vector4 row0 = {m.m0, m.m4, m.m8, m.m12};
+    const Vector4 row1 = {m.m1, m.m5, m.m9, m.m13};
+    const Vector4 row2 = {m.m2, m.m6, m.m10, m.m14};
+    const Vector4 row3 = {m.m3, m.m7, m.m11, m.m15};
+    auto plane = [](Vector4 a, Vector4 b, float sign) {
+        Vector4 p = {a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z, a.w + sign * b.w};
+        float len = sqrtf(p.x * p.x + p.y * p.y + p.z * p.z);
+        return len > 0.0f ? Vector4{p.x / len, p.y / len, p.z / len, p.w / len} : p;
+    };
+    Frustum f;
+    f.planes[0] = plane(row3, row0, 1.0f);     // left
+    f.planes[1] = plane(row3, row0, -1.0f);    // right
+    f.planes[2] = plane(row3, row1, 1.0f);     // bottom
+    f.planes[3] = plane(row3, row1, -1.0f);    // top
+    f.planes[4] = plane(row3, row2, 1.0f);     // near
+    f.planes[5] = plane(row3, row2, -1.0f);    // far
+    return f;
+}
+
+bool sphereInFrustum(const Frustum &frustum, Vector3 center, float radius) {
+    for (const Vector4 &p : frustum.planes) {
+        if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius) return false;
+    }
+    return true;
+}
+
+float projectedSize(const Camera3D &camera, Vector3 center, float radius) {
+    float distance = Vector3Distance(camera.position, center);
+    if (distance <= radius) return 1.0f;
+    return radius / (distance * tanf(camera.fovy * 0.5f * DEG2RAD));
+}
+
+int selectLod(float projectedSize, int previousLod, int lodCount) {
+    int lod = previousLod < 0 ? 0 : (previousLod < lodCount ? previousLod : lodCount - 1);
+    while (lod + 1 < lodCount && projectedSize < kLodThresholds[lod]) lod++;
+    while (lod > 0 && projectedSize > kLodThresholds[lod - 1] * (1.0f + kLodHysteresis)) lod--;
+    return lod;
+}
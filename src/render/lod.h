@@ -0,0 +1,22 @@
+#pragma once
+
+#include "raylib.h"
+
+// Per-fighter view culling and detail selection for the Arena draw loop.
+
+// Planes of the current view frustum, normals pointing inward (xyz) with offset w.
+struct Frustum {
+    Vector4 planes[6];
+};
+
+// Frustum of rlgl's current modelview and projection; call between BeginMode3D and EndMode3D.
+Frustum currentFrustum();
+bool sphereInFrustum(const Frustum &frustum, Vector3 center, float radius);
+
+// Share of the viewport height a sphere's diameter covers (1 when the camera is inside it).
+float projectedSize(const Camera3D &camera, Vector3 center, float radius);
+
+// LOD for a projected size, given the level used last frame. A fighter only moves back to a
+// finer level once it is clearly past the threshold, so one hovering at a boundary does not
+// flicker between levels every frame.
+int selectLod(float projectedSize, int previousLod, int lodCount);
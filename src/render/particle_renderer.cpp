@@ -0,0 +1,100 @@
+#include "render/particle_renderer.h"
+
+#include "raymath.h"
+#include "rlgl.h"
+
+// The instance matrix is ParticleSystem::writeInstances's: translation, size in [0][0], and
+// (shade, alpha) in the bottom row, which GLSL indexes as [column][3]. The quad is
+// GenMeshPlane's, spanning x and z in [-0.5, 0.5].
+static const char *kParticleVs = R"(#version 330
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in mat4 instanceTransform;
+uniform mat4 mvp;
+uniform vec3 cameraRight;
+uniform vec3 cameraUp;
+out vec2 fragTexCoord;
+out vec4 fragColor;
+void main() {
+    vec3 center = instanceTransform[3].xyz;
+    float size = instanceTransform[0][0];
+    vec3 world = center + (cameraRight * vertexPosition.x - cameraUp * vertexPosition.z) * size;
+    fragTexCoord = vertexTexCoord;
+    fragColor = vec4(vec3(instanceTransform[0][3]), instanceTransform[1][3]);
+    gl_Position = mvp * vec4(world, 1.0);
+}
+)";
+
+// Round, soft-edged dot without a texture
+static const char *kParticleFs = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+void main() {
+    float edge = 1.0 - smoothstep(0.2, 0.5, length(fragTexCoord - vec2(0.5)));
+    if (edge <= 0.0) discard;
+    finalColor = vec4(colDiffuse.rgb * fragColor.rgb, colDiffuse.a * fragColor.a * edge);
+}
+)";
+
+struct EmitterLook {
+    Color color;
+    int blend;
+};
+
+// Indexed by ParticleEmitter
+static const EmitterLook kEmitterLooks[kParticleEmitterCount] = {
+    {{255, 200, 90, 255}, BLEND_ADDITIVE},      // Spark
+    {{170, 150, 120, 160}, BLEND_ALPHA},        // Dust
+    {{255, 90, 40, 255}, BLEND_ADDITIVE},       // Burst
+};
+
+bool loadParticleRenderer(ParticleRenderer &renderer) {
+    unloadParticleRenderer(renderer);
+    Shader shader = LoadShaderFromMemory(kParticleVs, kParticleFs);
+    // raylib hands back its default shader when compilation fails
+    if (!IsShaderReady(shader) || shader.id == rlGetShaderIdDefault()) return false;
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(shader, "instanceTransform");
+    renderer.shader = shader;
+    renderer.cameraRightLoc = GetShaderLocation(shader, "cameraRight");
+    renderer.cameraUpLoc = GetShaderLocation(shader, "cameraUp");
+    renderer.quad = GenMeshPlane(1.0f, 1.0f, 1, 1);
+    renderer.material = LoadMaterialDefault();
+    renderer.material.shader = shader;
+    renderer.instances.resize(kMaxParticlesPerEmitter);
+    renderer.loaded = true;
+    return true;
+}
+
+void drawParticles(ParticleRenderer &renderer, const ParticleSystem &particles, const Camera3D &camera, RenderStats &stats) {
+    if (!renderer.loaded || particles.liveCount() == 0) return;
+    const Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    const Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
+    const Vector3 up = Vector3CrossProduct(right, forward);
+    SetShaderValue(renderer.shader, renderer.cameraRightLoc, &right, SHADER_UNIFORM_VEC3);
+    SetShaderValue(renderer.shader, renderer.cameraUpLoc, &up, SHADER_UNIFORM_VEC3);
+
+    rlDisableDepthMask();
+    for (int e = 0; e < kParticleEmitterCount; ++e) {
+        // Matrix is sixteen floats, row by row, the way writeInstances fills them
+        const int count = particles.writeInstances((ParticleEmitter)e, &renderer.instances[0].m0);
+        if (count == 0) continue;
+        renderer.material.maps[MATERIAL_MAP_DIFFUSE].color = kEmitterLooks[e].color;
+        BeginBlendMode(kEmitterLooks[e].blend);
+        DrawMeshInstanced(renderer.quad, renderer.material, renderer.instances.data(), count);
+        EndBlendMode();
+        stats.drawCalls++;
+        stats.instances += count;
+        stats.triangles += (long long)renderer.quad.triangleCount * count;
+    }
+    rlEnableDepthMask();
+}
+
+void unloadParticleRenderer(ParticleRenderer &renderer) {
+    if (!renderer.loaded) return;
+    UnloadMesh(renderer.quad);
+    // Unloads the shader with it
+    UnloadMaterial(renderer.material);
+    renderer = ParticleRenderer{};
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include "raylib.h"
+#include "render/particles.h"
+#include "render/render_stats.h"
+
+// Draws a ParticleSystem as camera-facing soft quads: one DrawMeshInstanced per emitter,
+// sparks and bursts blended additively, dust over what is behind it. Particles test depth
+// but do not write it, so they never hide each other or the fighters drawn after them.
+struct ParticleRenderer {
+    Shader shader{};
+    Mesh quad{};
+    Material material{};
+    std::vector<Matrix> instances;
+    int cameraRightLoc = -1;
+    int cameraUpLoc = -1;
+    bool loaded = false;
+};
+
+// False when the driver rejects the shader; drawParticles then draws nothing.
+bool loadParticleRenderer(ParticleRenderer &renderer);
+// Call between BeginMode3D and EndMode3D, after the opaque geometry.
+void drawParticles(ParticleRenderer &renderer, const ParticleSystem &particles, const Camera3D &camera, RenderStats &stats);
+void unloadParticleRenderer(ParticleRenderer &renderer);
@@ -0,0 +1,168 @@
+#include "render/particles.h"
+
+#include <algorithm>
+#include <cmath>
+#include "core/simd.h"
+
+struct ParticleSystem::Pool {
+    int count = 0;
+    alignas(32) float posX[kMaxParticlesPerEmitter];
+    alignas(32) float posY[kMaxParticlesPerEmitter];
+    alignas(32) float posZ[kMaxParticlesPerEmitter];
+    alignas(32) float velX[kMaxParticlesPerEmitter];
+    alignas(32) float velY[kMaxParticlesPerEmitter];
+    alignas(32) float velZ[kMaxParticlesPerEmitter];
+    alignas(32) float life[kMaxParticlesPerEmitter];         // seconds left
+    alignas(32) float invLifetime[kMaxParticlesPerEmitter];  // 1 / seconds it started with
+    alignas(32) float size[kMaxParticlesPerEmitter];
+    alignas(32) float shade[kMaxParticlesPerEmitter];        // brightness against the emitter's color
+};
+
+struct EmitterDef {
+    float gravity;          // m/s^2
+    float drag;             // share of velocity kept per second
+    float speedMin, speedMax;
+    float vertical;         // scale on the vertical part of the launch direction
+    float upward;           // m/s added upward at launch
+    float lifeMin, lifeMax;
+    float sizeMin, sizeMax;
+    float growth;           // size change per second
+};
+
+// Indexed by ParticleEmitter
+static const EmitterDef kEmitters[kParticleEmitterCount] = {
+    {-18.0f, 0.15f, 3.0f, 7.0f, 1.0f, 2.0f, 0.25f, 0.5f, 0.04f, 0.08f, -0.08f},     // Spark
+    {-0.5f, 0.05f, 1.0f, 2.2f, 0.15f, 0.4f, 0.5f, 1.0f, 0.15f, 0.3f, 0.6f},         // Dust
+    {-6.0f, 0.3f, 4.0f, 9.0f, 1.0f, 3.0f, 0.6f, 1.2f, 0.08f, 0.16f, -0.05f},        // Burst
+};
+
+// Above the feet, where a hit or a knockout shows
+static const float kChestHeight = 1.2f;
+static const int kKnockoutParticles = 400;
+
+// xorshift32
+static float randomUnit(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (float)(state & 0xFFFFFF) / (float)0xFFFFFF;
+}
+
+static float randomRange(uint32_t &state, float lo, float hi) { return lo + (hi - lo) * randomUnit(state); }
+
+ParticleSystem::ParticleSystem() {
+    // Zeroed, so the padding lanes the SIMD update reads past count hold plain numbers
+    for (auto &pool : pools_) pool.reset(new Pool());
+}
+
+ParticleSystem::~ParticleSystem() = default;
+
+void ParticleSystem::clear() {
+    for (auto &pool : pools_) pool->count = 0;
+}
+
+int ParticleSystem::count(ParticleEmitter emitter) const { return pools_[(int)emitter]->count; }
+
+int ParticleSystem::liveCount() const {
+    int total = 0;
+    for (const auto &pool : pools_) total += pool->count;
+    return total;
+}
+
+void ParticleSystem::spawn(const SimEvent &event) {
+    const Vec3 chest = {event.position.x, event.position.y + kChestHeight, event.position.z};
+    switch (event.type) {
+        case SimEventType::Hit:
+            emit(ParticleEmitter::Spark, chest, std::min(12 + (int)(event.amount * 2.0f), 80));
+            break;
+        case SimEventType::Land:
+            emit(ParticleEmitter::Dust, event.position, std::min(std::max((int)(event.amount * 3.0f), 8), 48), event.amount / 10.0f);
+            break;
+        case SimEventType::Knockout:
+            emit(ParticleEmitter::Burst, chest, kKnockoutParticles);
+            emit(ParticleEmitter::Dust, event.position, 40);
+            break;
+    }
+}
+
+void ParticleSystem::emit(ParticleEmitter emitter, Vec3 origin, int count, float speedScale) {
+    Pool &p = *pools_[(int)emitter];
+    const EmitterDef &def = kEmitters[(int)emitter];
+    count = std::min(count, kMaxParticlesPerEmitter - p.count);
+    for (int k = 0; k < count; ++k) {
+        const int i = p.count++;
+        // Uniform on the sphere: height and angle around it
+        const float y = randomRange(rng_, -1.0f, 1.0f);
+        const float angle = randomRange(rng_, 0.0f, 6.2831853f);
+        const float ring = std::sqrt(1.0f - y * y);
+        const float speed = randomRange(rng_, def.speedMin, def.speedMax) * speedScale;
+        const float lifetime = randomRange(rng_, def.lifeMin, def.lifeMax);
+        p.posX[i] = origin.x;
+        p.posY[i] = origin.y;
+        p.posZ[i] = origin.z;
+        p.velX[i] = std::cos(angle) * ring * speed;
+        p.velY[i] = y * def.vertical * speed + def.upward;
+        p.velZ[i] = std::sin(angle) * ring * speed;
+        p.life[i] = lifetime;
+        p.invLifetime[i] = 1.0f / lifetime;
+        p.size[i] = randomRange(rng_, def.sizeMin, def.sizeMax);
+        p.shade[i] = randomRange(rng_, 0.7f, 1.0f);
+    }
+}
+
+void ParticleSystem::update(float dt) {
+    for (int e = 0; e < kParticleEmitterCount; ++e) {
+        Pool &p = *pools_[e];
+        const EmitterDef &def = kEmitters[e];
+        const F32x zero = simdSet(0.0f);
+        const F32x vdt = simdSet(dt);
+        const F32x gdt = simdSet(def.gravity * dt);
+        const F32x keep = simdSet(std::pow(def.drag, dt));
+        const F32x grow = simdSet(def.growth * dt);
+        const int n = simdRoundUp(p.count);
+        for (int i = 0; i < n; i += kSimdWidth) {
+            F32x vx = simdLoad(&p.velX[i]) * keep;
+            F32x vy = (simdLoad(&p.velY[i]) + gdt) * keep;
+            F32x vz = simdLoad(&p.velZ[i]) * keep;
+            simdStore(&p.posX[i], simdLoad(&p.posX[i]) + vx * vdt);
+            simdStore(&p.posY[i], simdLoad(&p.posY[i]) + vy * vdt);
+            simdStore(&p.posZ[i], simdLoad(&p.posZ[i]) + vz * vdt);
+            simdStore(&p.velX[i], vx);
+            simdStore(&p.velY[i], vy);
+            simdStore(&p.velZ[i], vz);
+            simdStore(&p.life[i], simdLoad(&p.life[i]) - vdt);
+            simdStore(&p.size[i], simdMax(simdLoad(&p.size[i]) + grow, zero));
+        }
+
+        // Fill each expired slot with the last live particle
+        for (int i = 0; i < p.count;) {
+            if (p.life[i] > 0.0f) {
+                ++i;
+                continue;
+            }
+            const int last = --p.count;
+            p.posX[i] = p.posX[last];
+            p.posY[i] = p.posY[last];
+            p.posZ[i] = p.posZ[last];
+            p.velX[i] = p.velX[last];
+            p.velY[i] = p.velY[last];
+            p.velZ[i] = p.velZ[last];
+            p.life[i] = p.life[last];
+            p.invLifetime[i] = p.invLifetime[last];
+            p.size[i] = p.size[last];
+            p.shade[i] = p.shade[last];
+        }
+    }
+}
+
+int ParticleSystem::writeInstances(ParticleEmitter emitter, float *out) const {
+    const Pool &p = *pools_[(int)emitter];
+    for (int i = 0; i < p.count; ++i, out += kParticleInstanceFloats) {
+        const float alpha = std::min(p.life[i] * p.invLifetime[i], 1.0f);
+        out[0] = p.size[i]; out[1] = 0.0f; out[2] = 0.0f; out[3] = p.posX[i];
+        out[4] = 0.0f; out[5] = 0.0f; out[6] = 0.0f; out[7] = p.posY[i];
+        out[8] = 0.0f; out[9] = 0.0f; out[10] = 0.0f; out[11] = p.posZ[i];
+        out[12] = p.shade[i]; out[13] = alpha; out[14] = 0.0f; out[15] = 1.0f;
+    }
+    return p.count;
+}
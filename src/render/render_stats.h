@@ -0,0 +1,39 @@
+#pragma once
+
+#include "assets/model_cache.h"
+
+// Per-frame draw counters plus a rolling frame-time window, shown by the F3 overlay.
+// Only mesh draws the client issues itself are counted; raylib's immediate-mode shapes and
+// text go through its internal batch.
+struct RenderStats {
+    int drawCalls = 0;
+    int instances = 0;
+    long long triangles = 0;
+    int culled = 0;                         // fighters outside the view frustum
+    int lodInstances[kMaxModelLods] = {};   // fighters drawn at each detail level
+
+    void reset() { *this = RenderStats{}; }
+};
+
+struct FrameTimes {
+    static constexpr int kWindow = 120;
+    float ms[kWindow] = {};
+    int count = 0;
+    int next = 0;
+
+    void push(float frameMs) {
+        ms[next] = frameMs;
+        next = (next + 1) % kWindow;
+        if (count < kWindow) count++;
+    }
+    float average() const {
+        float sum = 0.0f;
+        for (int i = 0; i < count; ++i) sum += ms[i];
+        return count > 0 ? sum / count : 0.0f;
+    }
+    float worst() const {
+        float w = 0.0f;
+        for (int i = 0; i < count; ++i) w = ms[i] > w ? ms[i] : w;
+        return w;
+    }
+};
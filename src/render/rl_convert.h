@@ -0,0 +1,9 @@
+#pragma once
+
+#include "raylib.h"
+#include "core/types.h"
+
+// Bridges the sim's plain value types to raylib's.
+static inline Vector3 toRl(Vec3 v) { return Vector3{v.x, v.y, v.z}; }
+static inline Color toRl(Rgba c) { return Color{c.r, c.g, c.b, c.a}; }
+static inline Vec3 fromRl(Vector3 v) { return Vec3{v.x, v.y, v.z}; }
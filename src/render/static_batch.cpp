@@ -0,0 +1,46 @@
+#include "render/static_batch.h"
+
+#include "raymath.h"
+#include "game/map_geometry.h"
+
+void uploadStaticBatch(StaticBatch &batch, const MapData &map) {
+    unloadStaticBatch(batch);
+    std::vector<StaticMeshChunk> chunks = buildStaticGeometry(map);
+    for (StaticMeshChunk &chunk : chunks) {
+        // Flat vertex colors on the default white texture; texcoords only keep the default
+        // shader's attribute defined
+        std::vector<float> texcoords((size_t)chunk.vertexCount() * 2, 0.0f);
+        Mesh mesh{};
+        mesh.vertexCount = chunk.vertexCount();
+        mesh.triangleCount = chunk.triangleCount();
+        mesh.vertices = chunk.positions.data();
+        mesh.texcoords = texcoords.data();
+        mesh.colors = chunk.colors.data();
+        mesh.indices = chunk.indices.data();
+        UploadMesh(&mesh, false);
+        // The arrays belong to the chunk, which goes away here; only the GPU copy is kept
+        mesh.vertices = nullptr;
+        mesh.texcoords = nullptr;
+        mesh.colors = nullptr;
+        mesh.indices = nullptr;
+        batch.meshes.push_back(mesh);
+    }
+    batch.material = LoadMaterialDefault();
+    batch.loaded = true;
+}
+
+void drawStaticBatch(const StaticBatch &batch, RenderStats &stats) {
+    for (const Mesh &mesh : batch.meshes) {
+        DrawMesh(mesh, batch.material, MatrixIdentity());
+        stats.drawCalls++;
+        stats.instances++;
+        stats.triangles += mesh.triangleCount;
+    }
+}
+
+void unloadStaticBatch(StaticBatch &batch) {
+    if (!batch.loaded) return;
+    for (const Mesh &mesh : batch.meshes) UnloadMesh(mesh);
+    UnloadMaterial(batch.material);
+    batch = StaticBatch{};
+}
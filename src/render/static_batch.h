@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+#include "raylib.h"
+#include "game/maps.h"
+#include "render/render_stats.h"
+
+// The map's static geometry (game/map_geometry.h) uploaded as GPU meshes, rebuilt whenever
+// a map is loaded and drawn with one call per chunk.
+struct StaticBatch {
+    std::vector<Mesh> meshes;
+    Material material{};
+    bool loaded = false;
+};
+
+// Replaces whatever the batch held with the geometry of map.
+void uploadStaticBatch(StaticBatch &batch, const MapData &map);
+void drawStaticBatch(const StaticBatch &batch, RenderStats &stats);
+void unloadStaticBatch(StaticBatch &batch);
@@ -0,0 +1,175 @@
+// epiCBattle_server: dedicated authoritative server hosting many matches over UDP.
+// Matches are sharded across worker threads, one per core by default, each pinned to its
+// core with its own socket on the shared port (see net/match_shard.h). Clients join with
+// `epiCBattle --connect host:port` and are paired into matches as they arrive.
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game/maps.h"
+#include "net/match_shard.h"
+#include "net/protocol.h"
+
+struct ServerConfig {
+    uint16_t port = kDefaultServerPort;
+    std::string map = "green";         // name in maps/ or a .ebmap path
+    int players = kDuelPlayers;     // seats per match
+    int workers = 0;                // 0 = hardware concurrency
+    int matchesPerWorker = 256;
+    bool pin = true;
+    double statsInterval = 5.0;     // seconds between status lines, 0 = quiet
+    double seconds = 0.0;           // stop after this long, 0 = run until interrupted
+};
+
+static std::atomic<bool> gStop{false};
+
+static void onSignal(int) {
+    gStop.store(true);
+}
+
+static void printUsage() {
+    std::printf(
+        "usage: epiCBattle_server [options]\n"
+        "  --port N           UDP port (default %u)\n"
+        "  --map NAME         map in maps/ or a .ebmap path (default green)\n"
+        "  --players N        seats per match, 2 = duel, 3..256 = free-for-all (default 2)\n"
+        "  --workers N        worker threads (default: all cores)\n"
+        "  --matches N        match capacity per worker (default 256)\n"
+        "  --no-pin           do not pin workers to cores\n"
+        "  --stats SECONDS    status line interval, 0 = off (default 5)\n"
+        "  --seconds S        exit after S seconds (default: run until Ctrl-C)\n",
+        kDefaultServerPort);
+}
+
+static bool parseArgs(int argc, char **argv, ServerConfig &cfg) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto need = [&]() {
+            if (!value) { std::fprintf(stderr, "missing value for %s\n", arg); return false; }
+            ++i;
+            return true;
+        };
+        if (std::strcmp(arg, "--port") == 0) { if (!need()) return false; cfg.port = (uint16_t)std::atoi(value); }
+        else if (std::strcmp(arg, "--map") == 0) { if (!need()) return false; cfg.map = value; }
+        else if (std::strcmp(arg, "--players") == 0) { if (!need()) return false; cfg.players = std::atoi(value); }
+        else if (std::strcmp(arg, "--workers") == 0) { if (!need()) return false; cfg.workers = std::atoi(value); }
+        else if (std::strcmp(arg, "--matches") == 0) { if (!need()) return false; cfg.matchesPerWorker = std::atoi(value); }
+        else if (std::strcmp(arg, "--no-pin") == 0) cfg.pin = false;
+        else if (std::strcmp(arg, "--stats") == 0) { if (!need()) return false; cfg.statsInterval = std::atof(value); }
+        else if (std::strcmp(arg, "--seconds") == 0) { if (!need()) return false; cfg.seconds = std::atof(value); }
+        else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) { printUsage(); std::exit(0); }
+        else { std::fprintf(stderr, "unknown option '%s'\n", arg); return false; }
+    }
+    if (cfg.players < kDuelPlayers || cfg.players > kMaxPlayers) { std::fprintf(stderr, "--players must be in 2..%d\n", kMaxPlayers); return false; }
+    if (cfg.port == 0) { std::fprintf(stderr, "--port must be set; workers share it\n"); return false; }
+    if (cfg.matchesPerWorker < 1) { std::fprintf(stderr, "--matches must be positive\n"); return false; }
+    return true;
+}
+
+static void printStats(const std::vector<std::unique_ptr<MatchShard>> &shards, std::vector<ShardStats> &last, double interval) {
+    int matches = 0, clients = 0;
+    uint64_t ticks = 0, late = 0, in = 0, out = 0, bytes = 0, snapshots = 0, missed = 0, rejected = 0;
+    double busy = 0.0, tickSeconds = 0.0, peakBusy = 0.0;
+    for (size_t w = 0; w < shards.size(); ++w) {
+        ShardStats s = shards[w]->stats();
+        const ShardStats &p = last[w];
+        matches += s.matches;
+        clients += s.clients;
+        ticks += s.matchTicks - p.matchTicks;
+        late += s.lateTicks - p.lateTicks;
+        in += s.packetsIn - p.packetsIn;
+        out += s.packetsOut - p.packetsOut;
+        bytes += s.net.snapshotBytes - p.net.snapshotBytes;
+        snapshots += s.net.snapshotsSent - p.net.snapshotsSent;
+        missed += s.net.inputsMissed - p.net.inputsMissed;
+        rejected += s.rejected - p.rejected;
+        double b = s.busySeconds - p.busySeconds;
+        busy += b;
+        tickSeconds += s.tickSeconds - p.tickSeconds;
+        if (b / interval > peakBusy) peakBusy = b / interval;
+        last[w] = s;
+    }
+    double busyPerCore = busy / interval / (double)shards.size();
+    // Matches one fully busy core could carry at the current per-match cost
+    double perMatchTickUs = ticks ? busy * 1e6 / (double)ticks : 0.0;
+    double matchesPerCore = perMatchTickUs > 0.0 ? 1e6 / (perMatchTickUs * (1.0 / kFixedDt)) : 0.0;
+    std::printf("matches %d  clients %d  | %.0f ticks/s (%llu late)  in %.0f pkt/s  out %.0f pkt/s  %.1f B/snapshot  missed inputs %llu  rejected %llu\n",
+                matches, clients, ticks / interval, (unsigned long long)late, in / interval, out / interval,
+                snapshots ? (double)bytes / snapshots : 0.0, (unsigned long long)missed, (unsigned long long)rejected);
+    std::printf("  cpu: %.1f%% avg / %.1f%% peak per worker, %.2f us per match tick (%.2f in the sim+encode) -> ~%.0f matches/core\n",
+                busyPerCore * 100.0, peakBusy * 100.0, perMatchTickUs, ticks ? tickSeconds * 1e6 / (double)ticks : 0.0, matchesPerCore);
+    std::fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    ServerConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        printUsage();
+        return 2;
+    }
+    int cores = (int)std::thread::hardware_concurrency();
+    if (cores < 1) cores = 1;
+    int workers = cfg.workers > 0 ? cfg.workers : cores;
+#ifndef __linux__
+    // Without SO_REUSEPORT load balancing a second socket on the port would steal datagrams
+    if (workers > 1) std::printf("one worker only on this platform\n");
+    workers = 1;
+#endif
+
+    GameMap map;
+    if (!map.open(mapFilePath(cfg.map))) {
+        std::fprintf(stderr, "could not open map '%s' (%s)\n", cfg.map.c_str(), mapFilePath(cfg.map).c_str());
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<MatchShard>> shards;
+    for (int w = 0; w < workers; ++w) {
+        ShardConfig sc;
+        sc.port = cfg.port;
+        sc.map = &map;
+        sc.playersPerMatch = cfg.players;
+        sc.maxMatches = cfg.matchesPerWorker;
+        sc.cpu = cfg.pin ? w % cores : -1;
+        shards.emplace_back(new MatchShard(sc));
+        if (!shards.back()->open()) {
+            std::fprintf(stderr, "could not bind UDP port %u%s\n", cfg.port, w > 0 ? " again (SO_REUSEPORT unsupported? try --workers 1)" : "");
+            return 1;
+        }
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::printf("listening on UDP %u: %d workers%s, up to %d matches of %d each on %s\n", cfg.port, workers, cfg.pin ? " (pinned)" : "",
+                workers * cfg.matchesPerWorker, cfg.players, map.name().c_str());
+    std::fflush(stdout);
+
+    std::vector<std::thread> threads;
+    for (auto &shard : shards) {
+        MatchShard *s = shard.get();
+        threads.emplace_back([s]() { s->run(gStop); });
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    auto nextStats = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(cfg.statsInterval));
+    std::vector<ShardStats> last(shards.size());
+    while (!gStop.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (cfg.seconds > 0.0 && elapsed >= cfg.seconds) gStop.store(true);
+        if (cfg.statsInterval > 0.0 && Clock::now() >= nextStats) {
+            printStats(shards, last, cfg.statsInterval);
+            nextStats += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(cfg.statsInterval));
+        }
+    }
+    for (auto &t : threads) t.join();
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include "sim/bots.h"
+
+#include <cmath>
+#include "game/obstacle_grid.h"
+
+// Closer than this, with nothing in between, a bot steers straight at its target instead of
+// following the field
+static const float kBotDirectRange = 3.0f;
+// Height of the line-of-sight check above the feet
+static const float kBotEyeHeight = 0.5f;
+// With the field pool full, an opponent this close is still worth going for without one
+static const float kBotFieldlessRange = 8.0f;
+// Close enough to stop walking in and just swing
+static const float kBotStopDistance = 1.2f;
+static const float kBotSprintRange = 6.0f;
+static const float kBotAttackRange = 2.5f;
+// Ticks of pushing without getting anywhere before a bot tries jumping
+static const int kBotStuckTicks = 20;
+static const float kBotStuckDistance = 0.02f;
+
+// xorshift32, one stream per bot
+static uint32_t nextRandom(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void BotSystem::reset(const MapData &map, int playerCount, const bool bots[], uint32_t seed) {
+    map_ = &map;
+    buildNavGrid(grid_, map);
+    for (Field &field : fields_) {
+        field.flow.reserve(grid_);
+        field.target = -1;
+        field.followers = 0;
+    }
+    bots_.assign((size_t)playerCount, Bot{});
+    botCount_ = 0;
+    for (int i = 0; i < playerCount; ++i) {
+        if (!bots[i]) continue;
+        bots_[i].active = true;
+        bots_[i].rng = (seed * 2654435761u + (uint32_t)i * 40503u) | 1u;
+        botCount_++;
+    }
+    tick_ = 0;
+    nextField_ = 0;
+}
+
+void BotSystem::reset(const MapData &map, int playerCount, int firstBot, uint32_t seed) {
+    bool bots[kMaxPlayers] = {};
+    for (int i = firstBot; i < playerCount; ++i) bots[i] = true;
+    reset(map, playerCount, bots, seed);
+}
+
+int BotSystem::activeFields() const {
+    int active = 0;
+    for (const Field &field : fields_) active += field.followers > 0 ? 1 : 0;
+    return active;
+}
+
+// The field already chasing target, else one nobody follows any more
+int BotSystem::fieldFor(int target) {
+    for (int f = 0; f < kMaxFlowFields; ++f) {
+        if (fields_[f].target == target) return f;
+    }
+    for (int f = 0; f < kMaxFlowFields; ++f) {
+        if (fields_[f].followers > 0) continue;
+        fields_[f].flow.clear();
+        fields_[f].target = target;
+        return f;
+    }
+    return -1;
+}
+
+void BotSystem::retarget(const ServerState &s, int self) {
+    Bot &bot = bots_[self];
+    if (bot.field >= 0) fields_[bot.field].followers--;
+    bot.field = -1;
+    bot.target = -1;
+
+    // Nearest living opponents, and the nearest that already has a field in case the pool is
+    // full and the nearest is too far to steer at directly
+    float nearbyDistance[kBotNearby];
+    for (int k = 0; k < kBotNearby; ++k) {
+        bot.nearby[k] = -1;
+        nearbyDistance[k] = 1e30f;
+    }
+    int nearestTracked = -1;
+    float bestTracked = 1e30f;
+    for (int j = 0; j < s.playerCount; ++j) {
+        if (j == self || !s.alive(j)) continue;
+        float dx = s.posX[j] - s.posX[self];
+        float dz = s.posZ[j] - s.posZ[self];
+        float d = dx * dx + dz * dz;
+        if (d < nearbyDistance[kBotNearby - 1]) {
+            int k = kBotNearby - 1;
+            for (; k > 0 && nearbyDistance[k - 1] > d; --k) {
+                bot.nearby[k] = bot.nearby[k - 1];
+                nearbyDistance[k] = nearbyDistance[k - 1];
+            }
+            bot.nearby[k] = j;
+            nearbyDistance[k] = d;
+        }
+        if (d < bestTracked) {
+            for (const Field &field : fields_) {
+                if (field.target == j && field.followers > 0) { bestTracked = d; nearestTracked = j; break; }
+            }
+        }
+    }
+    const int nearest = bot.nearby[0];
+    if (nearest < 0) return;
+    bot.target = nearest;
+    bot.field = fieldFor(nearest);
+    if (bot.field < 0 && nearestTracked >= 0 && nearbyDistance[0] > kBotFieldlessRange * kBotFieldlessRange) {
+        bot.target = nearestTracked;
+        bot.field = fieldFor(nearestTracked);
+    }
+    if (bot.field >= 0) fields_[bot.field].followers++;
+}
+
+// Next cell's direction from cell: the field's, or from a blocked cell (a bot brushing an
+// obstacle's clearance) toward the cheapest open neighbour
+static uint8_t flowStep(const NavGrid &grid, const FlowField &flow, int cell) {
+    uint8_t step = flow.step(cell);
+    if (step != kFlowNone || !grid.blocked[cell]) return step;
+    const int cx = cell % grid.cellsX;
+    const int cz = cell / grid.cellsX;
+    uint16_t best = kFlowUnreachable;
+    for (int k = 0; k < 8; ++k) {
+        const int nx = cx + kFlowStepX[k];
+        const int nz = cz + kFlowStepZ[k];
+        if (nx < 0 || nz < 0 || nx >= grid.cellsX || nz >= grid.cellsZ) continue;
+        uint16_t cost = flow.cost(nz * grid.cellsX + nx);
+        if (cost < best) { best = cost; step = (uint8_t)k; }
+    }
+    return step;
+}
+
+PlayerInput BotSystem::steer(const ServerState &s, int self) {
+    PlayerInput in;
+    Bot &bot = bots_[self];
+    if (bot.target < 0 || !s.alive(self)) return in;
+
+    // Whoever of the remembered opponents is closest now; the chased one if none is closer
+    int fight = s.alive(bot.target) ? bot.target : -1;
+    float best = 1e30f;
+    if (fight >= 0) {
+        const float dx = s.posX[fight] - s.posX[self];
+        const float dz = s.posZ[fight] - s.posZ[self];
+        best = dx * dx + dz * dz;
+    }
+    for (int j : bot.nearby) {
+        if (j < 0 || !s.alive(j)) continue;
+        const float dx = s.posX[j] - s.posX[self];
+        const float dz = s.posZ[j] - s.posZ[self];
+        if (dx * dx + dz * dz < best) { best = dx * dx + dz * dz; fight = j; }
+    }
+    if (fight < 0) return in;
+
+    const float dx = s.posX[fight] - s.posX[self];
+    const float dz = s.posZ[fight] - s.posZ[self];
+    const float d = std::sqrt(best);
+    bool direct = d <= kBotDirectRange;
+    if (direct) {
+        Vec3 a = {s.posX[self], s.posY[self] + kBotEyeHeight, s.posZ[self]};
+        Vec3 b = {s.posX[fight], s.posY[fight] + kBotEyeHeight, s.posZ[fight]};
+        direct = !obstacleBlocksSegment(map_->obstacleGrid, map_->obstacles, a, b);
+    }
+    uint8_t step = kFlowNone;
+    if (!direct && bot.field >= 0) {
+        step = flowStep(grid_, fields_[bot.field].flow, grid_.cellAt(s.posX[self], s.posZ[self]));
+    }
+    if (step != kFlowNone) {
+        in.moveX = kFlowStepX[step];
+        in.moveZ = kFlowStepZ[step];
+    } else {
+        // Face the opponent the way a first-person player does, and walk in forward
+        in.buttons |= kButtonLook;
+        in.yaw = quantizeInputYaw(std::atan2(-dx, -dz));
+        if (d > kBotStopDistance) in.moveZ = -1;
+    }
+    if (d > kBotSprintRange) in.buttons |= kButtonSprint;
+    if (d <= kBotAttackRange && nextRandom(bot.rng) % 3 == 0) {
+        in.buttons |= (nextRandom(bot.rng) % 4 == 0) ? kButtonHeavy : kButtonLight;
+    }
+
+    // Pushing but not moving: a low obstacle or another fighter in the way, try hopping it
+    const float mx = s.posX[self] - bot.lastX;
+    const float mz = s.posZ[self] - bot.lastZ;
+    const bool pushing = in.moveX != 0 || in.moveZ != 0;
+    if (pushing && mx * mx + mz * mz < kBotStuckDistance * kBotStuckDistance) bot.stuckTicks++;
+    else bot.stuckTicks = 0;
+    if (bot.stuckTicks >= kBotStuckTicks) {
+        in.buttons |= kButtonJump;
+        bot.stuckTicks = 0;
+    }
+    bot.lastX = s.posX[self];
+    bot.lastZ = s.posZ[self];
+    return in;
+}
+
+void BotSystem::think(const MatchState &match, PlayerInput inputs[]) {
+    const ServerState &s = match.server;
+    const int count = (int)bots_.size() < s.playerCount ? (int)bots_.size() : s.playerCount;
+
+    // Retarget a staggered slice of the bots, plus any whose target went down
+    for (int i = 0; i < count; ++i) {
+        Bot &bot = bots_[i];
+        if (!bot.active) continue;
+        if (bot.target < 0 || !s.alive(bot.target) || (uint32_t)i % kBotThinkTicks == tick_ % kBotThinkTicks) retarget(s, i);
+    }
+
+    // Follow each chased player's cell. A rebuild in progress finishes toward the goal it
+    // started with, so a target that keeps moving cannot starve its field of ever completing.
+    for (Field &field : fields_) {
+        if (field.followers == 0 || field.flow.building()) continue;
+        field.flow.setGoal(grid_, grid_.cellAt(s.posX[field.target], s.posZ[field.target]));
+    }
+    int budget = kFlowCellsPerTick;
+    for (int n = 0; n < kMaxFlowFields && budget > 0; ++n) {
+        Field &field = fields_[(nextField_ + n) % kMaxFlowFields];
+        if (field.followers > 0 && field.flow.building()) budget -= field.flow.advance(grid_, budget);
+    }
+    nextField_ = (nextField_ + 1) % kMaxFlowFields;
+
+    for (int i = 0; i < count; ++i) {
+        if (bots_[i].active) inputs[i] = steer(s, i);
+    }
+    tick_++;
+}
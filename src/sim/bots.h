@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "sim/flow_field.h"
+#include "sim/sim.h"
+
+// Each bot re-picks its target once per this many ticks, staggered by player index
+constexpr int kBotThinkTicks = 8;
+// Nearest opponents remembered at that scan; the one to fight is picked from them every tick
+constexpr int kBotNearby = 4;
+// Flow fields alive at once; bots whose nearest opponent has none go for one that does
+constexpr int kMaxFlowFields = 32;
+// Flow-field cells expanded per tick across every field being rebuilt
+constexpr int kFlowCellsPerTick = 4096;
+
+// Computer-controlled fighters. think() writes a PlayerInput for every bot from the state
+// the tick starts from, the same struct a human's input becomes, so bots go through the
+// unchanged tick, rollback and replay paths.
+//
+// Navigation shares work between bots: there is one FlowField per chased player, and
+// every bot after that player reads its next step from it in O(1). The expensive parts are
+// spread over ticks: retargeting (a scan of all players) happens for 1/kBotThinkTicks of
+// the bots each tick, keeping the few nearest opponents so a bot can still turn on whoever
+// steps up to it in between, and field rebuilds, started when a target crosses into another cell,
+// share a budget of kFlowCellsPerTick cells. Per-tick cost is then roughly constant in the
+// bot count, a couple of hundred bots fit well inside the 60 Hz tick.
+//
+// Deterministic: the same match states in give the same inputs out, on any thread.
+class BotSystem {
+public:
+    // Builds the navigation grid for map and makes player i a bot where bots[i] is set. map
+    // must stay loaded until the next reset.
+    void reset(const MapData &map, int playerCount, const bool bots[], uint32_t seed);
+    // Players [firstBot, playerCount) are bots.
+    void reset(const MapData &map, int playerCount, int firstBot, uint32_t seed);
+
+    // Fills inputs[i] for every bot; other entries are left alone.
+    void think(const MatchState &match, PlayerInput inputs[]);
+
+    int botCount() const { return botCount_; }
+    int activeFields() const;
+    const NavGrid &grid() const { return grid_; }
+
+private:
+    struct Field {
+        FlowField flow;
+        int target = -1;
+        int followers = 0;
+    };
+    struct Bot {
+        bool active = false;
+        int target = -1;        // chased through field
+        int field = -1;
+        int nearby[kBotNearby] = {-1, -1, -1, -1};
+        uint32_t rng = 1;
+        float lastX = 0.0f;
+        float lastZ = 0.0f;
+        int stuckTicks = 0;
+    };
+
+    void retarget(const ServerState &s, int self);
+    int fieldFor(int target);
+    PlayerInput steer(const ServerState &s, int self);
+
+    const MapData *map_ = nullptr;
+    NavGrid grid_;
+    Field fields_[kMaxFlowFields];
+    std::vector<Bot> bots_;
+    int botCount_ = 0;
+    uint32_t tick_ = 0;
+    int nextField_ = 0;     // round-robin start for the rebuild budget
+};
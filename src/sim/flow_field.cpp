@@ -0,0 +1,137 @@
+#include "sim/flow_field.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Obstacles whose bottom is above this do not block walking (the sim tests the feet only)
+static const float kNavBlockHeight = 1.0f;
+// Kept between paths and obstacle sides so bots do not grind along them
+static const float kNavClearance = 0.2f;
+// Same as the sim's arena clamp
+static const float kNavArenaMargin = 1.0f;
+
+const int8_t kFlowStepX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+const int8_t kFlowStepZ[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+int NavGrid::cellAt(float x, float z) const {
+    int cx = std::clamp((int)std::floor((x - originX) * invCellSize), 0, cellsX - 1);
+    int cz = std::clamp((int)std::floor((z - originZ) * invCellSize), 0, cellsZ - 1);
+    return cz * cellsX + cx;
+}
+
+void buildNavGrid(NavGrid &grid, const MapData &map) {
+    const float sizeX = std::max(map.arenaSize.x, kNavCellSize);
+    const float sizeZ = std::max(map.arenaSize.z, kNavCellSize);
+    grid.cellSize = std::max(kNavCellSize, std::max(sizeX, sizeZ) / (float)kNavMaxCells);
+    grid.invCellSize = 1.0f / grid.cellSize;
+    grid.cellsX = std::min(kNavMaxCells, std::max(1, (int)std::ceil(sizeX * grid.invCellSize)));
+    grid.cellsZ = std::min(kNavMaxCells, std::max(1, (int)std::ceil(sizeZ * grid.invCellSize)));
+    grid.originX = -sizeX * 0.5f;
+    grid.originZ = -sizeZ * 0.5f;
+    grid.blocked.assign((size_t)grid.cellCount(), 0);
+
+    // Outside the clamp strip: the centre has to be reachable
+    const float limitX = sizeX * 0.5f - kNavArenaMargin;
+    const float limitZ = sizeZ * 0.5f - kNavArenaMargin;
+    for (int z = 0; z < grid.cellsZ; ++z) {
+        for (int x = 0; x < grid.cellsX; ++x) {
+            float cx = grid.originX + (x + 0.5f) * grid.cellSize;
+            float cz = grid.originZ + (z + 0.5f) * grid.cellSize;
+            if (std::fabs(cx) > limitX || std::fabs(cz) > limitZ) grid.blocked[z * grid.cellsX + x] = 1;
+        }
+    }
+    for (int i = 0; i < map.obstacleCount; ++i) {
+        const AABB &box = map.obstacles[i];
+        if (box.min.y > kNavBlockHeight) continue;
+        int x0 = std::max(0, (int)std::floor((box.min.x - kNavClearance - grid.originX) * grid.invCellSize));
+        int x1 = std::min(grid.cellsX - 1, (int)std::floor((box.max.x + kNavClearance - grid.originX) * grid.invCellSize));
+        int z0 = std::max(0, (int)std::floor((box.min.z - kNavClearance - grid.originZ) * grid.invCellSize));
+        int z1 = std::min(grid.cellsZ - 1, (int)std::floor((box.max.z + kNavClearance - grid.originZ) * grid.invCellSize));
+        for (int z = z0; z <= z1; ++z) {
+            for (int x = x0; x <= x1; ++x) grid.blocked[z * grid.cellsX + x] = 1;
+        }
+    }
+}
+
+void FlowField::setGoal(const NavGrid &grid, int goal) {
+    if (goal < 0 || goal >= grid.cellCount()) return;
+    if (goal == (building() ? nextGoal_ : goal_)) return;
+    if (goal == goal_) {
+        // Back where the complete field already leads
+        for (auto &bucket : buckets_) bucket.clear();
+        nextGoal_ = -1;
+        queued_ = 0;
+        return;
+    }
+    const size_t cells = (size_t)grid.cellCount();
+    nextCost_.assign(cells, kFlowUnreachable);
+    nextDirection_.assign(cells, kFlowNone);
+    for (auto &bucket : buckets_) bucket.clear();
+    nextGoal_ = goal;
+    nextCost_[goal] = 0;
+    buckets_[0].push_back(goal);
+    bucketPos_ = 0;
+    distance_ = 0;
+    queued_ = 1;
+}
+
+int FlowField::advance(const NavGrid &grid, int budget) {
+    int used = 0;
+    while (queued_ > 0 && used < budget) {
+        std::vector<int> &bucket = buckets_[distance_ & 3];
+        if (bucketPos_ >= bucket.size()) {
+            bucket.clear();
+            bucketPos_ = 0;
+            distance_++;
+            continue;
+        }
+        const int cell = bucket[bucketPos_++];
+        queued_--;
+        if (nextCost_[cell] != distance_) continue;     // reached more cheaply since it was queued
+        used++;
+        const int cx = cell % grid.cellsX;
+        const int cz = cell / grid.cellsX;
+        for (int k = 0; k < 8; ++k) {
+            const int nx = cx + kFlowStepX[k];
+            const int nz = cz + kFlowStepZ[k];
+            if (nx < 0 || nz < 0 || nx >= grid.cellsX || nz >= grid.cellsZ) continue;
+            const int next = nz * grid.cellsX + nx;
+            if (grid.blocked[next]) continue;
+            const bool diagonal = (k & 1) != 0;
+            // No cutting corners: both cells beside a diagonal step must be open
+            if (diagonal && (grid.blocked[cz * grid.cellsX + nx] || grid.blocked[nz * grid.cellsX + cx])) continue;
+            const uint32_t cost = distance_ + (diagonal ? 3 : 2);
+            if (cost >= nextCost_[next]) continue;
+            nextCost_[next] = (uint16_t)cost;
+            nextDirection_[next] = (uint8_t)((k + 4) & 7);     // back toward cell
+            buckets_[cost & 3].push_back(next);
+            queued_++;
+        }
+    }
+    if (queued_ == 0 && nextGoal_ >= 0) {
+        goal_ = nextGoal_;
+        nextGoal_ = -1;
+        cost_.swap(nextCost_);
+        direction_.swap(nextDirection_);
+    }
+    return used;
+}
+
+void FlowField::reserve(const NavGrid &grid) {
+    const size_t cells = (size_t)grid.cellCount();
+    cost_.assign(cells, kFlowUnreachable);
+    direction_.assign(cells, kFlowNone);
+    nextCost_.assign(cells, kFlowUnreachable);
+    nextDirection_.assign(cells, kFlowNone);
+    // A bucket holds one cost's ring of cells plus a few stale entries, far below this
+    for (auto &bucket : buckets_) bucket.reserve(cells / 2 + 1);
+    clear();
+}
+
+void FlowField::clear() {
+    goal_ = -1;
+    nextGoal_ = -1;
+    for (auto &bucket : buckets_) bucket.clear();
+    bucketPos_ = 0;
+    queued_ = 0;
+}
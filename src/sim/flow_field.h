@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "core/types.h"
+#include "game/maps.h"
+
+// Walkability grid over the arena floor for bot navigation, built from MapData::arenaSize
+// and MapData::obstacles. A cell is blocked when an obstacle that reaches into walking
+// height overlaps it (grown by a little clearance), or when it lies outside the strip the
+// sim clamps players to. Cells are at least kNavCellSize; large arenas get coarser cells so
+// the grid stays within kNavMaxCells per side.
+constexpr float kNavCellSize = 0.5f;
+constexpr int kNavMaxCells = 128;
+
+struct NavGrid {
+    float originX = 0.0f;
+    float originZ = 0.0f;
+    float cellSize = kNavCellSize;
+    float invCellSize = 1.0f / kNavCellSize;
+    int cellsX = 0;
+    int cellsZ = 0;
+    std::vector<uint8_t> blocked;   // cellsX * cellsZ, row-major in z
+
+    int cellCount() const { return cellsX * cellsZ; }
+    // Cell under (x, z), clamped to the grid
+    int cellAt(float x, float z) const;
+};
+
+void buildNavGrid(NavGrid &grid, const MapData &map);
+
+// Step from a cell toward the goal: an index into kFlowStepX/kFlowStepZ (the 8 neighbours,
+// diagonals at odd indices), or kFlowNone where there is no path.
+constexpr uint8_t kFlowNone = 0xFF;
+constexpr uint16_t kFlowUnreachable = 0xFFFF;
+extern const int8_t kFlowStepX[8];
+extern const int8_t kFlowStepZ[8];
+
+// Shortest paths from every cell to one goal cell (straight steps cost 2, diagonals 3),
+// shared by every bot heading for that goal. Moving the goal starts a rebuild that advance()
+// runs a budgeted number of cells at a time, so a field never costs a whole grid in one
+// tick. Until it finishes, step() keeps answering from the last complete field: near the
+// old goal that is still the right way, and bots that close in steer at their target
+// directly anyway.
+class FlowField {
+public:
+    // Starts a rebuild toward goal unless the field already leads there or is building it.
+    void setGoal(const NavGrid &grid, int goal);
+    // Expands up to budget cells of the rebuild; returns how many it used.
+    int advance(const NavGrid &grid, int budget);
+    // Sizes every buffer for grid and clears the field, so rebuilds on grid never allocate.
+    void reserve(const NavGrid &grid);
+
+    bool building() const { return queued_ > 0; }
+    bool ready() const { return goal_ >= 0; }
+    int goal() const { return goal_; }
+    // Direction index toward the goal, or kFlowNone
+    uint8_t step(int cell) const { return goal_ >= 0 ? direction_[cell] : kFlowNone; }
+    uint16_t cost(int cell) const { return goal_ >= 0 ? cost_[cell] : kFlowUnreachable; }
+    void clear();
+
+private:
+    // Complete field
+    int goal_ = -1;
+    std::vector<uint16_t> cost_;
+    std::vector<uint8_t> direction_;
+    // Rebuild in progress: Dial's algorithm, one bucket per cost modulo 4 (steps cost 2 or 3)
+    int nextGoal_ = -1;
+    std::vector<uint16_t> nextCost_;
+    std::vector<uint8_t> nextDirection_;
+    std::vector<int> buckets_[4];
+    size_t bucketPos_ = 0;
+    uint32_t distance_ = 0;
+    int queued_ = 0;
+};
@@ -0,0 +1,121 @@
+#include "sim/hit_query.h"
+
+#include <algorithm>
+#include <cmath>
+
+const AttackDef kLightAttack = {2.5f, 0.35f, 10, 0.18f, 0.45f};     // ~70 degree half-cone
+const AttackDef kHeavyAttack = {2.8f, 0.5f, 22, 0.35f, 0.9f};       // 60 degree half-cone
+
+// Fighters this close are hit regardless of facing
+static const float kPointBlankRange = 0.4f;
+// Below this many players building the hash costs more than scanning everyone. From
+// `epiCBattle_bench hits`: pairwise is twice as fast at 16, even at 48, slower from 56.
+static const int kHashMinPlayers = 48;
+
+static int cellOf(float v, float invCell) { return (int)std::floor(v * invCell); }
+
+static uint32_t bucketOf(int cx, int cz) {
+    uint32_t h = (uint32_t)cx * 73856093u ^ (uint32_t)cz * 19349663u;
+    return h & (kHashBuckets - 1);
+}
+
+void buildPlayerHash(PlayerHash &hash, const ServerState &server, float cellSize) {
+    hash.cellSize = cellSize;
+    hash.invCellSize = 1.0f / cellSize;
+    uint16_t counts[kHashBuckets + 1] = {};
+    uint16_t bucketOfPlayer[kMaxPlayers];
+    for (int i = 0; i < server.playerCount; ++i) {
+        if (!server.alive(i)) continue;
+        uint32_t b = bucketOf(cellOf(server.posX[i], hash.invCellSize), cellOf(server.posZ[i], hash.invCellSize));
+        bucketOfPlayer[i] = (uint16_t)b;
+        counts[b + 1]++;
+    }
+    for (int b = 0; b < kHashBuckets; ++b) counts[b + 1] += counts[b];
+    std::copy(counts, counts + kHashBuckets + 1, hash.bucketStart);
+    // Players are inserted in index order, so each bucket lists them ascending
+    for (int i = 0; i < server.playerCount; ++i) {
+        if (!server.alive(i)) continue;
+        hash.items[counts[bucketOfPlayer[i]]++] = (uint16_t)i;
+    }
+}
+
+static bool attackHits(const ServerState &server, int attacker, int victim, const AttackDef &attack) {
+    float dx = server.posX[victim] - server.posX[attacker];
+    float dy = server.posY[victim] - server.posY[attacker];
+    float dz = server.posZ[victim] - server.posZ[attacker];
+    float distSq = dx * dx + dy * dy + dz * dz;
+    if (distSq > attack.range * attack.range) return false;
+    float planar = std::sqrt(dx * dx + dz * dz);
+    if (planar > kPointBlankRange) {
+        float yaw = server.yawRadians[attacker];
+        float facing = (-std::sin(yaw) * dx - std::cos(yaw) * dz) / planar;
+        if (facing < attack.coneCos) return false;
+    }
+    return true;
+}
+
+// Each attacker starts at most one attack per tick and hits each victim at most once, so
+// kMaxHitsPerTick always has room
+static void addHit(HitBatch &batch, int attacker, int victim, int damage) {
+    batch.hits[batch.hitCount++] = {(uint16_t)attacker, (uint16_t)victim, damage};
+}
+
+static void applyHits(ServerState &server, HitBatch &batch) {
+    std::sort(batch.hits, batch.hits + batch.hitCount, [](const HitEvent &a, const HitEvent &b) {
+        return a.attacker != b.attacker ? a.attacker < b.attacker : a.victim < b.victim;
+    });
+    for (int k = 0; k < batch.hitCount; ++k) {
+        const HitEvent &hit = batch.hits[k];
+        server.health[hit.victim] -= hit.damage;
+        if (server.health[hit.victim] < 0) server.health[hit.victim] = 0;
+    }
+}
+
+void resolveAttacks(ServerState &server, HitBatch &batch) {
+    batch.hitCount = 0;
+    if (batch.attackCount == 0) return;
+    if (server.playerCount < kHashMinPlayers) {
+        resolveAttacksBruteForce(server, batch);
+        return;
+    }
+    // One cell per max attack range, so a 3x3 neighbourhood covers every reachable victim
+    float cellSize = std::max(kLightAttack.range, kHeavyAttack.range);
+    PlayerHash hash;
+    buildPlayerHash(hash, server, cellSize);
+
+    for (int a = 0; a < batch.attackCount; ++a) {
+        const AttackRequest &req = batch.attacks[a];
+        int cx = cellOf(server.posX[req.attacker], hash.invCellSize);
+        int cz = cellOf(server.posZ[req.attacker], hash.invCellSize);
+        // Distinct cells can share a bucket; remember visited buckets so nobody is hit twice
+        uint32_t visited[9];
+        int visitedCount = 0;
+        for (int oz = -1; oz <= 1; ++oz) {
+            for (int ox = -1; ox <= 1; ++ox) {
+                uint32_t b = bucketOf(cx + ox, cz + oz);
+                bool seen = false;
+                for (int v = 0; v < visitedCount; ++v) seen |= (visited[v] == b);
+                if (seen) continue;
+                visited[visitedCount++] = b;
+                for (uint16_t k = hash.bucketStart[b]; k < hash.bucketStart[b + 1]; ++k) {
+                    int victim = hash.items[k];
+                    if (victim == req.attacker) continue;
+                    if (attackHits(server, req.attacker, victim, *req.attack)) addHit(batch, req.attacker, victim, req.attack->damage);
+                }
+            }
+        }
+    }
+    applyHits(server, batch);
+}
+
+void resolveAttacksBruteForce(ServerState &server, HitBatch &batch) {
+    batch.hitCount = 0;
+    for (int a = 0; a < batch.attackCount; ++a) {
+        const AttackRequest &req = batch.attacks[a];
+        for (int victim = 0; victim < server.playerCount; ++victim) {
+            if (victim == req.attacker || !server.alive(victim)) continue;
+            if (attackHits(server, req.attacker, victim, *req.attack)) addHit(batch, req.attacker, victim, req.attack->damage);
+        }
+    }
+    applyHits(server, batch);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include "sim/sim.h"
+
+// Batched melee hit resolution. Living players are bucketed into a spatial hash once per
+// tick; every attack started that tick is then resolved against only the nearby buckets,
+// with range and facing cone tests. Damage is applied after all attacks
+// resolve, in (attacker, victim) order, so results do not depend on iteration order.
+
+struct AttackDef {
+    float range;
+    float coneCos;      // cosine of the half-angle of the facing cone
+    int damage;
+    float duration;
+    float cooldown;
+};
+
+extern const AttackDef kLightAttack;
+extern const AttackDef kHeavyAttack;
+
+struct AttackRequest {
+    int attacker;
+    const AttackDef *attack;
+};
+
+struct HitEvent {
+    uint16_t attacker;
+    uint16_t victim;
+    int damage;
+};
+
+constexpr int kHashBuckets = 512;       // power of two, >= 2 * kMaxPlayers
+// Every player attacking and reaching every other player: the batch never has to drop a hit
+constexpr int kMaxHitsPerTick = kMaxPlayers * (kMaxPlayers - 1);
+
+// Spatial hash over player positions, rebuilt every tick. Fixed capacity; no allocation.
+struct PlayerHash {
+    float cellSize;
+    float invCellSize;
+    uint16_t bucketStart[kHashBuckets + 1];
+    uint16_t items[kMaxPlayers];
+};
+
+void buildPlayerHash(PlayerHash &hash, const ServerState &server, float cellSize);
+
+// About half a megabyte at kMaxPlayers, so keep it off the stack.
+struct HitBatch {
+    AttackRequest attacks[kMaxPlayers];
+    int attackCount;
+    HitEvent hits[kMaxHitsPerTick];
+    int hitCount;
+};
+
+// Resolves every queued attack and applies the damage. Fills batch.hits in application order.
+void resolveAttacks(ServerState &server, HitBatch &batch);
+
+// O(attacks * players) reference used by the benchmark to check the hash path.
+void resolveAttacksBruteForce(ServerState &server, HitBatch &batch);
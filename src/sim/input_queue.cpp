@@ -0,0 +1,42 @@
+#include "sim/input_queue.h"
+
+static const uint8_t kHeldButtons = kButtonSprint | kButtonLook;
+
+double InputQueue::take(double until, PlayerInput inputs[], int playerCount) {
+    uint8_t presses[kMaxPlayers] = {};
+    double firstPress = 0.0;
+    while (const InputEvent *e = events_.front()) {
+        if (e->time > until) break;
+        PlayerInput &h = held_[e->player];
+        switch (e->type) {
+            case kInputPress:
+                h.buttons |= (uint8_t)(e->button & kHeldButtons);
+                if (e->button & ~kHeldButtons) {
+                    presses[e->player] |= (uint8_t)(e->button & ~kHeldButtons);
+                    if (firstPress == 0.0) firstPress = e->time;
+                }
+                break;
+            case kInputRelease:
+                h.buttons &= (uint8_t)~e->button;
+                break;
+            case kInputMove:
+                h.moveX = e->moveX;
+                h.moveZ = e->moveZ;
+                break;
+            case kInputLook:
+                h.yaw = e->yaw;
+                break;
+        }
+        events_.pop();
+    }
+    for (int i = 0; i < playerCount; ++i) {
+        inputs[i] = held_[i];
+        inputs[i].buttons |= presses[i];
+    }
+    return firstPress;
+}
+
+void InputQueue::reset() {
+    while (events_.front()) events_.pop();
+    for (PlayerInput &h : held_) h = PlayerInput{};
+}
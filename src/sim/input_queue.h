@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include "core/spsc_queue.h"
+#include "sim/sim.h"
+
+// Local input as timestamped edges instead of per-frame state. A sampler (any rate, any
+// thread) pushes an event whenever a key, axis or look yaw changes; the fixed tick takes
+// exactly the events stamped inside its window. A press then lands on one tick, never on
+// none or several, however the sampling and tick rates line up.
+
+// Clock for event stamps and tick deadlines: steady, in seconds
+static inline double inputClockSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum InputEventType : uint8_t {
+    kInputPress,        // button went down: held buttons (sprint, look) stay on, the rest fire once
+    kInputRelease,      // held button went up
+    kInputMove,         // new move axes
+    kInputLook,         // new first-person yaw
+};
+
+struct InputEvent {
+    double time;        // inputClockSeconds() when sampled
+    uint8_t player;
+    uint8_t type;       // InputEventType
+    uint8_t button;     // kButton* for press/release
+    int8_t moveX;
+    int8_t moveZ;
+    uint16_t yaw;
+};
+
+constexpr uint32_t kInputQueueCapacity = 1024;
+
+// One producer (the sampler) and one consumer (whoever runs the tick). The held state lives
+// on the consumer side, so reset() must be called from there too.
+class InputQueue {
+public:
+    // Producer. False when the consumer is kInputQueueCapacity events behind; the event is dropped.
+    bool push(const InputEvent &event) { return events_.push(event); }
+
+    // Consumer. Folds every event stamped at or before until into the players' state and fills
+    // inputs[0..playerCount) for one tick. Later events stay queued for later ticks.
+    // Returns the sample time of the oldest one-shot press taken, or 0 if the tick got none.
+    double take(double until, PlayerInput inputs[], int playerCount);
+
+    // Consumer. Drops queued events and releases everything held.
+    void reset();
+
+private:
+    SpscQueue<InputEvent, kInputQueueCapacity> events_;
+    PlayerInput held_[kMaxPlayers] = {};
+};
@@ -0,0 +1,198 @@
+#include "sim/replay.h"
+
+#include <cstdio>
+#include <cstring>
+#include "assets/cache_io.h"
+#include "game/characters.h"
+#include "game/maps.h"
+
+uint32_t packInput(const PlayerInput &input) {
+    // 2 bits per axis (-1..1 stored as 0..2), 5 button bits, then the yaw if it is used
+    uint32_t code = (uint32_t)((input.moveX + 1) | ((input.moveZ + 1) << 2) | ((input.buttons & 0x1F) << 4));
+    if (input.has(kButtonLook)) code |= (uint32_t)input.yaw << 9;
+    return code;
+}
+
+PlayerInput unpackInput(uint32_t code) {
+    PlayerInput input;
+    input.moveX = (int8_t)((code & 3) - 1);
+    input.moveZ = (int8_t)(((code >> 2) & 3) - 1);
+    input.buttons = (uint8_t)((code >> 4) & 0x1F);
+    input.yaw = (uint16_t)(code >> 9);
+    return input;
+}
+
+void putVarint(std::vector<uint8_t> &out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+bool getVarint(const uint8_t *data, size_t size, size_t &pos, uint32_t &v) {
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= size) return false;
+        uint8_t b = data[pos++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Most a stream can grow per tick: a run of one, i.e. a code of up to 25 bits (4 varint
+// bytes) and a length of 1
+static const size_t kMaxStreamBytesPerTick = 5;
+
+void beginReplay(ReplayRecorder &rec, const std::string &map, const MatchState &match, uint32_t reserveTicks) {
+    rec.replay = Replay{};
+    rec.replay.map = map.substr(0, 255);
+    rec.replay.tickRate = (int)(1.0f / kFixedDt + 0.5f);
+    rec.replay.playerCount = match.server.playerCount;
+    for (int i = 0; i < match.server.playerCount; ++i) rec.replay.characterIndex[i] = match.server.characterIndex[i];
+    rec.replay.streams.assign(match.server.playerCount, std::vector<uint8_t>());
+    if (reserveTicks > 0) {
+        for (std::vector<uint8_t> &stream : rec.replay.streams) stream.reserve(reserveTicks * kMaxStreamBytesPerTick);
+        rec.replay.checksums.reserve(reserveTicks / kReplayChecksumInterval);
+    }
+    for (int i = 0; i < kMaxPlayers; ++i) rec.run[i] = 0;
+}
+
+void recordReplayTick(ReplayRecorder &rec, const PlayerInput inputs[], const MatchState &after) {
+    Replay &r = rec.replay;
+    for (int i = 0; i < r.playerCount; ++i) {
+        uint32_t code = packInput(inputs[i]);
+        if (rec.run[i] > 0 && code == rec.code[i]) {
+            rec.run[i]++;
+            continue;
+        }
+        if (rec.run[i] > 0) {
+            putVarint(r.streams[i], rec.code[i]);
+            putVarint(r.streams[i], rec.run[i]);
+        }
+        rec.code[i] = code;
+        rec.run[i] = 1;
+    }
+    r.tickCount++;
+    if (r.tickCount % kReplayChecksumInterval == 0) r.checksums.push_back(matchChecksum(after));
+}
+
+void finishReplay(ReplayRecorder &rec, const MatchState &final) {
+    Replay &r = rec.replay;
+    r.finalChecksum = matchChecksum(final);
+    for (int i = 0; i < r.playerCount; ++i) {
+        if (rec.run[i] == 0) continue;
+        putVarint(r.streams[i], rec.code[i]);
+        putVarint(r.streams[i], rec.run[i]);
+        rec.run[i] = 0;
+    }
+}
+
+void startReplay(ReplayCursor &cursor, const Replay &replay) {
+    cursor.replay = &replay;
+    cursor.tick = 0;
+    for (int i = 0; i < replay.playerCount; ++i) {
+        cursor.pos[i] = 0;
+        cursor.remaining[i] = 0;
+        cursor.code[i] = 0;
+    }
+}
+
+bool nextReplayTick(ReplayCursor &cursor, PlayerInput inputs[]) {
+    const Replay &r = *cursor.replay;
+    if (cursor.tick >= r.tickCount) return false;
+    for (int i = 0; i < r.playerCount; ++i) {
+        if (cursor.remaining[i] == 0) {
+            const std::vector<uint8_t> &stream = r.streams[i];
+            if (!getVarint(stream.data(), stream.size(), cursor.pos[i], cursor.code[i])) return false;
+            if (!getVarint(stream.data(), stream.size(), cursor.pos[i], cursor.remaining[i]) || cursor.remaining[i] == 0) return false;
+        }
+        cursor.remaining[i]--;
+        inputs[i] = unpackInput(cursor.code[i]);
+    }
+    cursor.tick++;
+    return true;
+}
+
+bool checkReplayTick(const ReplayCursor &cursor, const MatchState &match) {
+    if (cursor.tick == cursor.replay->tickCount && cursor.replay->finalChecksum != matchChecksum(match)) return false;
+    if (cursor.tick == 0 || cursor.tick % kReplayChecksumInterval != 0) return true;
+    size_t slot = cursor.tick / kReplayChecksumInterval - 1;
+    if (slot >= cursor.replay->checksums.size()) return true;
+    return cursor.replay->checksums[slot] == matchChecksum(match);
+}
+
+bool saveReplay(const std::string &path, const Replay &replay) {
+    ReplayFileHeader header{};
+    header.magic = kReplayMagic;
+    header.version = kReplayVersion;
+    header.tickCount = replay.tickCount;
+    header.tickRate = (uint16_t)replay.tickRate;
+    header.playerCount = (uint16_t)replay.playerCount;
+    header.mapNameLength = (uint8_t)replay.map.size();
+    header.checksumInterval = kReplayChecksumInterval;
+    header.checksumCount = (uint32_t)replay.checksums.size();
+    header.finalChecksum = replay.finalChecksum;
+
+    std::vector<uint8_t> blob(sizeof(header));
+    std::memcpy(blob.data(), &header, sizeof(header));
+    blob.insert(blob.end(), replay.map.begin(), replay.map.begin() + header.mapNameLength);
+    for (int i = 0; i < replay.playerCount; ++i) blob.push_back((uint8_t)replay.characterIndex[i]);
+    const uint8_t *sums = (const uint8_t *)replay.checksums.data();
+    blob.insert(blob.end(), sums, sums + sizeof(uint64_t) * replay.checksums.size());
+    for (int i = 0; i < replay.playerCount; ++i) {
+        uint32_t bytes = (uint32_t)replay.streams[i].size();
+        const uint8_t *b = (const uint8_t *)&bytes;
+        blob.insert(blob.end(), b, b + sizeof(bytes));
+        blob.insert(blob.end(), replay.streams[i].begin(), replay.streams[i].end());
+    }
+
+    return writeFileAtomic(path, blob.data(), blob.size());
+}
+
+bool loadReplay(const std::string &path, Replay &out) {
+    FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> blob;
+    uint8_t buffer[16384];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), f)) > 0) blob.insert(blob.end(), buffer, buffer + n);
+    std::fclose(f);
+
+    ReplayFileHeader header;
+    if (blob.size() < sizeof(header)) return false;
+    std::memcpy(&header, blob.data(), sizeof(header));
+    if (header.magic != kReplayMagic || header.version != kReplayVersion) return false;
+    if (header.playerCount < kDuelPlayers || header.playerCount > kMaxPlayers || header.tickRate == 0) return false;
+    if (header.mapNameLength == 0 || header.checksumInterval != kReplayChecksumInterval) return false;
+
+    out = Replay{};
+    out.tickRate = header.tickRate;
+    out.playerCount = header.playerCount;
+    out.tickCount = header.tickCount;
+    out.finalChecksum = header.finalChecksum;
+    size_t pos = sizeof(header);
+    if (pos + header.mapNameLength + header.playerCount + (size_t)header.checksumCount * sizeof(uint64_t) > blob.size()) return false;
+    out.map.assign((const char *)&blob[pos], header.mapNameLength);
+    pos += header.mapNameLength;
+    if (!isMapName(out.map)) return false;
+    for (int i = 0; i < out.playerCount; ++i) {
+        out.characterIndex[i] = blob[pos++];
+        if (out.characterIndex[i] >= kCharacterCount) return false;
+    }
+    out.checksums.resize(header.checksumCount);
+    if (header.checksumCount > 0) std::memcpy(out.checksums.data(), &blob[pos], sizeof(uint64_t) * header.checksumCount);
+    pos += sizeof(uint64_t) * header.checksumCount;
+    out.streams.resize(out.playerCount);
+    for (int i = 0; i < out.playerCount; ++i) {
+        uint32_t bytes;
+        if (pos + sizeof(bytes) > blob.size()) return false;
+        std::memcpy(&bytes, &blob[pos], sizeof(bytes));
+        pos += sizeof(bytes);
+        if (pos + bytes > blob.size()) return false;
+        out.streams[i].assign(blob.begin() + pos, blob.begin() + pos + bytes);
+        pos += bytes;
+    }
+    return true;
+}
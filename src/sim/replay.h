@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/types.h"
+#include "sim/sim.h"
+
+// Match replays (.ebrp). The sim is deterministic, so a replay is just the setup (map,
+// characters, tick rate) plus every player's PlayerInput per tick. Each input packs into
+// a small code (see packInput; one or two bytes, four with a look yaw) and each player's
+// codes are run-length encoded: held inputs and idle stretches collapse into a single run.
+//
+// Layout: ReplayFileHeader, the map name (mapNameLength bytes), playerCount character bytes,
+// checksumCount u64 checksums, then per player a u32 byte length and that player's stream of
+// (LEB128 code, LEB128 run length) pairs.
+
+constexpr uint32_t kReplayMagic = 0x50524245;   // "EBRP"
+constexpr uint32_t kReplayVersion = 4;     // 2: look yaw and relative movement in inputs; 3: map by name; 4: floor-only ground, hits ignore obstacles
+constexpr int kReplayChecksumInterval = 60;     // matchChecksum() every N ticks, for locating desyncs
+
+struct ReplayFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t tickCount;
+    uint16_t tickRate;
+    uint16_t playerCount;
+    uint8_t mapNameLength;      // map file stem, see game/maps.h
+    uint8_t reserved[3];
+    uint32_t checksumInterval;
+    uint32_t checksumCount;
+    uint64_t finalChecksum;     // state after the last tick
+};
+
+struct Replay {
+    std::string map;            // map name, opened with mapFilePath()
+    int tickRate = 60;
+    int playerCount = 0;
+    int characterIndex[kMaxPlayers] = {};
+    uint32_t tickCount = 0;
+    std::vector<uint64_t> checksums;            // state after ticks kReplayChecksumInterval, 2x, ...
+    uint64_t finalChecksum = 0;
+    std::vector<std::vector<uint8_t>> streams;  // one RLE stream per player
+
+    float tickDt() const { return 1.0f / (float)tickRate; }
+};
+
+// Bits 0-3 move axes, 4-8 buttons, 9-24 yaw (kButtonLook only, so world-axis inputs stay
+// under 512 and mostly under 128).
+uint32_t packInput(const PlayerInput &input);
+PlayerInput unpackInput(uint32_t code);
+
+// LEB128, shared by replay streams and network input packets.
+void putVarint(std::vector<uint8_t> &out, uint32_t v);
+bool getVarint(const uint8_t *data, size_t size, size_t &pos, uint32_t &v);
+
+// Appends ticks to a Replay. Runs stay open until finishReplay flushes them.
+struct ReplayRecorder {
+    Replay replay;
+    uint32_t code[kMaxPlayers];
+    uint32_t run[kMaxPlayers];
+};
+
+// reserveTicks > 0 sizes the streams and checksums for that many ticks up front, so
+// recording them never allocates.
+void beginReplay(ReplayRecorder &rec, const std::string &map, const MatchState &match, uint32_t reserveTicks = 0);
+// Call after stepMatch with the inputs that tick consumed.
+void recordReplayTick(ReplayRecorder &rec, const PlayerInput inputs[], const MatchState &after);
+void finishReplay(ReplayRecorder &rec, const MatchState &final);
+
+// Walks a Replay tick by tick.
+struct ReplayCursor {
+    const Replay *replay = nullptr;
+    uint32_t tick = 0;
+    size_t pos[kMaxPlayers];
+    uint32_t remaining[kMaxPlayers];
+    uint32_t code[kMaxPlayers];
+};
+
+void startReplay(ReplayCursor &cursor, const Replay &replay);
+// Fills playerCount inputs for the next tick; false once the replay is exhausted or corrupt.
+bool nextReplayTick(ReplayCursor &cursor, PlayerInput inputs[]);
+// After stepping the tick just read: false if a stored checksum (periodic, or the final one
+// on the last tick) disagrees with match.
+bool checkReplayTick(const ReplayCursor &cursor, const MatchState &match);
+
+// Written to a temporary file and renamed, so a crash mid-save never leaves a broken replay.
+bool saveReplay(const std::string &path, const Replay &replay);
+// False for a truncated or corrupt file, or one naming a character or map the game cannot
+// have (a map outside maps/, a character index at or over kCharacterCount).
+bool loadReplay(const std::string &path, Replay &out);
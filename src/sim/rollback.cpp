@@ -0,0 +1,81 @@
+#include "sim/rollback.h"
+
+#include <cstring>
+#include "core/profiler.h"
+
+static inline uint32_t slotOf(uint32_t tick) { return tick & (kRollbackRing - 1); }
+
+void startRollback(RollbackSession &rb, const MatchState &match) {
+    rb.tick = 0;
+    rb.playerCount = match.server.playerCount;
+    rb.rollbackFrom = RollbackSession::kNoRollback;
+    rb.stats = RollbackStats{};
+    std::memset(rb.confirmedThrough, 0, sizeof(rb.confirmedThrough));
+    std::memset(rb.inputTick, 0, sizeof(rb.inputTick));
+    for (auto &slot : rb.inputs) {
+        for (auto &in : slot) in = PlayerInput{};
+    }
+    std::memcpy(&rb.states[0], &match, sizeof(MatchState));
+}
+
+uint32_t rollbackConfirmedTick(const RollbackSession &rb) {
+    uint32_t oldest = rb.confirmedThrough[0];
+    for (int p = 1; p < rb.playerCount; ++p) {
+        if (rb.confirmedThrough[p] < oldest) oldest = rb.confirmedThrough[p];
+    }
+    return oldest;
+}
+
+bool canAdvanceRollback(const RollbackSession &rb) {
+    return rb.tick - rollbackConfirmedTick(rb) < (uint32_t)kRollbackMaxTicks;
+}
+
+bool addRollbackInput(RollbackSession &rb, int player, uint32_t tick, const PlayerInput &input) {
+    if (player < 0 || player >= rb.playerCount) return false;
+    // Too old to correct, or so far ahead it would overwrite a slot still in use
+    if (tick + kRollbackMaxTicks < rb.tick || tick >= rb.tick + kRollbackRing - kRollbackMaxTicks) return false;
+    const uint32_t slot = slotOf(tick);
+    if (tick < rb.tick) {
+        // Already simulated on a prediction; only a different input costs a rollback
+        const PlayerInput &used = rb.inputs[slot][player];
+        bool same = used.moveX == input.moveX && used.moveZ == input.moveZ && used.buttons == input.buttons &&
+                    (!input.has(kButtonLook) || used.yaw == input.yaw);
+        if (!same && tick < rb.rollbackFrom) rb.rollbackFrom = tick;
+    }
+    rb.inputs[slot][player] = input;
+    rb.inputTick[slot][player] = tick + 1;
+    if (tick == rb.confirmedThrough[player]) rb.confirmedThrough[player] = tick + 1;
+    return true;
+}
+
+// Fills in predictions for tick t from tick t - 1 and steps it, saving the state first.
+static void simulateTick(RollbackSession &rb, MatchState &match, const MapData &map, uint32_t t, JobSystem *jobs) {
+    const uint32_t slot = slotOf(t);
+    const uint32_t prev = slotOf(t - 1);
+    for (int p = 0; p < rb.playerCount; ++p) {
+        if (rb.inputTick[slot][p] != t + 1) rb.inputs[slot][p] = t > 0 ? heldInput(rb.inputs[prev][p]) : PlayerInput{};
+    }
+    std::memcpy(&rb.states[slot], &match, sizeof(MatchState));
+    stepMatch(match, map, rb.inputs[slot], kFixedDt, jobs);
+}
+
+void resolveRollback(RollbackSession &rb, MatchState &match, const MapData &map, JobSystem *jobs) {
+    if (rb.rollbackFrom < rb.tick) {
+        PROFILE_ZONE("rollback");
+        const uint32_t from = rb.rollbackFrom;
+        std::memcpy(&match, &rb.states[slotOf(from)], sizeof(MatchState));
+        for (uint32_t t = from; t < rb.tick; ++t) simulateTick(rb, match, map, t, jobs);
+        int depth = (int)(rb.tick - from);
+        rb.stats.rollbacks++;
+        rb.stats.resimulatedTicks += (uint64_t)depth;
+        if (depth > rb.stats.maxDepth) rb.stats.maxDepth = depth;
+    }
+    rb.rollbackFrom = RollbackSession::kNoRollback;
+}
+
+void advanceRollback(RollbackSession &rb, MatchState &match, const MapData &map, JobSystem *jobs) {
+    resolveRollback(rb, match, map, jobs);
+    simulateTick(rb, match, map, rb.tick, jobs);
+    rb.tick++;
+    rb.stats.ticks++;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include "game/maps.h"
+#include "sim/sim.h"
+
+// GGPO-style rollback over the fixed tick. Every tick the session saves the MatchState it is
+// about to step (MatchState is plain data, so a save or restore is one memcpy) along with
+// the inputs it used. Inputs that have not arrived yet are predicted with heldInput(). When
+// a late input turns out to differ from its prediction, the next advance restores the
+// state from before that tick and re-simulates up to the present with the corrected inputs.
+//
+// The session never runs more than kRollbackMaxTicks ahead of the oldest unconfirmed input;
+// canAdvanceRollback() says when the caller has to wait (stall) instead. Sessions are large
+// (kRollbackRing full states), so allocate them on the heap or statically.
+
+constexpr int kRollbackMaxTicks = 8;
+constexpr int kRollbackRing = 16;      // power of two > kRollbackMaxTicks; also how far ahead inputs may arrive
+
+struct RollbackStats {
+    uint64_t ticks = 0;                 // ticks advanced
+    uint64_t rollbacks = 0;
+    uint64_t resimulatedTicks = 0;
+    int maxDepth = 0;                   // deepest single rollback, in ticks
+};
+
+struct RollbackSession {
+    uint32_t tick;                                      // ticks simulated; the next one to step
+    int playerCount;
+    uint32_t rollbackFrom;                              // earliest tick with a corrected input, or kNoRollback
+    uint32_t confirmedThrough[kMaxPlayers];             // ticks [0, n) have real input
+    MatchState states[kRollbackRing];                   // state before tick t, at t % kRollbackRing
+    PlayerInput inputs[kRollbackRing][kMaxPlayers];     // input used (or to use) for tick t
+    uint32_t inputTick[kRollbackRing][kMaxPlayers];     // t + 1 when inputs[..] holds real input for t
+    RollbackStats stats;
+
+    static constexpr uint32_t kNoRollback = 0xFFFFFFFFu;
+};
+
+void startRollback(RollbackSession &rb, const MatchState &match);
+
+// Supplies a player's real input for a tick; local inputs arrive for the current tick,
+// remote ones late or early. Inputs arrive in order per player. Returns false when the
+// tick is outside the window the session can still correct or buffer.
+bool addRollbackInput(RollbackSession &rb, int player, uint32_t tick, const PlayerInput &input);
+
+bool canAdvanceRollback(const RollbackSession &rb);
+
+// Rolls back and re-simulates if a prediction was wrong, then steps one new tick. jobs is
+// handed to stepMatch.
+void advanceRollback(RollbackSession &rb, MatchState &match, const MapData &map, JobSystem *jobs = nullptr);
+
+// Just the correction: brings match up to date with every input received so far without
+// stepping a new tick (e.g. to settle the final state once the last inputs are in).
+void resolveRollback(RollbackSession &rb, MatchState &match, const MapData &map, JobSystem *jobs = nullptr);
+
+// Oldest tick whose inputs are all confirmed, i.e. the state no rollback can change anymore.
+uint32_t rollbackConfirmedTick(const RollbackSession &rb);
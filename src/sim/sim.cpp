@@ -0,0 +1,255 @@
+#include "sim/sim.h"
+
+#include <cmath>
+#include "core/alloc_tracker.h"
+#include "core/hash.h"
+#include "core/job_system.h"
+#include "core/math.h"
+#include "core/profiler.h"
+#include "core/simd.h"
+#include "sim/hit_query.h"
+
+static const Vec3 kDuelSpawns[kDuelPlayers] = {
+    {-4.0f, 0.0f, 0.0f},
+    { 4.0f, 0.0f, 0.0f},
+};
+
+static const float kGravity = -22.0f;
+static const float kJumpVelocity = 8.5f;
+static const float kWalkSpeed = 5.0f;
+static const float kSprintMultiplier = 1.8f;
+static const float kArenaMargin = 1.0f;
+// Below this many players the movement pass is not worth handing out; above, jobs of about
+// kPlayersPerJob players each
+static const int kParallelMinPlayers = 64;
+static const int kPlayersPerJob = 32;
+
+// Per-tick scratch for the kernels; never part of the snapshotted match state.
+struct TickScratch {
+    alignas(32) float jump[kMaxPlayers];    // 1 when the player pressed jump this tick
+};
+
+void spawnPlayers(MatchState &match, const MapData &map) {
+    ServerState &s = match.server;
+    const int n = s.playerCount;
+    for (int i = 0; i < n; ++i) {
+        Vec3 p;
+        if (n <= map.spawnCount) {
+            // The map places everyone, on the floor
+            p = map.spawns[i];
+            p.y = 0.0f;
+        } else if (n == kDuelPlayers) {
+            p = kDuelSpawns[i];
+        } else {
+            // Free-for-all: spread evenly on an ellipse inside the arena, pulled in toward the
+            // centre past any obstacle in the way so nobody starts stuck inside one
+            float angle = 6.2831853f * (float)i / (float)n;
+            float radius = 0.4f;
+            p.y = 0.0f;
+            do {
+                p.x = cosf(angle) * map.arenaSize.x * radius;
+                p.z = sinf(angle) * map.arenaSize.z * radius;
+                radius -= 0.05f;
+            } while (radius > 0.0f && obstacleContainsPoint(map.obstacleGrid, map.obstacles, p));
+        }
+        s.setPosition(i, p);
+        s.velocityY[i] = 0.0f;
+        s.yawRadians[i] = 0.0f;
+        s.health[i] = 100;
+        s.attackCooldown[i] = 0.0f;
+        s.attackTimer[i] = 0.0f;
+    }
+}
+
+void resetMatch(MatchState &match, const MapData &map, int playerCount, const int characterIndices[]) {
+    match = MatchState{};
+    if (playerCount < kDuelPlayers) playerCount = kDuelPlayers;
+    if (playerCount > kMaxPlayers) playerCount = kMaxPlayers;
+    match.server.playerCount = playerCount;
+    for (int i = 0; i < playerCount; ++i) match.server.characterIndex[i] = characterIndices[i];
+    spawnPlayers(match, map);
+    match.targetScore = 3;
+    match.lastScorer = -1;
+    match.roundActive = true;
+}
+
+// Reads inputs, turns players toward their movement and resolves XZ movement against the
+// obstacle grid. Collision queries are per player, so this part stays scalar; each player
+// only touches its own lanes, so ranges of players can run on different threads.
+static void movePlayers(ServerState &s, const MapData &map, const PlayerInput inputs[], TickScratch &scratch, float dt,
+                        int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        const PlayerInput &input = inputs[i];
+        if (!s.alive(i)) {
+            scratch.jump[i] = 0.0f;
+            continue;
+        }
+        float dx = (float)input.moveX;
+        float dz = (float)input.moveZ;
+        if (input.has(kButtonLook)) {
+            // Look-relative: strafe along right = (cos, -sin), forward = (-sin, -cos)
+            float yaw = inputYawRadians(input.yaw);
+            float sy = sinf(yaw);
+            float cy = cosf(yaw);
+            s.yawRadians[i] = yaw;
+            float wx = dx * cy + dz * sy;
+            float wz = -dx * sy + dz * cy;
+            dx = wx;
+            dz = wz;
+        }
+        if (dx != 0.0f || dz != 0.0f) {
+            float inv = 1.0f / sqrtf(dx * dx + dz * dz);
+            dx *= inv;
+            dz *= inv;
+            // Rotate to movement direction
+            if (!input.has(kButtonLook)) s.yawRadians[i] = atan2f(-dx, -dz);
+        }
+        float speed = kWalkSpeed;
+        if (input.has(kButtonSprint)) speed *= kSprintMultiplier;
+        // Move in world plane XZ with simple obstacle collisions, one axis at a time
+        float nextX = s.posX[i] + dx * speed * dt;
+        if (!obstacleContainsPoint(map.obstacleGrid, map.obstacles, {nextX, s.posY[i], s.posZ[i]})) s.posX[i] = nextX;
+        float nextZ = s.posZ[i] + dz * speed * dt;
+        if (!obstacleContainsPoint(map.obstacleGrid, map.obstacles, {s.posX[i], s.posY[i], nextZ})) s.posZ[i] = nextZ;
+
+        scratch.jump[i] = input.has(kButtonJump) ? 1.0f : 0.0f;
+    }
+}
+
+static void moveKernel(ServerState &s, const MapData &map, const PlayerInput inputs[], TickScratch &scratch, float dt,
+                       JobSystem *jobs) {
+    PROFILE_ZONE("collision");
+    if (!jobs || s.playerCount < kParallelMinPlayers) {
+        movePlayers(s, map, inputs, scratch, dt, 0, s.playerCount);
+        return;
+    }
+    jobs->parallelFor(s.playerCount, kPlayersPerJob, [&](int begin, int end) {
+        AllocScope scope(AllocTag::Sim);
+        movePlayers(s, map, inputs, scratch, dt, begin, end);
+    });
+}
+
+// Jump/gravity; the arena floor (y = 0) is the only ground.
+static void gravityKernel(ServerState &s, const TickScratch &scratch, float dt) {
+    const F32x zero = simdSet(0.0f);
+    const F32x jumpVel = simdSet(kJumpVelocity);
+    const F32x gdt = simdSet(kGravity * dt);
+    const F32x vdt = simdSet(dt);
+    const int n = simdRoundUp(s.playerCount);
+    for (int i = 0; i < n; i += kSimdWidth) {
+        F32x y = simdLoad(&s.posY[i]);
+        F32x vy = simdLoad(&s.velocityY[i]);
+        F32x grounded = simdLessEq(y, zero);
+        y = simdSelect(grounded, zero, y);
+        F32x wantJump = simdAnd(grounded, simdGreater(simdLoad(&scratch.jump[i]), zero));
+        vy = simdSelect(wantJump, jumpVel, vy);
+        vy = vy + gdt;
+        y = y + vy * vdt;
+        F32x below = simdLess(y, zero);
+        y = simdSelect(below, zero, y);
+        vy = simdSelect(below, zero, vy);
+        simdStore(&s.posY[i], y);
+        simdStore(&s.velocityY[i], vy);
+    }
+}
+
+// Clamp to arena bounds.
+static void clampKernel(ServerState &s, const MapData &map) {
+    const F32x minX = simdSet(-map.arenaSize.x * 0.5f + kArenaMargin);
+    const F32x maxX = simdSet(map.arenaSize.x * 0.5f - kArenaMargin);
+    const F32x minZ = simdSet(-map.arenaSize.z * 0.5f + kArenaMargin);
+    const F32x maxZ = simdSet(map.arenaSize.z * 0.5f - kArenaMargin);
+    const int n = simdRoundUp(s.playerCount);
+    for (int i = 0; i < n; i += kSimdWidth) {
+        simdStore(&s.posX[i], simdMin(simdMax(simdLoad(&s.posX[i]), minX), maxX));
+        simdStore(&s.posZ[i], simdMin(simdMax(simdLoad(&s.posZ[i]), minZ), maxZ));
+    }
+}
+
+// Decays timers toward zero: used for both attack cooldowns and attack animations.
+static void decayKernel(float *values, int count, float dt) {
+    const F32x zero = simdSet(0.0f);
+    const F32x step = simdSet(dt);
+    const int n = simdRoundUp(count);
+    for (int i = 0; i < n; i += kSimdWidth) {
+        simdStore(&values[i], simdMax(simdLoad(&values[i]) - step, zero));
+    }
+}
+
+// Attack starts are rare, so this is a plain loop over players whose cooldown has expired.
+// All attacks started this tick are then resolved together by the hit-query batch.
+static void attackKernel(MatchState &match, const PlayerInput inputs[]) {
+    PROFILE_ZONE("combat");
+    ServerState &s = match.server;
+    if (!match.roundActive) return;
+    // Sized for the worst tick; one per thread since matches step concurrently in batch runs
+    static thread_local HitBatch batch;
+    batch.attackCount = 0;
+    for (int i = 0; i < s.playerCount; ++i) {
+        if (s.attackCooldown[i] > 0.0f || !s.alive(i)) continue;
+        const AttackDef *attack = nullptr;
+        if (inputs[i].has(kButtonLight)) attack = &kLightAttack;
+        else if (inputs[i].has(kButtonHeavy)) attack = &kHeavyAttack;
+        if (!attack) continue;
+        s.attackTimer[i] = attack->duration;
+        s.attackCooldown[i] = attack->cooldown;
+        batch.attacks[batch.attackCount++] = {i, attack};
+    }
+    resolveAttacks(s, batch);
+}
+
+void stepMatch(MatchState &match, const MapData &map, const PlayerInput inputs[], float dt, JobSystem *jobs) {
+    PROFILE_ZONE("tick");
+    ServerState &s = match.server;
+    TickScratch scratch;
+    for (int i = s.playerCount; i < simdRoundUp(s.playerCount); ++i) scratch.jump[i] = 0.0f;
+    match.matchOver = false;
+
+    moveKernel(s, map, inputs, scratch, dt, jobs);
+    gravityKernel(s, scratch, dt);
+    clampKernel(s, map);
+    decayKernel(s.attackCooldown, s.playerCount, dt);
+    attackKernel(match, inputs);
+    decayKernel(s.attackTimer, s.playerCount, dt);
+
+    // KO / round logic: the round ends when at most one fighter is left standing
+    if (match.roundActive) {
+        int aliveCount = 0;
+        int survivor = -1;
+        for (int i = 0; i < s.playerCount; ++i) {
+            if (s.alive(i)) { aliveCount++; survivor = i; }
+        }
+        if (aliveCount <= 1) {
+            match.lastScorer = (aliveCount == 1) ? survivor : -1;
+            if (match.lastScorer >= 0) match.playerScore[match.lastScorer]++;
+            match.koTimer = 2.0f;
+            match.roundActive = false;
+        }
+    } else {
+        match.koTimer -= dt;
+        if (match.koTimer <= 0.0f) {
+            // Respawn everyone
+            spawnPlayers(match, map);
+            match.roundActive = true;
+            // Match end
+            for (int i = 0; i < s.playerCount; ++i) {
+                if (match.playerScore[i] >= match.targetScore) match.matchOver = true;
+            }
+        }
+    }
+}
+
+uint64_t matchChecksum(const MatchState &match) {
+    const ServerState &s = match.server;
+    const size_t n = (size_t)s.playerCount;
+    uint64_t h = fnv1a(kFnvOffsetBasis, &s.playerCount, sizeof(s.playerCount));
+    const float *lanes[] = {s.posX, s.posY, s.posZ, s.velocityY, s.yawRadians, s.attackCooldown, s.attackTimer};
+    for (const float *lane : lanes) h = fnv1a(h, lane, sizeof(float) * n);
+    h = fnv1a(h, s.health, sizeof(int) * n);
+    h = fnv1a(h, s.characterIndex, sizeof(int) * n);
+    h = fnv1a(h, match.playerScore, sizeof(int) * n);
+    h = fnv1a(h, &match.koTimer, sizeof(match.koTimer));
+    h = fnv1a(h, &match.lastScorer, sizeof(match.lastScorer));
+    const unsigned char flags = (unsigned char)((match.roundActive ? 1 : 0) | (match.matchOver ? 2 : 0));
+    return fnv1a(h, &flags, 1);
+}
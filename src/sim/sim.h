@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include "core/types.h"
+#include "game/maps.h"
+
+class JobSystem;
+
+// Headless match simulation. Nothing in here touches raylib: the client, the batch
+// runner (epiCBattle_sim) and tests all drive the same tick through PlayerInput.
+
+constexpr int kDuelPlayers = 2;
+constexpr int kMaxPlayers = 256;
+constexpr int kDefaultFreeForAllPlayers = 64;
+constexpr float kFixedDt = 1.0f / 60.0f;
+
+enum InputButton : uint8_t {
+    kButtonSprint = 1 << 0,
+    kButtonJump = 1 << 1,
+    kButtonLight = 1 << 2,
+    kButtonHeavy = 1 << 3,
+    kButtonLook = 1 << 4,   // first person: face yaw, move relative to it
+};
+
+// Everything one player contributes to a single fixed tick. Without kButtonLook the move
+// axes are world X/Z and the fighter turns toward its movement; with it the fighter faces
+// yaw and moveX/moveZ are strafe/back relative to that (moveZ -1 is forward).
+struct PlayerInput {
+    int8_t moveX = 0;   // -1, 0 or 1
+    int8_t moveZ = 0;   // -1, 0 or 1
+    uint8_t buttons = 0;
+    uint16_t yaw = 0;   // 1/65536 turn; only meaningful with kButtonLook
+
+    bool has(InputButton b) const { return (buttons & b) != 0; }
+};
+
+static inline uint16_t quantizeInputYaw(float radians) {
+    float turns = radians * (1.0f / 6.2831853f);
+    return (uint16_t)(int32_t)floorf(turns * 65536.0f + 0.5f);
+}
+static inline float inputYawRadians(uint16_t yaw) { return (float)yaw * (6.2831853f / 65536.0f); }
+
+// What to assume for a tick whose real input has not arrived: keep moving and looking the
+// same way, but never repeat a one-shot press (jump, attacks).
+static inline PlayerInput heldInput(const PlayerInput &last) {
+    PlayerInput held = last;
+    held.buttons &= (uint8_t)(kButtonSprint | kButtonLook);
+    return held;
+}
+
+// Player state for up to kMaxPlayers combatants, structure-of-arrays so movement,
+// gravity, cooldowns and arena clamping run as SIMD kernels (see core/simd.h).
+// Arrays are full capacity and 32-byte aligned; lanes past playerCount are padding.
+struct ServerState {
+    int playerCount;
+    alignas(32) float posX[kMaxPlayers];
+    alignas(32) float posY[kMaxPlayers];
+    alignas(32) float posZ[kMaxPlayers];
+    alignas(32) float velocityY[kMaxPlayers];
+    alignas(32) float yawRadians[kMaxPlayers];
+    alignas(32) float attackCooldown[kMaxPlayers];
+    alignas(32) float attackTimer[kMaxPlayers];    // > 0 while an attack animation plays
+    int health[kMaxPlayers];
+    int characterIndex[kMaxPlayers];
+
+    Vec3 position(int i) const { return {posX[i], posY[i], posZ[i]}; }
+    void setPosition(int i, Vec3 p) { posX[i] = p.x; posY[i] = p.y; posZ[i] = p.z; }
+    bool attacking(int i) const { return attackTimer[i] > 0.0f; }
+    bool alive(int i) const { return health[i] > 0; }
+};
+
+// Full match state: the players plus rounds / scoring. Plain data, safe to memcpy.
+struct MatchState {
+    ServerState server;
+    int playerScore[kMaxPlayers];
+    int targetScore;
+    float koTimer;
+    int lastScorer;     // -1 when nobody scored the last round (e.g. a double KO)
+    bool roundActive;
+    bool matchOver;     // set on the tick the target score is reached; players already respawned
+
+    bool freeForAll() const { return server.playerCount > kDuelPlayers; }
+};
+
+void spawnPlayers(MatchState &match, const MapData &map);
+
+// Starts a fresh match. playerCount == 2 is the classic duel; larger counts are free-for-all.
+void resetMatch(MatchState &match, const MapData &map, int playerCount, const int characterIndices[]);
+
+// Advances the match by one fixed tick of length dt. inputs holds playerCount entries.
+// With jobs, large matches spread the per-player movement and collision pass over it; the
+// result is the same either way, bit for bit.
+void stepMatch(MatchState &match, const MapData &map, const PlayerInput inputs[], float dt, JobSystem *jobs = nullptr);
+
+// Hash of every live field (padding lanes excluded); equal states hash equal on any build.
+uint64_t matchChecksum(const MatchState &match);
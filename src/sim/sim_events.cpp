@@ -0,0 +1,22 @@
+#include "sim/sim_events.h"
+
+// Slower falls than this land without anything to show (a step off a low obstacle)
+static const float kLandMinSpeed = 4.0f;
+
+void collectSimEvents(const MatchState &before, const MatchState &after, SimEventList &events) {
+    const ServerState &a = before.server;
+    const ServerState &b = after.server;
+    if (a.playerCount != b.playerCount) return;
+    // Everyone respawned, standing, at full health
+    if (!before.roundActive && after.roundActive) return;
+    for (int i = 0; i < b.playerCount; ++i) {
+        if (b.health[i] > a.health[i]) continue;
+        const Vec3 position = b.position(i);
+        if (b.health[i] < a.health[i]) events.push_back({SimEventType::Hit, i, position, (float)(a.health[i] - b.health[i])});
+        if (a.alive(i) && !b.alive(i)) events.push_back({SimEventType::Knockout, i, position, 0.0f});
+        // Standing players have no vertical speed at all, see the gravity kernel
+        if (a.velocityY[i] < -kLandMinSpeed && b.velocityY[i] == 0.0f) {
+            events.push_back({SimEventType::Land, i, position, -a.velocityY[i]});
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include "core/fixed_vector.h"
+#include "core/types.h"
+#include "sim/sim.h"
+
+// Things worth showing that happened in a match: hits, landings and knockouts. They are read
+// off two states of the match instead of being reported by the tick, so effects built on them
+// can never feed back into the simulation, and the same code serves the local sim thread,
+// server snapshots and replays. before and after may be any number of ticks apart; whatever
+// happened in between comes out as at most one event of each kind per player.
+enum class SimEventType : uint8_t { Hit, Land, Knockout };
+
+struct SimEvent {
+    SimEventType type;
+    int player;
+    Vec3 position;      // the player's feet in after
+    float amount;       // Hit: health lost; Land: fall speed in m/s; Knockout: unused
+};
+
+// At most a hit, a knockout and a landing per player, so the list never fills up
+constexpr int kMaxSimEvents = 3 * kMaxPlayers;
+using SimEventList = FixedVector<SimEvent, kMaxSimEvents>;
+
+// Appends what happened between before and after. Nothing is reported across a respawn (a
+// new round, or a player's health going back up), nor between states of different matches.
+// Landings need velocityY, which snapshots do not carry, so online play only reports hits and
+// knockouts.
+void collectSimEvents(const MatchState &before, const MatchState &after, SimEventList &events);
@@ -0,0 +1,126 @@
+#include "sim/sim_thread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include "core/alloc_tracker.h"
+#include "core/profiler.h"
+
+// Further than any fighter can move in one tick (sprint is 9 m/s, a jump starts at 8.5 m/s)
+static const float kSnapDistance = 1.0f;
+static const float kPi = 3.14159265358979f;
+
+void SimThread::start(MatchState &match, RollbackSession &rollback, ReplayRecorder &recording, InputQueue &input,
+                      const MapData &map, BotSystem *bots, JobSystem *jobs) {
+    stop();
+    match_ = &match;
+    rollback_ = &rollback;
+    recording_ = &recording;
+    input_ = &input;
+    bots_ = bots;
+    jobs_ = jobs;
+    map_ = &map;
+    ticks_ = 0;
+    pressSeconds_ = 0.0;
+
+    // Frame 0: the current state with nothing to blend from, so the renderer has something at once
+    SimFrame &frame = frames_.writeSlot();
+    frame.match = match;
+    const ServerState &s = match.server;
+    std::memcpy(frame.prevX, s.posX, sizeof(frame.prevX));
+    std::memcpy(frame.prevY, s.posY, sizeof(frame.prevY));
+    std::memcpy(frame.prevZ, s.posZ, sizeof(frame.prevZ));
+    std::memcpy(frame.prevYaw, s.yawRadians, sizeof(frame.prevYaw));
+    frame.tick = 0;
+    frame.dueSeconds = startSeconds_ = inputClockSeconds();
+    frame.pressSeconds = 0.0;
+    frame.droppedTicks = 0;
+    frames_.publish();
+
+    stop_.store(false, std::memory_order_relaxed);
+    worker_ = std::thread([this]() { run(); });
+}
+
+void SimThread::stop() {
+    if (!worker_.joinable()) return;
+    stop_.store(true, std::memory_order_relaxed);
+    worker_.join();
+}
+
+float SimThread::alpha(const SimFrame &frame) const {
+    return std::clamp((float)((inputClockSeconds() - frame.dueSeconds) / kFixedDt), 0.0f, 1.0f);
+}
+
+void SimThread::run() {
+    profilerSetThreadName("sim");
+    double due = startSeconds_ + kFixedDt;
+    uint32_t dropped = 0;
+    while (!stop_.load(std::memory_order_relaxed)) {
+        double t = inputClockSeconds();
+        if (t < due) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(due - t));
+            continue;
+        }
+        // Bounded catch-up: run at most kMaxCatchUpTicks of the backlog, forget the rest
+        int behind = (int)((t - due) / kFixedDt) + 1;
+        if (behind > kMaxCatchUpTicks) {
+            due += (behind - kMaxCatchUpTicks) * (double)kFixedDt;
+            dropped += (uint32_t)(behind - kMaxCatchUpTicks);
+        }
+        while (due <= t && !match_->matchOver) {
+            tick(due, dropped);
+            due += kFixedDt;
+        }
+        // The final frame is published; the owner takes it from here
+        if (match_->matchOver) break;
+    }
+}
+
+void SimThread::tick(double due, uint32_t dropped) {
+    AllocScope scope(AllocTag::Sim);
+    // Exactly the events sampled up to this tick's deadline; later ones wait for later ticks
+    PlayerInput inputs[kMaxPlayers];
+    const int count = match_->server.playerCount;
+    double pressed = input_->take(due, inputs, count);
+    if (pressed > 0.0) pressSeconds_ = pressed;
+    if (bots_) {
+        AllocScope botScope(AllocTag::Bots);
+        bots_->think(*match_, inputs);
+    }
+
+    SimFrame &frame = frames_.writeSlot();
+    const ServerState &s = match_->server;
+    std::memcpy(frame.prevX, s.posX, sizeof(frame.prevX));
+    std::memcpy(frame.prevY, s.posY, sizeof(frame.prevY));
+    std::memcpy(frame.prevZ, s.posZ, sizeof(frame.prevZ));
+    std::memcpy(frame.prevYaw, s.yawRadians, sizeof(frame.prevYaw));
+
+    for (int i = 0; i < count; ++i) addRollbackInput(*rollback_, i, rollback_->tick, inputs[i]);
+    advanceRollback(*rollback_, *match_, *map_, jobs_);
+    recordReplayTick(*recording_, inputs, *match_);
+
+    frame.match = *match_;
+    frame.tick = ++ticks_;
+    frame.dueSeconds = due;
+    frame.pressSeconds = pressSeconds_;
+    frame.droppedTicks = dropped;
+    frames_.publish();
+}
+
+void interpolateFrame(const SimFrame &frame, float alpha, MatchState &out) {
+    out = frame.match;
+    ServerState &s = out.server;
+    for (int i = 0; i < s.playerCount; ++i) {
+        float dx = s.posX[i] - frame.prevX[i];
+        float dy = s.posY[i] - frame.prevY[i];
+        float dz = s.posZ[i] - frame.prevZ[i];
+        if (dx * dx + dy * dy + dz * dz > kSnapDistance * kSnapDistance) continue;
+        s.posX[i] = frame.prevX[i] + dx * alpha;
+        s.posY[i] = frame.prevY[i] + dy * alpha;
+        s.posZ[i] = frame.prevZ[i] + dz * alpha;
+        // Shortest way round
+        float dyaw = std::remainder(s.yawRadians[i] - frame.prevYaw[i], 2.0f * kPi);
+        s.yawRadians[i] = frame.prevYaw[i] + dyaw * alpha;
+    }
+}
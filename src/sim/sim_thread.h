@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "core/triple_buffer.h"
+#include "game/maps.h"
+#include "sim/bots.h"
+#include "sim/input_queue.h"
+#include "sim/replay.h"
+#include "sim/rollback.h"
+#include "sim/sim.h"
+
+// Most ticks run back to back when the sim has fallen behind real time. Anything past that
+// is dropped: after a hitch the match runs slow for a moment instead of spiralling into ever
+// longer catch-up bursts. Also used by the loops that still tick on the main thread.
+constexpr int kMaxCatchUpTicks = 4;
+
+// Published after every tick. Immutable once published; the render thread reads it while
+// the sim fills another slot.
+struct SimFrame {
+    MatchState match;                       // state after tick
+    // Player transforms one tick earlier, to blend from
+    alignas(32) float prevX[kMaxPlayers];
+    alignas(32) float prevY[kMaxPlayers];
+    alignas(32) float prevZ[kMaxPlayers];
+    alignas(32) float prevYaw[kMaxPlayers];
+    uint32_t tick;                          // ticks since start(); 0 is the starting state
+    double dueSeconds;                      // inputClockSeconds() this state stands for
+    double pressSeconds;                    // sample time of the newest press any tick so far took, 0 if none
+    uint32_t droppedTicks;                  // ticks skipped by the catch-up cap since start()
+};
+
+// Runs the local match's fixed tick (bots, rollback session, replay recording) on its own thread,
+// paced against inputClockSeconds(), and publishes a SimFrame per tick through a triple buffer.
+// Each tick takes the input events stamped up to its deadline from an InputQueue.
+// The render thread only ever reads frames, so its rate is independent of the 60 Hz tick.
+// Large (three frames), so allocate it on the heap.
+class SimThread {
+public:
+    SimThread() = default;
+    ~SimThread() { stop(); }
+    SimThread(const SimThread &) = delete;
+    SimThread &operator=(const SimThread &) = delete;
+
+    // Hands match, rollback, recording and bots to the worker until stop(), and makes it
+    // input's consumer; the caller must not touch them in between. map must stay loaded. bots
+    // may be null; otherwise it writes the inputs of its players each tick, over the queue's.
+    // jobs, if any, shares the tick's per-player work out (see stepMatch). Publishes the
+    // current state before returning.
+    void start(MatchState &match, RollbackSession &rollback, ReplayRecorder &recording, InputQueue &input,
+               const MapData &map, BotSystem *bots = nullptr, JobSystem *jobs = nullptr);
+    // Joins the worker; the objects passed to start() hold the final state afterwards.
+    void stop();
+    bool running() const { return worker_.joinable(); }
+
+    // Newest published frame; valid until the next call.
+    const SimFrame &latest() { return frames_.acquire(); }
+    // How far the present is past frame's due time, in ticks, clamped to [0, 1]: the blend
+    // factor from frame.prev* to frame.match (the accumulator alpha of a single-threaded loop).
+    float alpha(const SimFrame &frame) const;
+
+private:
+    void run();
+    void tick(double due, uint32_t dropped);
+
+    MatchState *match_ = nullptr;
+    RollbackSession *rollback_ = nullptr;
+    ReplayRecorder *recording_ = nullptr;
+    InputQueue *input_ = nullptr;
+    BotSystem *bots_ = nullptr;
+    JobSystem *jobs_ = nullptr;
+    const MapData *map_ = nullptr;
+    uint32_t ticks_ = 0;
+    double startSeconds_ = 0.0;
+    double pressSeconds_ = 0.0;
+
+    TripleBuffer<SimFrame> frames_;
+    std::atomic<bool> stop_{false};
+    std::thread worker_;
+};
+
+// Copies frame.match into out with player positions and yaws blended by alpha. Players who
+// moved further than a tick allows (respawns) snap instead of sliding across the arena.
+void interpolateFrame(const SimFrame &frame, float alpha, MatchState &out);
@@ -0,0 +1,518 @@
+// epiCBattle_sim: headless batch match runner.
+// Runs many scripted or random-input matches across all cores and reports
+// simulation throughput plus win/loss stats for balance testing. Can also record a match
+// to a replay file, or play replays back as a deterministic workload / desync check, either
+// straight or through a rollback session with late remote inputs. --alloc-check fails the
+// run when a tick allocates once the match has warmed up.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/alloc_tracker.h"
+#include "core/math.h"
+#include "core/profiler.h"
+#include "game/characters.h"
+#include "game/maps.h"
+#include "sim/bots.h"
+#include "sim/replay.h"
+#include "sim/rollback.h"
+#include "sim/sim.h"
+
+enum class Driver { Idle, Random, Chase, Bot };
+
+struct RunConfig {
+    int matches = 1000;
+    int maxTicks = 60 * 60 * 5;     // 5 minutes of game time per match
+    int threads = 0;                // 0 = hardware concurrency
+    uint32_t seed = 1;
+    std::string map = "green";         // name in maps/ or a .ebmap path
+    int players = kDuelPlayers;
+    Driver drivers[kDuelPlayers] = {Driver::Chase, Driver::Chase};
+    Driver othersDriver = Driver::Chase;    // players 3..N in free-for-all
+    int characters[kDuelPlayers] = {0, 0};
+    std::string recordPath;         // save match 0 as a replay
+    std::string replayPath;         // play this replay instead of generating matches
+    int repeat = 1;                 // replay passes
+    int rollbackDelay = -1;         // >= 0: replay through a rollback session, remote inputs this many ticks late
+    std::string tracePath;          // Chrome trace of the run's last zones
+    bool allocCheck = false;        // fail if a tick allocates after kAllocWarmupTicks
+};
+
+// Ticks a match may spend growing buffers to their working size (flow fields, hit lists,
+// rollback history) before --alloc-check starts counting
+static const int kAllocWarmupTicks = 120;
+
+struct MatchResult {
+    int winner = -1;        // -1 if the tick limit was hit first
+    int ticks = 0;
+    int rounds = 0;
+    uint64_t allocations = 0;   // made by ticks past kAllocWarmupTicks
+};
+
+// Counts what the ticks after warm-up allocate on the calling thread
+struct TickAllocations {
+    uint64_t start = 0;
+
+    void begin() { start = allocThreadCounts().allocations; }
+    void end(int tick, uint64_t &total) const {
+        if (tick >= kAllocWarmupTicks) total += allocThreadCounts().allocations - start;
+    }
+};
+
+// The --alloc-check verdict; false (and a message) if any tick past warm-up allocated
+static bool reportAllocations(const RunConfig &cfg, uint64_t allocations) {
+    if (!cfg.allocCheck) return true;
+    if (allocations == 0) {
+        std::printf("allocations:    none after %d warm-up ticks\n", kAllocWarmupTicks);
+        return true;
+    }
+    std::printf("ALLOCATED:      %llu heap allocations after %d warm-up ticks\n", (unsigned long long)allocations, kAllocWarmupTicks);
+    return false;
+}
+
+// xorshift32; one generator per match so results do not depend on thread scheduling
+struct Rng {
+    uint32_t state;
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+static PlayerInput driveRandom(Rng &rng, PlayerInput previous) {
+    // Hold a direction for a while rather than jittering every tick
+    PlayerInput in = previous;
+    in.buttons &= kButtonSprint;
+    if (rng.next() % 12 == 0) {
+        in.moveX = (int8_t)((int)(rng.next() % 3) - 1);
+        in.moveZ = (int8_t)((int)(rng.next() % 3) - 1);
+        in.buttons = (rng.next() % 4 == 0) ? kButtonSprint : 0;
+    }
+    uint32_t r = rng.next() % 64;
+    if (r == 0) in.buttons |= kButtonJump;
+    else if (r < 4) in.buttons |= kButtonLight;
+    else if (r < 6) in.buttons |= kButtonHeavy;
+    return in;
+}
+
+static PlayerInput driveChase(Rng &rng, const MatchState &match, int self) {
+    PlayerInput in;
+    const ServerState &s = match.server;
+    // Chase the nearest living opponent
+    Vec3 me = s.position(self);
+    int target = -1;
+    float best = 1e30f;
+    for (int j = 0; j < s.playerCount; ++j) {
+        if (j == self || !s.alive(j)) continue;
+        float d = vec3Distance(me, s.position(j));
+        if (d < best) { best = d; target = j; }
+    }
+    if (target < 0) return in;
+    Vec3 them = s.position(target);
+    float dx = them.x - me.x;
+    float dz = them.z - me.z;
+    const float deadZone = 0.5f;
+    if (dx > deadZone) in.moveX = 1; else if (dx < -deadZone) in.moveX = -1;
+    if (dz > deadZone) in.moveZ = 1; else if (dz < -deadZone) in.moveZ = -1;
+    float d = best;
+    if (d > 6.0f) in.buttons |= kButtonSprint;
+    if (d <= 2.5f && rng.next() % 3 == 0) in.buttons |= (rng.next() % 4 == 0) ? kButtonHeavy : kButtonLight;
+    // Hop over obstacles occasionally when stuck
+    if (rng.next() % 90 == 0) in.buttons |= kButtonJump;
+    return in;
+}
+
+static bool openMap(const std::string &name, GameMap &out) {
+    if (out.open(mapFilePath(name))) return true;
+    std::fprintf(stderr, "could not open map '%s' (%s)\n", name.c_str(), mapFilePath(name).c_str());
+    return false;
+}
+
+static MatchResult runMatch(const RunConfig &cfg, const GameMap &arena, int matchIndex, ReplayRecorder *recorder) {
+    const MapData &map = arena.data();
+    MatchResult result;
+    Rng rng{cfg.seed * 2654435761u + (uint32_t)matchIndex * 40503u + 1u};
+    MatchState match;
+    int characters[kMaxPlayers];
+    for (int i = 0; i < cfg.players; ++i) characters[i] = cfg.characters[i % kDuelPlayers];
+    resetMatch(match, map, cfg.players, characters);
+    // Under --alloc-check the recorder is counted with the tick, so it reserves the whole match
+    if (recorder) beginReplay(*recorder, arena.name(), match, cfg.allocCheck ? (uint32_t)cfg.maxTicks : 0);
+    bool isBot[kMaxPlayers] = {};
+    bool anyBots = false;
+    for (int i = 0; i < cfg.players; ++i) {
+        isBot[i] = ((i < kDuelPlayers) ? cfg.drivers[i] : cfg.othersDriver) == Driver::Bot;
+        anyBots = anyBots || isBot[i];
+    }
+    std::unique_ptr<BotSystem> bots;
+    if (anyBots) {
+        bots.reset(new BotSystem);
+        bots->reset(map, cfg.players, isBot, rng.next());
+    }
+    PlayerInput inputs[kMaxPlayers];
+    TickAllocations counter;
+    for (int tick = 0; tick < cfg.maxTicks; ++tick) {
+        counter.begin();
+        for (int i = 0; i < cfg.players; ++i) {
+            Driver driver = (i < kDuelPlayers) ? cfg.drivers[i] : cfg.othersDriver;
+            switch (driver) {
+                case Driver::Idle: inputs[i] = PlayerInput{}; break;
+                case Driver::Random: inputs[i] = driveRandom(rng, inputs[i]); break;
+                case Driver::Chase: inputs[i] = driveChase(rng, match, i); break;
+                case Driver::Bot: break;
+            }
+        }
+        if (bots) bots->think(match, inputs);
+        bool wasActive = match.roundActive;
+        stepMatch(match, map, inputs, kFixedDt);
+        if (recorder) recordReplayTick(*recorder, inputs, match);
+        counter.end(tick, result.allocations);
+        result.ticks = tick + 1;
+        if (wasActive && !match.roundActive) result.rounds++;
+        if (match.matchOver) {
+            for (int i = 0; i < cfg.players; ++i) {
+                if (match.playerScore[i] >= match.targetScore) result.winner = i;
+            }
+            break;
+        }
+    }
+    if (recorder) finishReplay(*recorder, match);
+    return result;
+}
+
+enum class ReplayEnd { Matched, Desync, Truncated };
+
+// Plays a replay start to finish, checking the stored checksums. result.ticks is how many
+// ticks played: on Desync the state after the last of them differs from the recording, on
+// Truncated the inputs ran out after it.
+static ReplayEnd playReplay(const Replay &replay, const MapData &map, MatchResult &result) {
+    MatchState match;
+    resetMatch(match, map, replay.playerCount, replay.characterIndex);
+    ReplayCursor cursor;
+    startReplay(cursor, replay);
+    PlayerInput inputs[kMaxPlayers];
+    TickAllocations counter;
+    for (;;) {
+        counter.begin();
+        if (!nextReplayTick(cursor, inputs)) break;
+        bool wasActive = match.roundActive;
+        stepMatch(match, map, inputs, replay.tickDt());
+        counter.end((int)cursor.tick, result.allocations);
+        result.ticks = (int)cursor.tick;
+        if (!checkReplayTick(cursor, match)) return ReplayEnd::Desync;
+        if (wasActive && !match.roundActive) result.rounds++;
+        if (match.matchOver) {
+            for (int i = 0; i < replay.playerCount; ++i) {
+                if (match.playerScore[i] >= match.targetScore) result.winner = i;
+            }
+        }
+    }
+    result.ticks = (int)cursor.tick;
+    return cursor.tick == replay.tickCount ? ReplayEnd::Matched : ReplayEnd::Truncated;
+}
+
+static int runReplay(const RunConfig &cfg, int threadCount) {
+    Replay replay;
+    if (!loadReplay(cfg.replayPath, replay)) {
+        std::fprintf(stderr, "could not load replay '%s'\n", cfg.replayPath.c_str());
+        return 2;
+    }
+    GameMap arena;
+    if (!openMap(replay.map, arena)) return 2;
+    const MapData &map = arena.data();
+    std::vector<MatchResult> results(cfg.repeat);
+    std::vector<ReplayEnd> ends(cfg.repeat, ReplayEnd::Matched);
+    std::atomic<int> nextPass{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&]() {
+            profilerSetThreadName("sim worker");
+            for (;;) {
+                int p = nextPass.fetch_add(1, std::memory_order_relaxed);
+                if (p >= cfg.repeat) break;
+                ends[p] = playReplay(replay, map, results[p]);
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long totalTicks = 0;
+    for (const auto &r : results) totalTicks += r.ticks;
+    double ticksPerSec = seconds > 0.0 ? (double)totalTicks / seconds : 0.0;
+    size_t bytes = 0;
+    for (const auto &stream : replay.streams) bytes += stream.size();
+    std::printf("replay:         %s (%u ticks, %d players, %zu input bytes)\n", cfg.replayPath.c_str(), replay.tickCount,
+                replay.playerCount, bytes);
+    std::printf("passes:         %d (%d threads)\n", cfg.repeat, threadCount);
+    std::printf("wall time:      %.3f s\n", seconds);
+    std::printf("ticks/sec:      %.0f (%.0fx real time)\n", ticksPerSec, ticksPerSec * replay.tickDt());
+    if (results[0].winner >= 0) std::printf("winner:         P%d after %d rounds\n", results[0].winner + 1, results[0].rounds);
+    else std::printf("winner:         none after %d rounds\n", results[0].rounds);
+    for (int p = 0; p < cfg.repeat; ++p) {
+        if (ends[p] == ReplayEnd::Desync) {
+            std::printf("DESYNC:         pass %d diverged by tick %d\n", p, results[p].ticks);
+            return 1;
+        }
+        if (ends[p] == ReplayEnd::Truncated) {
+            std::printf("TRUNCATED:      pass %d ran out of inputs after tick %d of %u\n", p, results[p].ticks, replay.tickCount);
+            return 1;
+        }
+    }
+    std::printf("checksums:      %zu verified\n", replay.checksums.size());
+    uint64_t allocations = 0;
+    for (const auto &r : results) allocations += r.allocations;
+    return reportAllocations(cfg, allocations) ? 0 : 1;
+}
+
+// Plays a replay as a rollback peer would see it: player 1 is local, every other player's
+// input arrives delay ticks late, so those ticks run on predictions and get corrected. The
+// confirmed states must still match the replay's checksums exactly.
+static int runRollback(const RunConfig &cfg) {
+    Replay replay;
+    if (!loadReplay(cfg.replayPath, replay)) {
+        std::fprintf(stderr, "could not load replay '%s'\n", cfg.replayPath.c_str());
+        return 2;
+    }
+    GameMap arena;
+    if (!openMap(replay.map, arena)) return 2;
+    const MapData &map = arena.data();
+    const int players = replay.playerCount;
+    const uint32_t delay = (uint32_t)cfg.rollbackDelay;
+    std::vector<PlayerInput> inputs((size_t)replay.tickCount * players);
+    ReplayCursor cursor;
+    startReplay(cursor, replay);
+    for (uint32_t t = 0; t < replay.tickCount; ++t) {
+        if (!nextReplayTick(cursor, &inputs[(size_t)t * players])) {
+            std::fprintf(stderr, "replay '%s' is truncated\n", cfg.replayPath.c_str());
+            return 2;
+        }
+    }
+
+    MatchState match;
+    resetMatch(match, map, players, replay.characterIndex);
+    std::unique_ptr<RollbackSession> rb(new RollbackSession);
+    startRollback(*rb, match);
+    uint32_t delivered = 0;         // remote inputs handed over for ticks [0, delivered)
+    uint32_t checked = 0;
+    uint32_t desyncTick = 0;
+    auto deliverRemote = [&](uint32_t upTo) {
+        for (; delivered < upTo; ++delivered) {
+            for (int p = 1; p < players; ++p) addRollbackInput(*rb, p, delivered, inputs[(size_t)delivered * players + p]);
+        }
+    };
+    // Confirmed state before tick c is the state after tick c - 1, which the checksums cover
+    auto checkConfirmed = [&]() {
+        uint32_t c = rollbackConfirmedTick(*rb);
+        for (; checked + kReplayChecksumInterval <= c; checked += kReplayChecksumInterval) {
+            uint32_t t = checked + kReplayChecksumInterval;
+            const MatchState &state = (t == rb->tick) ? match : rb->states[t % kRollbackRing];
+            size_t slot = t / kReplayChecksumInterval - 1;
+            if (slot < replay.checksums.size() && replay.checksums[slot] != matchChecksum(state) && !desyncTick) desyncTick = t;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    TickAllocations counter;
+    uint64_t allocations = 0;
+    for (uint32_t t = 0; t < replay.tickCount; ++t) {
+        counter.begin();
+        addRollbackInput(*rb, 0, t, inputs[(size_t)t * players]);
+        if (t >= delay) deliverRemote(t - delay + 1);
+        advanceRollback(*rb, match, map);
+        counter.end((int)t, allocations);
+        checkConfirmed();
+    }
+    deliverRemote(replay.tickCount);
+    resolveRollback(*rb, match, map);
+    checkConfirmed();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const RollbackStats &st = rb->stats;
+    std::printf("replay:         %s (%u ticks, %d players)\n", cfg.replayPath.c_str(), replay.tickCount, players);
+    std::printf("remote delay:   %u ticks\n", delay);
+    std::printf("rollbacks:      %llu (%.1f%% of ticks), %llu ticks re-simulated, deepest %d\n", (unsigned long long)st.rollbacks,
+                100.0 * (double)st.rollbacks / (double)(st.ticks ? st.ticks : 1), (unsigned long long)st.resimulatedTicks, st.maxDepth);
+    std::printf("wall time:      %.3f s (%.2f us per tick incl. re-simulation)\n", seconds, seconds * 1e6 / (replay.tickCount ? replay.tickCount : 1));
+    if (desyncTick) {
+        std::printf("DESYNC:         confirmed state diverged by tick %u\n", desyncTick);
+        return 1;
+    }
+    if (matchChecksum(match) != replay.finalChecksum) {
+        std::printf("DESYNC:         final state differs\n");
+        return 1;
+    }
+    std::printf("checksums:      %zu + final verified\n", replay.checksums.size());
+    return reportAllocations(cfg, allocations) ? 0 : 1;
+}
+
+static bool parseDriver(const char *s, Driver &out) {
+    if (std::strcmp(s, "idle") == 0) out = Driver::Idle;
+    else if (std::strcmp(s, "random") == 0) out = Driver::Random;
+    else if (std::strcmp(s, "chase") == 0) out = Driver::Chase;
+    else if (std::strcmp(s, "bot") == 0) out = Driver::Bot;
+    else return false;
+    return true;
+}
+
+static void printUsage() {
+    std::printf(
+        "usage: epiCBattle_sim [options]\n"
+        "  --matches N        number of matches to run (default 1000)\n"
+        "  --ticks N          tick limit per match (default 18000)\n"
+        "  --threads N        worker threads (default: all cores)\n"
+        "  --seed N           base RNG seed (default 1)\n"
+        "  --map NAME         map in maps/ or a .ebmap path (default green)\n"
+        "  --p1 DRIVER        idle|random|chase|bot (default chase)\n"
+        "  --p2 DRIVER        idle|random|chase|bot (default chase)\n"
+        "  --players N        2 = duel, 3..256 = free-for-all (default 2)\n"
+        "  --others DRIVER    driver for players 3..N: idle|random|chase|bot (default chase)\n"
+        "  --chars A,B        character indices for P1/P2 (default 0,0)\n"
+        "  --record FILE      save match 0 as a replay\n"
+        "  --replay FILE      play a replay instead (verifies its checksums)\n"
+        "  --repeat N         replay passes, for timing (default 1)\n"
+        "  --rollback N       replay through a rollback session, remote inputs N ticks late (0..7)\n"
+        "  --trace FILE       profile the run and write a Chrome trace_event JSON\n"
+        "  --alloc-check      fail if a tick, recording included, allocates after the first %d (warm-up)\n", kAllocWarmupTicks);
+}
+
+static bool parseArgs(int argc, char **argv, RunConfig &cfg) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto need = [&]() {
+            if (!value) { std::fprintf(stderr, "missing value for %s\n", arg); return false; }
+            ++i;
+            return true;
+        };
+        if (std::strcmp(arg, "--matches") == 0) { if (!need()) return false; cfg.matches = std::atoi(value); }
+        else if (std::strcmp(arg, "--ticks") == 0) { if (!need()) return false; cfg.maxTicks = std::atoi(value); }
+        else if (std::strcmp(arg, "--threads") == 0) { if (!need()) return false; cfg.threads = std::atoi(value); }
+        else if (std::strcmp(arg, "--seed") == 0) { if (!need()) return false; cfg.seed = (uint32_t)std::strtoul(value, nullptr, 10); }
+        else if (std::strcmp(arg, "--map") == 0) { if (!need()) return false; cfg.map = value; }
+        else if (std::strcmp(arg, "--p1") == 0 || std::strcmp(arg, "--p2") == 0) {
+            if (!need()) return false;
+            int slot = (arg[3] == '1') ? 0 : 1;
+            if (!parseDriver(value, cfg.drivers[slot])) { std::fprintf(stderr, "unknown driver '%s'\n", value); return false; }
+        }
+        else if (std::strcmp(arg, "--players") == 0) { if (!need()) return false; cfg.players = std::atoi(value); }
+        else if (std::strcmp(arg, "--others") == 0) {
+            if (!need()) return false;
+            if (!parseDriver(value, cfg.othersDriver)) { std::fprintf(stderr, "unknown driver '%s'\n", value); return false; }
+        }
+        else if (std::strcmp(arg, "--chars") == 0) {
+            if (!need()) return false;
+            if (std::sscanf(value, "%d,%d", &cfg.characters[0], &cfg.characters[1]) != 2) { std::fprintf(stderr, "bad --chars '%s'\n", value); return false; }
+        }
+        else if (std::strcmp(arg, "--record") == 0) { if (!need()) return false; cfg.recordPath = value; }
+        else if (std::strcmp(arg, "--replay") == 0) { if (!need()) return false; cfg.replayPath = value; }
+        else if (std::strcmp(arg, "--repeat") == 0) { if (!need()) return false; cfg.repeat = std::atoi(value); }
+        else if (std::strcmp(arg, "--rollback") == 0) { if (!need()) return false; cfg.rollbackDelay = std::atoi(value); }
+        else if (std::strcmp(arg, "--trace") == 0) { if (!need()) return false; cfg.tracePath = value; }
+        else if (std::strcmp(arg, "--alloc-check") == 0) cfg.allocCheck = true;
+        else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) { printUsage(); std::exit(0); }
+        else { std::fprintf(stderr, "unknown option '%s'\n", arg); return false; }
+    }
+    if (cfg.players < kDuelPlayers || cfg.players > kMaxPlayers) { std::fprintf(stderr, "--players must be in 2..%d\n", kMaxPlayers); return false; }
+    if (cfg.rollbackDelay >= kRollbackMaxTicks || (cfg.rollbackDelay >= 0 && cfg.replayPath.empty())) {
+        std::fprintf(stderr, "--rollback needs --replay and a delay below %d\n", kRollbackMaxTicks);
+        return false;
+    }
+    if (cfg.matches < 1 || cfg.maxTicks < 1 || cfg.repeat < 1) { std::fprintf(stderr, "--matches, --ticks and --repeat must be positive\n"); return false; }
+    for (int c : cfg.characters) {
+        if (c < 0 || c >= kCharacterCount) { std::fprintf(stderr, "--chars must be in 0..%d\n", kCharacterCount - 1); return false; }
+    }
+    return true;
+}
+
+static int runBatch(const RunConfig &cfg, int threadCount) {
+    GameMap map;
+    if (!openMap(cfg.map, map)) return 2;
+    std::vector<MatchResult> results(cfg.matches);
+    std::atomic<int> nextMatch{0};
+    ReplayRecorder recording;
+    ReplayRecorder *recorder = cfg.recordPath.empty() ? nullptr : &recording;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&]() {
+            profilerSetThreadName("sim worker");
+            for (;;) {
+                int m = nextMatch.fetch_add(1, std::memory_order_relaxed);
+                if (m >= cfg.matches) break;
+                results[m] = runMatch(cfg, map, m, m == 0 ? recorder : nullptr);
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long totalTicks = 0;
+    long long totalRounds = 0;
+    std::vector<int> wins(cfg.players, 0);
+    int unfinished = 0;
+    uint64_t allocations = 0;
+    for (const auto &r : results) {
+        allocations += r.allocations;
+        totalTicks += r.ticks;
+        totalRounds += r.rounds;
+        if (r.winner >= 0) wins[r.winner]++; else unfinished++;
+    }
+    double ticksPerSec = seconds > 0.0 ? (double)totalTicks / seconds : 0.0;
+
+    std::printf("matches:        %d (%d players, %d threads)\n", cfg.matches, cfg.players, threadCount);
+    std::printf("ticks:          %lld (%.1f s game time)\n", totalTicks, totalTicks * (double)kFixedDt);
+    std::printf("wall time:      %.3f s\n", seconds);
+    std::printf("ticks/sec:      %.0f (%.0fx real time)\n", ticksPerSec, ticksPerSec * kFixedDt);
+    std::printf("P1 wins:        %d (%.1f%%)\n", wins[0], 100.0 * wins[0] / cfg.matches);
+    std::printf("P2 wins:        %d (%.1f%%)\n", wins[1], 100.0 * wins[1] / cfg.matches);
+    if (cfg.players > kDuelPlayers) {
+        int others = 0;
+        for (int i = kDuelPlayers; i < cfg.players; ++i) others += wins[i];
+        std::printf("other wins:     %d (%.1f%%)\n", others, 100.0 * others / cfg.matches);
+    }
+    std::printf("unfinished:     %d\n", unfinished);
+    std::printf("avg rounds:     %.2f\n", (double)totalRounds / cfg.matches);
+    std::printf("avg match len:  %.1f s\n", (double)totalTicks * kFixedDt / cfg.matches);
+    if (recorder) {
+        bool saved = saveReplay(cfg.recordPath, recorder->replay);
+        if (saved) std::printf("recorded:       %s (match 0, %u ticks)\n", cfg.recordPath.c_str(), recorder->replay.tickCount);
+        else std::fprintf(stderr, "could not write replay '%s'\n", cfg.recordPath.c_str());
+        if (!saved) return 1;
+    }
+    return reportAllocations(cfg, allocations) ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    RunConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        printUsage();
+        return 2;
+    }
+    int threadCount = cfg.threads > 0 ? cfg.threads : (int)std::thread::hardware_concurrency();
+    if (threadCount < 1) threadCount = 1;
+    if (!cfg.tracePath.empty()) profilerSetEnabled(true);
+    int status;
+    if (cfg.rollbackDelay >= 0) status = runRollback(cfg);
+    else if (!cfg.replayPath.empty()) status = runReplay(cfg, threadCount);
+    else status = runBatch(cfg, threadCount);
+    if (!cfg.tracePath.empty()) {
+        // Each thread's ring keeps its most recent zones; that is the tail of the run
+        if (profilerWriteChromeTrace(cfg.tracePath, 1e9)) std::printf("trace:          %s\n", cfg.tracePath.c_str());
+        else std::fprintf(stderr, "could not write trace '%s'\n", cfg.tracePath.c_str());
+    }
+    return status;
+}
@@ -0,0 +1,70 @@
+// epiCBattle_mapbake: converts text map descriptions (maps/*.txt) into .ebmap files.
+// Usage: epiCBattle_mapbake [--out DIR] [--no-grid] map.txt ...
+//
+// Each output is named after its source (maps/desert.txt -> DIR/desert.ebmap) and carries
+// the obstacle broadphase grid precomputed, so loading a map is a memory map and nothing
+// else. --no-grid leaves it out (the loader then builds it) for comparing the two.
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "game/map_file.h"
+
+namespace fs = std::filesystem;
+
+static bool bakeOne(const std::string &textPath, const fs::path &outDir, bool withGrid) {
+    std::ifstream in(textPath, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "mapbake: cannot read %s\n", textPath.c_str());
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    MapSource source;
+    std::string error;
+    if (!parseMapText(text.str(), source, error)) {
+        std::fprintf(stderr, "mapbake: %s: %s\n", textPath.c_str(), error.c_str());
+        return false;
+    }
+    std::string out = (outDir / fs::path(textPath).stem()).string() + kMapFileExtension;
+    if (!writeMapFile(out, source, withGrid)) {
+        std::fprintf(stderr, "mapbake: could not write %s\n", out.c_str());
+        return false;
+    }
+    std::error_code ec;
+    std::printf("mapbake: %s -> %s (%zu obstacles, %zu spawns, %llu bytes%s)\n", textPath.c_str(), out.c_str(),
+                source.obstacles.size(), source.spawns.size(), (unsigned long long)fs::file_size(out, ec),
+                withGrid ? "" : ", no grid");
+    return true;
+}
+
+int main(int argc, char **argv) {
+    fs::path outDir = kMapDirectory;
+    bool withGrid = true;
+    std::vector<std::string> sources;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) outDir = argv[++i];
+        else if (std::strcmp(argv[i], "--no-grid") == 0) withGrid = false;
+        else if (argv[i][0] == '-') {
+            std::fprintf(stderr, "usage: epiCBattle_mapbake [--out DIR] [--no-grid] map.txt ...\n");
+            return 2;
+        } else {
+            sources.push_back(argv[i]);
+        }
+    }
+    if (sources.empty()) {
+        std::fprintf(stderr, "usage: epiCBattle_mapbake [--out DIR] [--no-grid] map.txt ...\n");
+        return 2;
+    }
+    std::error_code ec;
+    fs::create_directories(outDir, ec);
+    int failed = 0;
+    for (const auto &source : sources) {
+        if (!bakeOne(source, outDir, withGrid)) failed++;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+// epiCBattle_bake: converts character glTFs into .ebmdl model caches.
+// Usage: epiCBattle_bake [scene.gltf ...]   (no arguments bakes every entry in kCharacters)
+//
+// Uses raylib's own glTF loader so the baked streams are exactly what LoadModel would
+// upload; that needs a GL context, so a hidden window is opened. Each indexed mesh also
+// gets up to kMaxModelLods - 1 simplified index streams for distance-based LOD, then every
+// index stream is reordered for the vertex cache, the vertices for fetch locality, and the
+// vertex streams are quantized (see assets/model_cache.h for the formats).
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "raylib.h"
+#include "assets/mesh_optimize.h"
+#include "assets/mesh_simplify.h"
+#include "assets/model_cache.h"
+#include "game/characters.h"
+
+// Fraction of LOD 0's indices each level aims for, and the largest deviation (relative to
+// the mesh size) a level may introduce to get there
+static const float kLodIndexRatio[kMaxModelLods - 1] = {0.5f, 0.2f, 0.06f};
+static const float kLodMaxError = 0.05f;
+
+// One mesh's streams while it is being optimized; BakedMesh points into these
+struct MeshStreams {
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> texcoords;
+    std::vector<unsigned char> colors;
+    std::vector<unsigned short> indices;
+    std::array<std::vector<unsigned short>, kMaxModelLods - 1> lods;
+    int lodCount = 0;
+    std::vector<uint16_t> quantizedPositions;
+    std::vector<int16_t> octNormals;
+    std::vector<uint16_t> halfTexcoords;
+};
+
+// Before/after totals for the report
+struct BakeReport {
+    size_t rawVertexBytes = 0;
+    size_t vertexBytes = 0;
+    size_t indexBytes = 0;
+    size_t lodIndexBytes = 0;
+    double missesBefore = 0.0;
+    double missesAfter = 0.0;
+    int cachedTriangles = 0;
+    int lodTriangles[kMaxModelLods] = {};
+};
+
+template <typename T>
+static std::vector<T> copyStream(const T *data, size_t count) {
+    return data ? std::vector<T>(data, data + count) : std::vector<T>();
+}
+
+// Fills s.lods. A level is dropped once the error budget stops it from getting meaningfully
+// smaller than the one before.
+static void buildLods(MeshStreams &s, int vertexCount) {
+    const int indexCount = (int)s.indices.size();
+    int previous = indexCount;
+    for (int l = 0; l < kMaxModelLods - 1; ++l) {
+        int target = (int)(indexCount * kLodIndexRatio[l]) / 3 * 3;
+        s.lods[l] = simplifyMesh(s.indices.data(), indexCount, s.positions.data(), vertexCount, target, kLodMaxError);
+        if (s.lods[l].empty() || (int)s.lods[l].size() > previous * 8 / 10) {
+            s.lods[l].clear();
+            break;
+        }
+        previous = (int)s.lods[l].size();
+        s.lodCount = l + 1;
+    }
+}
+
+// Vertex-cache order for every index stream, then one vertex order (first use in LOD 0,
+// which references every vertex the LODs do) applied to all of them
+static void optimizeOrder(MeshStreams &s, int vertexCount, BakeReport &report) {
+    const int indexCount = (int)s.indices.size();
+    report.missesBefore += vertexCacheMissRatio(s.indices.data(), indexCount, vertexCount) * (indexCount / 3);
+    optimizeVertexCache(s.indices.data(), indexCount, vertexCount);
+    for (int l = 0; l < s.lodCount; ++l) optimizeVertexCache(s.lods[l].data(), (int)s.lods[l].size(), vertexCount);
+
+    std::vector<unsigned short> remap = vertexFetchRemap(s.indices.data(), indexCount, vertexCount);
+    remapIndices(s.indices.data(), indexCount, remap);
+    for (int l = 0; l < s.lodCount; ++l) remapIndices(s.lods[l].data(), (int)s.lods[l].size(), remap);
+    remapVertices(s.positions.data(), vertexCount, sizeof(float) * 3, remap);
+    if (!s.normals.empty()) remapVertices(s.normals.data(), vertexCount, sizeof(float) * 3, remap);
+    if (!s.texcoords.empty()) remapVertices(s.texcoords.data(), vertexCount, sizeof(float) * 2, remap);
+    if (!s.colors.empty()) remapVertices(s.colors.data(), vertexCount, 4, remap);
+    report.missesAfter += vertexCacheMissRatio(s.indices.data(), indexCount, vertexCount) * (indexCount / 3);
+    report.cachedTriangles += indexCount / 3;
+}
+
+static void quantize(MeshStreams &s, int vertexCount, BakedMesh &m) {
+    // Positions: 16-bit steps across the mesh's own bounding box
+    float lo[3] = {INFINITY, INFINITY, INFINITY}, hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (int v = 0; v < vertexCount; ++v) {
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::min(lo[k], s.positions[v * 3 + k]);
+            hi[k] = std::max(hi[k], s.positions[v * 3 + k]);
+        }
+    }
+    for (int k = 0; k < 3; ++k) {
+        m.positionOffset[k] = vertexCount > 0 ? lo[k] : 0.0f;
+        m.positionScale[k] = vertexCount > 0 && hi[k] > lo[k] ? (hi[k] - lo[k]) / 65535.0f : 1.0f;
+    }
+    s.quantizedPositions.assign((size_t)vertexCount * 4, 0);
+    for (int v = 0; v < vertexCount; ++v) {
+        for (int k = 0; k < 3; ++k) {
+            float q = (s.positions[v * 3 + k] - m.positionOffset[k]) / m.positionScale[k];
+            s.quantizedPositions[v * 4 + k] = (uint16_t)std::lrint(std::clamp(q, 0.0f, 65535.0f));
+        }
+    }
+    if (!s.normals.empty()) {
+        s.octNormals.resize((size_t)vertexCount * 2);
+        for (int v = 0; v < vertexCount; ++v) encodeOctahedral(&s.normals[v * 3], &s.octNormals[v * 2]);
+    }
+    if (!s.texcoords.empty()) {
+        s.halfTexcoords.resize((size_t)vertexCount * 2);
+        for (int v = 0; v < vertexCount * 2; ++v) s.halfTexcoords[v] = floatToHalf(s.texcoords[v]);
+    }
+    m.positions = s.quantizedPositions.data();
+    m.normals = s.octNormals.empty() ? nullptr : s.octNormals.data();
+    m.texcoords = s.halfTexcoords.empty() ? nullptr : s.halfTexcoords.data();
+    m.colors = s.colors.empty() ? nullptr : s.colors.data();
+}
+
+static void bakeMesh(const Mesh &mesh, MeshStreams &s, BakedMesh &m, BakeReport &report) {
+    const int n = mesh.vertexCount;
+    s.positions = copyStream(mesh.vertices, (size_t)n * 3);
+    s.normals = copyStream(mesh.normals, (size_t)n * 3);
+    s.texcoords = copyStream(mesh.texcoords, (size_t)n * 2);
+    s.colors = copyStream(mesh.colors, (size_t)n * 4);
+    s.indices = copyStream(mesh.indices, (size_t)mesh.triangleCount * 3);
+    if (!s.indices.empty()) {
+        buildLods(s, n);
+        optimizeOrder(s, n, report);
+    }
+    quantize(s, n, m);
+    m.indices = s.indices.empty() ? nullptr : s.indices.data();
+    m.lodCount = s.lodCount;
+    for (int l = 0; l < s.lodCount; ++l) {
+        m.lodIndices[l] = s.lods[l].data();
+        m.lodTriangleCount[l] = (int)s.lods[l].size() / 3;
+        report.lodIndexBytes += s.lods[l].size() * sizeof(unsigned short);
+    }
+
+    report.rawVertexBytes += (size_t)n * (12 + (mesh.normals ? 12 : 0) + (mesh.texcoords ? 8 : 0) + (mesh.colors ? 4 : 0));
+    report.vertexBytes += (size_t)n * (8 + (m.normals ? 4 : 0) + (m.texcoords ? 4 : 0) + (m.colors ? 4 : 0));
+    report.indexBytes += s.indices.size() * sizeof(unsigned short);
+    // Meshes with fewer levels draw their coarsest one at the remaining levels
+    for (int l = 0; l < kMaxModelLods; ++l) {
+        int level = std::min(l, m.lodCount);
+        report.lodTriangles[l] += level == 0 ? m.triangleCount : m.lodTriangleCount[level - 1];
+    }
+}
+
+static bool bakeOne(const std::string &gltfPath) {
+    Model model = LoadModel(gltfPath.c_str());
+    if (model.meshCount == 0) {
+        std::fprintf(stderr, "bake: failed to load %s\n", gltfPath.c_str());
+        return false;
+    }
+    BakedModel baked;
+    baked.sourceStamp = modelSourceStamp(gltfPath);
+    baked.materialCount = model.materialCount;
+    BoundingBox bounds = GetModelBoundingBox(model);
+    baked.boundsMin[0] = bounds.min.x; baked.boundsMin[1] = bounds.min.y; baked.boundsMin[2] = bounds.min.z;
+    baked.boundsMax[0] = bounds.max.x; baked.boundsMax[1] = bounds.max.y; baked.boundsMax[2] = bounds.max.z;
+    std::vector<MeshStreams> streams(model.meshCount);
+    BakeReport report;
+    for (int i = 0; i < model.meshCount; ++i) {
+        const Mesh &mesh = model.meshes[i];
+        BakedMesh m;
+        m.vertexCount = mesh.vertexCount;
+        m.triangleCount = mesh.triangleCount;
+        m.materialIndex = model.meshMaterial ? model.meshMaterial[i] : 0;
+        bakeMesh(mesh, streams[i], m, report);
+        baked.meshes.push_back(m);
+    }
+    std::string out = bakedModelPath(gltfPath);
+    bool ok = writeBakedModel(out, baked);
+    if (ok) {
+        const double triangles = report.cachedTriangles > 0 ? report.cachedTriangles : 1;
+        std::printf("bake: %s -> %s (%d meshes)\n", gltfPath.c_str(), out.c_str(), model.meshCount);
+        std::printf("  %-14s %.1f KB -> %.1f KB\n", "vertices", report.rawVertexBytes / 1024.0, report.vertexBytes / 1024.0);
+        std::printf("  %-14s %.1f KB, LODs %.1f KB\n", "indices", report.indexBytes / 1024.0, report.lodIndexBytes / 1024.0);
+        std::printf("  %-14s %.3f -> %.3f (FIFO 16)\n", "ACMR", report.missesBefore / triangles, report.missesAfter / triangles);
+        std::printf("  %-14s %d/%d/%d/%d\n", "LOD triangles", report.lodTriangles[0], report.lodTriangles[1],
+                    report.lodTriangles[2], report.lodTriangles[3]);
+    } else {
+        std::fprintf(stderr, "bake: could not write %s\n", out.c_str());
+    }
+    UnloadModel(model);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> sources;
+    for (int i = 1; i < argc; ++i) sources.push_back(argv[i]);
+    if (sources.empty()) {
+        for (const auto &def : kCharacters) sources.push_back(def.gltfPath);
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(64, 64, "epiCBattle_bake");
+    int failures = 0;
+    for (const auto &src : sources) {
+        if (!bakeOne(src)) failures++;
+    }
+    CloseWindow();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+// epiCBattle_texbake: converts character PNG textures into .ebtex caches.
+// Usage: epiCBattle_texbake [texture.png ...]   (no arguments bakes every PNG in each
+// kCharacters texture directory)
+//
+// Each texture is resized to power-of-two dimensions, given a box-filtered mip chain and
+// block compressed: BC1 for opaque images, BC3 when any pixel has alpha. Decoding uses
+// raylib's image loader, which is CPU-only, so no window is needed.
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "raylib.h"
+#include "assets/texture_cache.h"
+#include "assets/texture_compress.h"
+#include "game/characters.h"
+
+static int nearestPowerOfTwo(int v) {
+    int p = 4;
+    while (p * 2 <= v) p *= 2;
+    // Round up when v is closer to the next power
+    if (v - p > p * 2 - v) p *= 2;
+    return p;
+}
+
+static bool bakeOne(const std::string &pngPath) {
+    Image image = LoadImage(pngPath.c_str());
+    if (!image.data) {
+        std::fprintf(stderr, "texbake: failed to load %s\n", pngPath.c_str());
+        return false;
+    }
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    int w = nearestPowerOfTwo(image.width);
+    int h = nearestPowerOfTwo(image.height);
+    if (w != image.width || h != image.height) ImageResize(&image, w, h);
+
+    const unsigned char *rgba = (const unsigned char *)image.data;
+    bool alpha = imageHasAlpha(rgba, w, h);
+    std::vector<MipLevel> levels = buildMipChain(rgba, w, h);
+    UnloadImage(image);
+    compressMipChain(levels, alpha);
+
+    BakedTexture baked;
+    baked.sourceStamp = textureSourceStamp(pngPath);
+    baked.format = alpha ? TextureCacheFormat::BC3 : TextureCacheFormat::BC1;
+    size_t bytes = 0;
+    for (const auto &level : levels) {
+        baked.mips.push_back({level.width, level.height, level.pixels.data(), level.pixels.size()});
+        bytes += level.pixels.size();
+    }
+    std::string out = bakedTexturePath(pngPath);
+    bool ok = writeBakedTexture(out, baked);
+    if (ok) {
+        // What the GPU would hold for the same chain as uncompressed RGBA8
+        double rgbaBytes = (double)w * h * 4.0 * 4.0 / 3.0;
+        std::printf("texbake: %s -> %s (%dx%d %s, %d mips, %.1f KB vs %.1f KB RGBA8)\n", pngPath.c_str(), out.c_str(),
+                    w, h, alpha ? "BC3" : "BC1", (int)levels.size(), bytes / 1024.0, rgbaBytes / 1024.0);
+    } else {
+        std::fprintf(stderr, "texbake: could not write %s\n", out.c_str());
+    }
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> sources;
+    for (int i = 1; i < argc; ++i) sources.push_back(argv[i]);
+    if (sources.empty()) {
+        for (const auto &def : kCharacters) {
+            std::error_code ec;
+            for (const auto &entry : std::filesystem::directory_iterator(def.textureDir, ec)) {
+                if (entry.path().extension() == ".png") sources.push_back(entry.path().generic_string());
+            }
+        }
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    int failures = 0;
+    for (const auto &src : sources) {
+        if (!bakeOne(src)) failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+// TimerWheel checks: past deadlines set from inside fire() must fire on the next slot, not a
+// revolution later. Exits non-zero on the first failure.
+
+#include <cstdio>
+#include "core/timer_wheel.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (ok) return;
+    std::printf("FAIL: %s\n", what);
+    failures++;
+}
+
+// A timer rescheduled into the past from fire() waits for the next slot only
+static void pastDeadlineFiresNextSlot() {
+    TimerWheel wheel(0.001, 64);
+    int fired = 0;
+    wheel.schedule(0, 0.010);
+    wheel.advance(0.010, [&](int id) {
+        if (fired++ == 0) wheel.schedule(id, 0.005);
+    });
+    check(fired == 1, "the cursor's slot is scanned once per advance");
+    wheel.advance(0.011, [&](int) { fired++; });
+    check(fired == 2, "past deadline fires on the next slot");
+}
+
+// When now already covers the next slot, the rescheduled timer fires again in the same call
+static void pastDeadlineFiresInSamePass() {
+    TimerWheel wheel(0.001, 64);
+    int fired = 0;
+    wheel.schedule(0, 0.010);
+    wheel.advance(0.012, [&](int id) {
+        if (fired++ == 0) wheel.schedule(id, 0.005);
+    });
+    check(fired == 2, "past deadline fires again within the same advance");
+    check(!wheel.armed(0), "nothing left armed");
+}
+
+int main() {
+    pastDeadlineFiresNextSlot();
+    pastDeadlineFiresInSamePass();
+    if (failures == 0) std::printf("timer wheel: ok\n");
+    return failures == 0 ? 0 : 1;
+}